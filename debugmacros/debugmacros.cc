@@ -53,8 +53,9 @@ static map<string, int> mapFunctions;
 //! Map to store the name of the stream for each function to write to
 static map<string, string> mapFiles;
 
-static stack<string> stackFunctionCalls;
-static stack<string> stackActivationNames;
+//! Each thread has its own call stack
+static thread_local stack<string> stackFunctionCalls;
+static thread_local stack<string> stackActivationNames;
 
 
 // Flags for Command sets
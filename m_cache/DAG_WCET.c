@@ -25,7 +25,7 @@ int detectDirection( branch *bru, block *bv ) {
     return neg( bru->jump_cond );
 
   /*
-  char  *jumpdest;
+  int    jumpdest;
   instr *insn;
 
   // If bru's jump dest. == start address of bv, 
@@ -34,12 +34,12 @@ int detectDirection( branch *bru, block *bv ) {
   insn = bru->bb->instrlist[ bru->bb->num_instr - 1 ];
   jumpdest = getJumpDest( insn );
 
-  // printf( "dest: %s jumpdest: %s jumpdir: %d\n", bv->instrlist[0]->addr, jumpdest, jumpdir );
+  // printf( "dest: %x jumpdest: %x jumpdir: %d\n", bv->instrlist[0]->addr, jumpdest, jumpdir );
 
-  if( jumpdest == NULL )
+  if( jumpdest == -1 )
      return NA;
 
-  if( strcmp( bv->instrlist[0]->addr, jumpdest ) == 0 )
+  if( bv->instrlist[0]->addr == jumpdest )
     return bru->jump_cond;
   else
     return neg( bru->jump_cond );
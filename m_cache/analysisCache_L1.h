@@ -52,9 +52,6 @@ constructAll(task_t *task);
 void
 cacheAnalysis();
 
-void
-freeCacheSet(cache_line_way_t **cache_set);
-
 void
 freeAllCacheState();
 
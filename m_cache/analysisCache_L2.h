@@ -55,4 +55,9 @@ resetHitMiss_L2(MSC *msc);
 void
 cacheAnalysis_L2();
 
+/* Adds the L2 sets the analysed task 'task_main' uses to numConflictTask
+   and numConflictMSC. Call it once per task after cacheAnalysis_L2. */
+void
+countSetUsage_L2(const procedure *task_main);
+
 #endif
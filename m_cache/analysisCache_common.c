@@ -2,6 +2,12 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) && ( defined(__i386__) || defined(__x86_64__) )
+#define CACHE_SIMD_KERNELS
+#include <immintrin.h>
+#endif
 
 // Include local library headers
 #ifdef HAVE_CONFIG_H
@@ -42,3 +48,488 @@ isInWay(int entry, int *entries, int num_entry)
 
   return 0;
 }
+
+
+// #### Tag matching kernels ####
+
+/* The joins boil down to finding the tags of one set in the tag slots of
+   another one. matchSlots stores in 'slots[i]' the slot of
+   'keys[i]' in 'tags' or -1. It points to the fastest kernel the CPU
+   supports, which is selected once at program startup, before any thread
+   may run a join. */
+
+typedef void (*match_slots_fn)(const int *tags, int num_tags,
+    const int *keys, int num_keys, short *slots);
+
+static void
+matchSlotsScalar(const int *tags, int num_tags, const int *keys,
+    int num_keys, short *slots);
+
+static match_slots_fn matchSlots = matchSlotsScalar;
+
+
+static void
+matchSlotsScalar(const int *tags, int num_tags, const int *keys,
+    int num_keys, short *slots)
+{
+  int i, j;
+  for(i = 0; i < num_keys; i++)
+  {
+    slots[i] = -1;
+    for(j = 0; j < num_tags; j++)
+    {
+      if(tags[j] == keys[i])
+      {
+        slots[i] = j;
+        break;
+      }
+    }
+  }
+}
+
+
+#ifdef CACHE_SIMD_KERNELS
+
+/* Compares four tags per step. The tags of a set are distinct, so the
+   lowest bit of the comparison mask is the only match. */
+__attribute__((target("sse2")))
+static void
+matchSlotsSSE2(const int *tags, int num_tags, const int *keys,
+    int num_keys, short *slots)
+{
+  int i, j;
+  for(i = 0; i < num_keys; i++)
+  {
+    const __m128i key = _mm_set1_epi32(keys[i]);
+    slots[i] = -1;
+
+    for(j = 0; j + 4 <= num_tags; j += 4)
+    {
+      const __m128i t = _mm_loadu_si128((const __m128i*)(tags + j));
+      const int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(t, key)));
+      if(mask)
+      {
+        slots[i] = j + __builtin_ctz(mask);
+        break;
+      }
+    }
+    if(slots[i] != -1)
+      continue;
+
+    for(; j < num_tags; j++)
+    {
+      if(tags[j] == keys[i])
+      {
+        slots[i] = j;
+        break;
+      }
+    }
+  }
+}
+
+
+/* Compares eight tags per step */
+__attribute__((target("avx2")))
+static void
+matchSlotsAVX2(const int *tags, int num_tags, const int *keys,
+    int num_keys, short *slots)
+{
+  int i, j;
+  for(i = 0; i < num_keys; i++)
+  {
+    const __m256i key = _mm256_set1_epi32(keys[i]);
+    slots[i] = -1;
+
+    for(j = 0; j + 8 <= num_tags; j += 8)
+    {
+      const __m256i t = _mm256_loadu_si256((const __m256i*)(tags + j));
+      const int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(t, key)));
+      if(mask)
+      {
+        slots[i] = j + __builtin_ctz(mask);
+        break;
+      }
+    }
+    if(slots[i] != -1)
+      continue;
+
+    for(; j < num_tags; j++)
+    {
+      if(tags[j] == keys[i])
+      {
+        slots[i] = j;
+        break;
+      }
+    }
+  }
+}
+
+
+/* Selects the kernel for matchSlots. Runs as a constructor, so the
+   pointer is never written while the joins use it. */
+__attribute__((constructor))
+static void
+selectMatchSlotsKernel(void)
+{
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx2"))
+    matchSlots = matchSlotsAVX2;
+  else if(__builtin_cpu_supports("sse2"))
+    matchSlots = matchSlotsSSE2;
+}
+
+#endif
+
+
+/* Returns the slot of 'tag' in 'set' or -1. Single lookups are not worth
+   an indirect call, they only use the kernels through the joins. */
+static inline int
+findSlot(const cache_set_t *set, int tag)
+{
+  int i;
+  for(i = 0; i < set->num_entry; i++)
+    if(set->entry[i] == tag)
+      return i;
+  return -1;
+}
+
+
+// #### Abstract cache states ####
+
+/* Cache states are copy-on-write at two levels: copying a cache state only
+   copies its page pointers and increments the reference counts of the
+   pages. A page used by more than one state is copied by the first state
+   which modifies one of its sets, which again only increments the
+   reference counts of the sets in it, and a shared set is copied by the
+   first page which modifies it. Pages and sets are only ever shared
+   between states at the same set number. */
+
+
+static cache_set_t *
+allocCacheSet(int capacity)
+{
+  cache_set_t *set = NULL;
+  const size_t size = sizeof(cache_set_t)
+    + capacity * (sizeof(int) + sizeof(unsigned char));
+
+  CALLOC(set, cache_set_t*, 1, size, "cache_set_t");
+  set->refcount = 1;
+  set->capacity = capacity;
+  set->entry = (int*)(set + 1);
+  set->age = (unsigned char*)(set->entry + capacity);
+
+  return set;
+}
+
+
+static void
+releaseCachePage(cache_page_t *page)
+{
+  int i;
+  if(--page->refcount == 0)
+  {
+    for(i = 0; i < CACHE_PAGE_SIZE; i++)
+      if(page->set[i])
+        releaseCacheSet(page->set[i]);
+    free(page);
+  }
+}
+
+
+/* Returns set 'set_no' of 'pages' for modification: the set is used only
+   by the caller and has room for at least 'capacity' tags afterwards */
+static cache_set_t *
+ownCacheSet(cache_page_t **pages, int set_no, int capacity)
+{
+  int i;
+  cache_page_t **page = &pages[set_no >> CACHE_PAGE_BITS];
+
+  if((*page)->refcount > 1)
+  {
+    cache_page_t *copy = NULL;
+    MALLOC(copy, cache_page_t*, sizeof(cache_page_t), "cache_page_t");
+    copy->refcount = 1;
+    for(i = 0; i < CACHE_PAGE_SIZE; i++)
+    {
+      copy->set[i] = (*page)->set[i];
+      if(copy->set[i])
+        shareCacheSet(copy->set[i]);
+    }
+
+    releaseCachePage(*page);
+    *page = copy;
+  }
+
+  cache_set_t ** const set = &(*page)->set[set_no & (CACHE_PAGE_SIZE - 1)];
+  cache_set_t * const old = *set;
+  if(old->refcount == 1 && old->capacity >= capacity)
+    return old;
+
+  cache_set_t * const copy = allocCacheSet(MAX(capacity, old->capacity));
+  memcpy(copy->entry, old->entry, old->num_entry * sizeof(int));
+  memcpy(copy->age, old->age, old->num_entry * sizeof(unsigned char));
+  copy->num_entry = old->num_entry;
+
+  releaseCacheSet(old);
+  *set = copy;
+  return copy;
+}
+
+
+static cache_state *
+allocCacheStateBlock(int num_sets)
+{
+  cache_state *cs = NULL;
+
+  const int num_pages = (num_sets + CACHE_PAGE_SIZE - 1) / CACHE_PAGE_SIZE;
+  CALLOC(cs, cache_state*, 1,
+      sizeof(cache_state) + 3 * num_pages * sizeof(cache_page_t*), "cache_state");
+  cs->num_sets = num_sets;
+  cs->num_pages = num_pages;
+  cs->must = (cache_page_t**)(cs + 1);
+  cs->may = cs->must + num_pages;
+  cs->persist = cs->may + num_pages;
+
+  return cs;
+}
+
+
+cache_state *
+createCacheState(int num_sets, int capacity)
+{
+  int i, j;
+  cache_state * const cs = allocCacheStateBlock(num_sets);
+
+  cache_page_t ** const analyses[] = { cs->must, cs->may, cs->persist };
+  for(i = 0; i < 3; i++)
+  {
+    for(j = 0; j < num_sets; j++)
+    {
+      cache_page_t ** const page = &analyses[i][j >> CACHE_PAGE_BITS];
+      if(!*page)
+      {
+        CALLOC(*page, cache_page_t*, 1, sizeof(cache_page_t), "cache_page_t");
+        (*page)->refcount = 1;
+      }
+      (*page)->set[j & (CACHE_PAGE_SIZE - 1)] = allocCacheSet(capacity);
+    }
+  }
+
+  return cs;
+}
+
+
+cache_state *
+cloneCacheState(const cache_state *cs)
+{
+  int i;
+  cache_state * const copy = allocCacheStateBlock(cs->num_sets);
+
+  for(i = 0; i < 3 * cs->num_pages; i++)
+  {
+    copy->must[i] = cs->must[i];
+    copy->must[i]->refcount++;
+  }
+
+  return copy;
+}
+
+
+void
+destroyCacheState(cache_state *cs)
+{
+  int i;
+  for(i = 0; i < 3 * cs->num_pages; i++)
+    releaseCachePage(cs->must[i]);
+
+  FREE(cs);
+}
+
+
+cache_set_t *
+shareCacheSet(cache_set_t *set)
+{
+  set->refcount++;
+  return set;
+}
+
+
+void
+releaseCacheSet(cache_set_t *set)
+{
+  if(--set->refcount == 0)
+    free(set);
+}
+
+
+char
+findInCacheSet(const cache_set_t *set, int tag, int num_ways)
+{
+  const int slot = findSlot(set, tag);
+  if(slot != -1 && set->age[slot] < num_ways)
+    return set->age[slot];
+  return -1;
+}
+
+
+void
+accessCacheSet(cache_page_t **pages, int set_no, int tag, int num_ways,
+    int hit_ways)
+{
+  int i, n;
+
+  const cache_set_t * const set = getCacheSet(pages, set_no);
+  const int slot = findSlot(set, tag);
+  if(slot != -1 && set->age[slot] < hit_ways)
+  {
+    if(set->age[slot] != 0)
+      ownCacheSet(pages, set_no, 0)->age[slot] = 0;
+    return;
+  }
+
+  //miss: evict the oldest way and let the other tags grow older
+  n = 0;
+  for(i = 0; i < set->num_entry; i++)
+    if(set->age[i] + 1 < num_ways)
+      n++;
+
+  cache_set_t * const s = ownCacheSet(pages, set_no, n + 1);
+  n = 0;
+  for(i = 0; i < s->num_entry; i++)
+  {
+    if(s->age[i] + 1 < num_ways)
+    {
+      s->entry[n] = s->entry[i];
+      s->age[n] = s->age[i] + 1;
+      n++;
+    }
+  }
+
+  s->entry[n] = tag;
+  s->age[n] = 0;
+  s->num_entry = n + 1;
+}
+
+
+void
+intersectCacheSet(cache_page_t **pages, int set_no, const cache_set_t *src)
+{
+  int i, n;
+
+  const cache_set_t * const set = getCacheSet(pages, set_no);
+  if(set == src)
+    return;
+
+  //slot of each tag of the set in 'src'
+  short slots[set->num_entry + 1];
+  matchSlots(src->entry, src->num_entry, set->entry, set->num_entry, slots);
+
+  //leave the set alone if the join does not change it
+  for(i = 0; i < set->num_entry; i++)
+    if(slots[i] == -1 || src->age[slots[i]] > set->age[i])
+      break;
+  if(i == set->num_entry)
+    return;
+
+  cache_set_t * const d = ownCacheSet(pages, set_no, 0);
+  n = 0;
+  for(i = 0; i < d->num_entry; i++)
+  {
+    if(slots[i] == -1)
+      continue;
+
+    d->entry[n] = d->entry[i];
+    d->age[n] = MAX(d->age[i], src->age[slots[i]]);
+    n++;
+  }
+  d->num_entry = n;
+}
+
+
+/* Shared part of the may and persistence joins */
+static void
+joinCacheSet(cache_page_t **pages, int set_no, const cache_set_t *src,
+    _Bool keep_older)
+{
+  int i;
+
+  const cache_set_t * const set = getCacheSet(pages, set_no);
+  if(set == src)
+    return;
+
+  //slot of each tag of 'src' in the set
+  short slots[src->num_entry + 1];
+  matchSlots(set->entry, set->num_entry, src->entry, src->num_entry, slots);
+
+  //count the tags only present in 'src' and check whether any age changes
+  int num_new = 0;
+  _Bool changed = 0;
+  for(i = 0; i < src->num_entry; i++)
+  {
+    const int slot = slots[i];
+    if(slot == -1)
+      num_new++;
+    else if(keep_older ? src->age[i] > set->age[slot]
+                       : src->age[i] < set->age[slot])
+      changed = 1;
+  }
+  if(num_new == 0 && !changed)
+    return;
+
+  cache_set_t * const d = ownCacheSet(pages, set_no, set->num_entry + num_new);
+  for(i = 0; i < src->num_entry; i++)
+  {
+    const int slot = slots[i];
+
+    //tags only present in 'src' keep their age
+    if(slot == -1)
+    {
+      d->entry[d->num_entry] = src->entry[i];
+      d->age[d->num_entry] = src->age[i];
+      d->num_entry++;
+    }
+    else if(keep_older)
+      d->age[slot] = MAX(d->age[slot], src->age[i]);
+    else
+      d->age[slot] = MIN(d->age[slot], src->age[i]);
+  }
+}
+
+
+void
+unionCacheSet(cache_page_t **pages, int set_no, const cache_set_t *src)
+{
+  joinCacheSet(pages, set_no, src, 0);
+}
+
+
+void
+unionMaxCacheSet(cache_page_t **pages, int set_no, const cache_set_t *src)
+{
+  joinCacheSet(pages, set_no, src, 1);
+}
+
+
+void
+joinCacheState(cache_state *dst, const cache_state *src)
+{
+  int i, k;
+
+  for(i = 0; i < dst->num_pages; i++)
+  {
+    const int first = i << CACHE_PAGE_BITS;
+    const int last = MIN(first + CACHE_PAGE_SIZE, dst->num_sets);
+
+    if(dst->must[i] != src->must[i])
+      for(k = first; k < last; k++)
+        intersectCacheSet(dst->must, k, getCacheSet(src->must, k));
+
+    if(dst->may[i] != src->may[i])
+      for(k = first; k < last; k++)
+        unionCacheSet(dst->may, k, getCacheSet(src->may, k));
+
+    if(dst->persist[i] != src->persist[i])
+      for(k = first; k < last; k++)
+        unionMaxCacheSet(dst->persist, k, getCacheSet(src->persist, k));
+  }
+}
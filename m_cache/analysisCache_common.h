@@ -44,4 +44,69 @@ char
 isInWay(int entry, int *entries, int num_entry);
 
 
+/* Allocates an empty cache state with 'num_sets' sets per analysis and
+   'capacity' tag slots per set. */
+cache_state *
+createCacheState(int num_sets, int capacity);
+
+/* Returns a copy of 'cs' which shares all pages and sets with 'cs'. */
+cache_state *
+cloneCacheState(const cache_state *cs);
+
+void
+destroyCacheState(cache_state *cs);
+
+/* Returns set 'set_no' of one analysis ('cs->must', 'cs->may' or
+   'cs->persist') of a cache state for reading. */
+static inline cache_set_t *
+getCacheSet(cache_page_t * const *pages, int set_no)
+{
+  return pages[set_no >> CACHE_PAGE_BITS]->set[set_no & (CACHE_PAGE_SIZE - 1)];
+}
+
+/* Returns another reference to 'set', which must be given back with
+   releaseCacheSet. */
+cache_set_t *
+shareCacheSet(cache_set_t *set);
+
+void
+releaseCacheSet(cache_set_t *set);
+
+/* Returns the age of 'tag' in 'set' if it is younger than 'num_ways',
+   else -1. */
+char
+findInCacheSet(const cache_set_t *set, int tag, int num_ways);
+
+/* The following functions modify set 'set_no' of one analysis of a cache
+   state. Shared pages and sets are copied before they are modified. */
+
+/* LRU update of a set with 'num_ways' ways for an access to 'tag': a tag
+   found in one of the first 'hit_ways' ways becomes the youngest one,
+   otherwise all tags get older, the oldest way is evicted and 'tag' is
+   inserted as the youngest one. */
+void
+accessCacheSet(cache_page_t **pages, int set_no, int tag, int num_ways,
+    int hit_ways);
+
+/* Must join: keeps the tags of the set which are also in 'src', with the
+   older of both ages. */
+void
+intersectCacheSet(cache_page_t **pages, int set_no, const cache_set_t *src);
+
+/* May join: all tags of the set and 'src', with the younger of both ages. */
+void
+unionCacheSet(cache_page_t **pages, int set_no, const cache_set_t *src);
+
+/* Persistence join: all tags of the set and 'src', with the older of both
+   ages. */
+void
+unionMaxCacheSet(cache_page_t **pages, int set_no, const cache_set_t *src);
+
+/* Joins 'src' into 'dst' (must: intersection, may: union, persistence:
+   union with maximal ages). Pages and sets which both states share are
+   skipped. */
+void
+joinCacheState(cache_state *dst, const cache_state *src);
+
+
 #endif
@@ -0,0 +1,586 @@
+// Include standard library headers
+#include <stdlib.h>
+#include <stdio.h>
+#include <limits.h>
+
+// Include local library headers
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <debugmacros/debugmacros.h>
+
+// Include local headers
+#include "analysisCache_level.h"
+#include "analysisCache_common.h"
+#include "handler.h"
+
+
+// Forward declarations of static functions
+
+static void
+mapLevelLoop(const cache_level_driver_t *driver, procedure *proc, loop *lp);
+
+static void
+forEachLevelBlockInLoop(const cache_level_t *level, procedure *proc, loop *lp,
+    void (*visit)(const cache_level_t *level, block *bb));
+
+
+// #### Public variables ####
+
+const cache_level_t cache_level_L1 = { CACHE_LEVEL_L1, &cache, 0 };
+const cache_level_t cache_level_L2 = { CACHE_LEVEL_L2, &cache_L2, 1 };
+
+int level_first_set[MAX_CACHE_LEVELS] = { 0 };
+int level_end_set[MAX_CACHE_LEVELS] = { INT_MAX, INT_MAX, INT_MAX };
+
+
+// #### Cache configuration ####
+
+void
+readCacheConfig(cache_t *config, const char *configFile)
+{
+  FILE *fptr;
+  int ns, na, ls, hit_latency, miss_latency, i;
+
+  fptr = fopen(configFile, "r" );
+  if( !fptr )
+    prerr("Failed to open file: %s\n", configFile);
+
+  if( fscanf( fptr, "%d %d %d %d %d", &ns, &na, &ls, &hit_latency,
+              &miss_latency ) != 5 )
+    prerr("Error: %s does not hold the number of sets, associativity, "
+        "line size, hit and miss latency of the cache\n", configFile);
+  fclose( fptr );
+
+  if( ns <= 0 || na <= 0 || ls <= 0 )
+    prerr("Error: Invalid cache configuration in %s\n", configFile);
+
+  config->ns = ns;
+  config->na = na;
+  config->ls = ls;
+  config->hit_latency  = hit_latency;
+  config->miss_latency = miss_latency;
+
+  //set other configuration through the basic: ns, na, ls, cmp
+  config->nsb = logBase2(config->ns);
+  config->lsb = logBase2(config->ls);
+  // tag bits, #tags mapping to each set
+  config->ntb = MAX_TAG_BITS;
+  config->nt = 1 << config->ntb;
+  // tag + set bits, set + line bits, # of tag + set
+  config->t_sb = config->ntb + config->nsb;
+  config->s_lb = config->nsb + config->lsb;
+  config->nt_s = 1 << config->t_sb;
+  // cache line mask
+  config->l_msk =  (1 << config->lsb) - 1;
+  // set mask
+  config->s_msk = 0;
+  for (i = 1; i < config->ns; i <<= 1)
+    config->s_msk = config->s_msk  | i;
+  config->s_msk = config->s_msk << config->lsb;
+  // tag mask
+  config->t_msk = 0;
+  for (i = 1; i < config->nt; i <<= 1)
+    config->t_msk |= i;
+  config->t_msk = config->t_msk << (config->lsb + config->nsb);
+  // set+tag mask
+  config->t_s_msk = config->t_msk | config->s_msk;
+}
+
+
+void
+printCacheConfig(const cache_t *config)
+{
+  printf("Cache Configuration as follow:\n");
+  printf("nubmer of set:  %d\n", config->ns);
+  printf("nubmer of associativity:    %d\n", config->na);
+  printf("cache line size:    %d\n", config->ls);
+  printf("cache hit penalty: %d\n", config->hit_latency);
+  printf("cache miss penalty: %d\n", config->miss_latency);
+  printf("nubmer of set bit:  %d\n", config->nsb);
+  printf("nubmer of linesize bit: %d\n", config->lsb);
+  printf("set mask:   %u\n", config->s_msk);
+  printf("tag mask:   %u\n", config->t_msk);
+  printf("tag + set mask: %u\n", config->t_s_msk);
+}
+
+
+// #### Abstract cache states ####
+
+cache_state *
+allocLevelCacheState(const cache_level_t *level)
+{
+  return createCacheState(level->config->ns, level->config->na + 1);
+}
+
+
+void
+accessLevelCacheState(const cache_level_t *level, cache_state *cs, int addr)
+{
+  const int na = level->config->na;
+  const int set_no = cacheSetOf(level, addr);
+  const int tag = cacheTagSetOf(level, addr);
+
+  if(!ownsLevelCacheSet(level, addr))
+    return;
+
+  accessCacheSet(cs->must, set_no, tag, na, na);
+  accessCacheSet(cs->may, set_no, tag, na, na);
+  accessCacheSet(cs->persist, set_no, tag, na + 1,
+      level->victim_way_hits ? na + 1 : na);
+}
+
+
+void
+accessLevelCacheStateUnknown(const cache_level_t *level, cache_state *cs,
+    int addr, _Bool join_persist)
+{
+  const int set_no = cacheSetOf(level, addr);
+
+  if(!ownsLevelCacheSet(level, addr))
+    return;
+
+  //the sets before the access, shared with the state until it is modified
+  cache_set_t * const must = shareCacheSet(getCacheSet(cs->must, set_no));
+  cache_set_t * const may = shareCacheSet(getCacheSet(cs->may, set_no));
+  cache_set_t * const persist = shareCacheSet(getCacheSet(cs->persist, set_no));
+
+  accessLevelCacheState(level, cs, addr);
+
+  intersectCacheSet(cs->must, set_no, must);
+  unionCacheSet(cs->may, set_no, may);
+  if(join_persist)
+    unionMaxCacheSet(cs->persist, set_no, persist);
+
+  releaseCacheSet(must);
+  releaseCacheSet(may);
+  releaseCacheSet(persist);
+}
+
+
+char
+classifyLevelAccess(const cache_level_t *level, const cache_state *cs,
+    int addr, int *must_age)
+{
+  const int na = level->config->na;
+  const int set_no = cacheSetOf(level, addr);
+  const int tag = cacheTagSetOf(level, addr);
+
+  const int age = findInCacheSet(getCacheSet(cs->must, set_no), tag, na);
+  if(must_age)
+    *must_age = age;
+
+  if(age != -1)
+    return ALWAYS_HIT;
+  if(findInCacheSet(getCacheSet(cs->may, set_no), tag, na) == -1)
+    return ALWAYS_MISS;
+  if(findInCacheSet(getCacheSet(cs->persist, set_no), tag, na) != -1)
+    return FIRST_MISS;
+  return UNKNOW;
+}
+
+
+static void
+freeLevelCacheState(const cache_level_t *level, block *bb)
+{
+  bb->num_cache_state[level->index] = 0;
+  if(bb->bb_cache_state[level->index] != NULL)
+  {
+    destroyCacheState(bb->bb_cache_state[level->index]);
+    bb->bb_cache_state[level->index] = NULL;
+  }
+}
+
+
+static void
+freeLevelCHMCsOf(const cache_level_t *level, block *bb)
+{
+  int i, *num_chmc;
+  CHMC *** const chmc = levelCHMCs(level, bb, &num_chmc);
+
+  for(i = 0; i < *num_chmc; i++)
+  {
+    CHMC * const c = (*chmc)[i];
+    free(c->hitmiss_addr);
+    free(c->hit_addr);
+    free(c->age);
+    free(c->hit_change_miss);
+    free(c->miss_addr);
+    free(c->unknow_addr);
+    free(c);
+  }
+  FREE(*chmc);
+  *num_chmc = 0;
+}
+
+
+/* Calls 'visit' for each block reachable from 'proc' */
+static void
+forEachLevelBlock(const cache_level_t *level, procedure *proc,
+    void (*visit)(const cache_level_t *level, block *bb))
+{
+  procedure *p = proc;
+  block *bb;
+  int i;
+  int  num_blk = p->num_topo;
+
+  for(i = num_blk -1 ; i >= 0 ; i--)
+  {
+    bb = p ->topo[i];
+    bb = p->bblist[ bb->bbid ];
+
+    if(bb->is_loophead)
+      forEachLevelBlockInLoop(level, p, p->loops[bb->loopid], visit);
+    else
+    {
+      visit(level, bb);
+      if(bb->callpid != -1)
+        forEachLevelBlock(level, bb->proc_ptr, visit);
+    }
+  }
+}
+
+
+static void
+forEachLevelBlockInLoop(const cache_level_t *level, procedure *proc, loop *lp,
+    void (*visit)(const cache_level_t *level, block *bb))
+{
+  procedure *p = proc;
+  block *bb;
+  int i;
+  int  num_blk = lp->num_topo;
+
+  for(i = num_blk -1 ; i >= 0 ; i--)
+  {
+    bb = lp ->topo[i];
+    bb = p->bblist[ bb->bbid ];
+
+    if(bb->is_loophead && i!= num_blk -1)
+      forEachLevelBlockInLoop(level, p, p->loops[bb->loopid], visit);
+    else
+    {
+      visit(level, bb);
+      if(bb->callpid != -1)
+        forEachLevelBlock(level, bb->proc_ptr, visit);
+    }
+  }
+}
+
+
+void
+freeLevelCacheStates(const cache_level_t *level, procedure *proc)
+{
+  forEachLevelBlock(level, proc, freeLevelCacheState);
+}
+
+
+void
+freeLevelCHMCs(const cache_level_t *level, procedure *proc)
+{
+  forEachLevelBlock(level, proc, freeLevelCHMCsOf);
+}
+
+
+// #### Traversal ####
+
+/* Returns the CHMC index of the current loop context, see block::chmc. The
+   index is the reversed bit string of the iterations in 'loop_level_arr':
+   with loop 1 in its next and loop 0 in its first iteration it is 01. The
+   nesting level of the innermost loop is returned in 'lp_level', -1
+   outside of loops. */
+static int
+currentLoopContext(int *lp_level)
+{
+  int i, cnt = 0;
+
+  *lp_level = MAX_NEST_LOOP - 1;
+  for(i = 0; i < MAX_NEST_LOOP; i++)
+    if(loop_level_arr[i] == INVALID)
+    {
+      *lp_level = i - 1;
+      break;
+    }
+
+  for(i = 0; i <= *lp_level; i++)
+    if(loop_level_arr[i] == NEXT_ITERATION)
+      cnt += 1 << (*lp_level - i);
+  return cnt;
+}
+
+
+static void
+appendLevelAddress(int **list, int *num, int addr)
+{
+  (*num)++;
+  if(*num == 1)
+  {
+    CALLOC(*list, int*, 1, sizeof(int), "address list");
+  }
+  else
+  {
+    REALLOC(*list, int*, *num * sizeof(int), "address list");
+  }
+  (*list)[*num - 1] = addr;
+}
+
+
+static void
+addLevelHit(const cache_level_driver_t *driver, CHMC *chmc, int addr, int age)
+{
+  appendLevelAddress(&chmc->hit_addr, &chmc->hit, addr);
+  if(driver->recordHitAge)
+    driver->recordHitAge(chmc, age);
+}
+
+
+/* Classifies the accesses of 'bb' which reach the level into 'chmc'. The
+   first access to a line is classified in the state of the block, the
+   other accesses to the line always hit. */
+static void
+classifyLevelBlock(const cache_level_driver_t *driver, loop *lp, block *bb,
+    int cnt, CHMC *chmc)
+{
+  const cache_level_t * const level = driver->level;
+  char access_class;
+  int n, age, run_age, addr, addr_next;
+
+  addr = bb->startaddr;
+  for(n = 0; n < bb->num_instr; n++)
+  {
+    //classified by the worker owning the set
+    if(!ownsLevelCacheSet(level, addr))
+    {
+      addr = addr + INSN_SIZE;
+      continue;
+    }
+    if(driver->reachesLevel && !driver->reachesLevel(bb, cnt, addr))
+    {
+      chmc->hitmiss_addr[n] = HIT_UPPER;
+      addr = addr + INSN_SIZE;
+      continue;
+    }
+    if(driver->noteAccess)
+      driver->noteAccess(addr);
+
+    access_class = classifyLevelAccess(level, bb->bb_cache_state[level->index],
+        addr, &age);
+    chmc->hitmiss_addr[n] = access_class;
+
+    if(access_class == ALWAYS_HIT)
+      addLevelHit(driver, chmc, addr, age);
+    else if(access_class == FIRST_MISS)
+    {
+      if(lp)
+        (*levelFirstMisses(level, lp))++;
+      addLevelHit(driver, chmc, addr, age);
+    }
+    else if(access_class == ALWAYS_MISS)
+      appendLevelAddress(&chmc->miss_addr, &chmc->miss, addr);
+    else
+      appendLevelAddress(&chmc->unknow_addr, &chmc->unknow, addr);
+
+    //inside loops the rest of a line which is in the must state keeps its
+    //age, otherwise the rest is recorded as the oldest
+    if(lp && (access_class == ALWAYS_HIT || access_class == FIRST_MISS))
+      run_age = age;
+    else
+      run_age = level->config->na - 1;
+
+    addr_next = addr + INSN_SIZE;
+    while(cacheSetOf(level, addr_next) == cacheSetOf(level, addr) &&
+          n < bb->num_instr - 1)
+    {
+      n++;
+      chmc->hitmiss_addr[n] = ALWAYS_HIT;
+      if(!driver->reachesLevel || driver->reachesLevel(bb, cnt, addr_next))
+        addLevelHit(driver, chmc, addr_next, run_age);
+      addr_next = addr_next + INSN_SIZE;
+    }
+    addr = addr_next;
+  }
+}
+
+
+/* Analyses 'bb' with the input state 'cs', which the block takes over. 'lp'
+   is the loop the block is traversed as part of or NULL. */
+static void
+mapLevelBlock(const cache_level_driver_t *driver, loop *lp, block *bb,
+    cache_state *cs, int cnt, int lp_level)
+{
+  const int index = driver->level->index;
+  cache_state *cs_ptr;
+  CHMC *current_chmc;
+  int i, copies, *num_chmc;
+  CHMC *** const chmc = levelCHMCs(driver->level, bb, &num_chmc);
+
+  bb->num_cache_state[index] = 1;
+  if(*num_chmc == 0)
+  {
+    copies = lp_level == -1 ? 1 : 2 << lp_level;
+    *num_chmc = copies;
+
+    CALLOC(*chmc, CHMC**, copies, sizeof(CHMC*), "CHMC");
+    for(i = 0; i < copies; i++)
+      CALLOC((*chmc)[i], CHMC*, 1, sizeof(CHMC), "CHMC");
+  }
+
+  bb->bb_cache_state[index] = cs;
+
+  current_chmc = (*chmc)[cnt];
+  current_chmc->hit = 0;
+  current_chmc->miss = 0;
+  current_chmc->unknow = 0;
+  current_chmc->wcost = 0;
+  current_chmc->bcost = 0;
+
+  current_chmc->hitmiss = bb->num_instr;
+  CALLOC(current_chmc->hitmiss_addr, char*, current_chmc->hitmiss, sizeof(char),
+      "hitmiss_addr");
+
+  classifyLevelBlock(driver, lp, bb, cnt, current_chmc);
+
+  DOUT("bb %d of proc %d, cnt = %d: hit = %d, miss = %d, unknow = %d\n",
+      bb->bbid, bb->pid, cnt, current_chmc->hit, current_chmc->miss,
+      current_chmc->unknow);
+
+  if(driver->computeCost)
+    driver->computeCost(bb, cnt, current_chmc, lp_level);
+
+  driver->updateState(bb, cnt, current_chmc, lp != NULL);
+
+  if(bb->callpid != -1)
+  {
+    cs_ptr = bb->bb_cache_state[index];
+    bb->bb_cache_state[index] = cloneCacheState(
+        mapLevelFunctionCall(driver, bb->proc_ptr, cs_ptr));
+    destroyCacheState(cs_ptr);
+  }
+}
+
+
+/* Returns the join of the output states of the predecessors of 'bb', NULL
+   if the first one has not been analysed */
+static cache_state *
+joinIncomingStates(const cache_level_t *level, const procedure *p,
+    const block *bb)
+{
+  const cache_state *in = p->bblist[bb->incoming[0]]->bb_cache_state[level->index];
+  cache_state *cs;
+  int j;
+
+  if(in == NULL)
+    return NULL;
+
+  cs = cloneCacheState(in);
+  for(j = 1; j < bb->num_incoming; j++)
+  {
+    in = p->bblist[bb->incoming[j]]->bb_cache_state[level->index];
+    if(in != NULL)
+      joinCacheState(cs, in);
+  }
+  return cs;
+}
+
+
+/* Analyses the loop 'lp' nested at level 'lp_level' + 1 in its first and in
+   its next iterations */
+static void
+mapLevelNestedLoop(const cache_level_driver_t *driver, procedure *p, loop *lp,
+    int lp_level)
+{
+  *levelFirstMisses(driver->level, lp) = 0;
+
+  loop_level_arr[lp_level + 1] = FIRST_ITERATION;
+  mapLevelLoop(driver, p, lp);
+
+  //the state at the end of the first iteration enters the next ones
+  loop_level_arr[lp_level + 1] = NEXT_ITERATION;
+  mapLevelLoop(driver, p, lp);
+
+  loop_level_arr[lp_level + 1] = INVALID;
+}
+
+
+static void
+mapLevelLoop(const cache_level_driver_t *driver, procedure *proc, loop *lp)
+{
+  DSTART( "mapLevelLoop" );
+
+  const int index = driver->level->index;
+  const int num_blk = lp->num_topo;
+  const cache_state *in;
+  cache_state *cs;
+  block *bb;
+  int i, lp_level;
+  const int cnt = currentLoopContext(&lp_level);
+
+  DOUT("\nIn mapLevelLoop loopid[%d], level %d\n", lp->lpid, index);
+
+  for(i = num_blk - 1; i >= 0; i--)
+  {
+    bb = proc->bblist[lp->topo[i]->bbid];
+    bb->num_instr = bb->size / INSN_SIZE;
+
+    if(bb->is_loophead && i != num_blk - 1)
+    {
+      mapLevelNestedLoop(driver, proc, proc->loops[bb->loopid], lp_level);
+      continue;
+    }
+
+    if(!bb->is_loophead || loop_level_arr[lp_level] == FIRST_ITERATION)
+      cs = joinIncomingStates(driver->level, proc, bb);
+    else
+    {
+      in = proc->bblist[lp->topo[0]->bbid]->bb_cache_state[index];
+      cs = in ? cloneCacheState(in) : NULL;
+    }
+    if(cs == NULL)
+      continue;
+
+    mapLevelBlock(driver, lp, bb, cs, cnt, lp_level);
+  }
+
+  DEND();
+}
+
+
+cache_state *
+mapLevelFunctionCall(const cache_level_driver_t *driver, procedure *proc,
+    const cache_state *cs)
+{
+  DSTART( "mapLevelFunctionCall" );
+
+  const int index = driver->level->index;
+  const int num_blk = proc->num_topo;
+  cache_state *cs_ptr = cloneCacheState(cs);
+  cache_state *joined;
+  block *bb;
+  int i, lp_level;
+  const int cnt = currentLoopContext(&lp_level);
+
+  DOUT("\nIn mapLevelFunctionCall, p[%d], level %d\n", proc->pid, index);
+
+  for(i = num_blk - 1; i >= 0; i--)
+  {
+    bb = proc->bblist[proc->topo[i]->bbid];
+    bb->num_instr = bb->size / INSN_SIZE;
+
+    if(bb->is_loophead)
+    {
+      mapLevelNestedLoop(driver, proc, proc->loops[bb->loopid], lp_level);
+      continue;
+    }
+
+    if(bb->num_incoming > 0)
+    {
+      joined = joinIncomingStates(driver->level, proc, bb);
+      if(joined == NULL)
+        continue;
+      cs_ptr = joined;
+    }
+
+    mapLevelBlock(driver, NULL, bb, cs_ptr, cnt, lp_level);
+  }
+
+  DRETURN( proc->bblist[proc->topo[0]->bbid]->bb_cache_state[index] );
+}
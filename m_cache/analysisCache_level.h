@@ -0,0 +1,164 @@
+/*! This is a header file of the Chronos timing analyzer. */
+
+/*!
+  Cache level independent part of the abstract interpretation based cache
+  analysis
+*/
+
+#ifndef __CHRONOS_ANALYSIS_CACHE_LEVEL_H
+#define __CHRONOS_ANALYSIS_CACHE_LEVEL_H
+
+#include "header.h"
+
+// ######### Datatype declarations  ###########
+
+
+/* One level of the cache hierarchy as seen by the abstract cache analysis.
+   The level drivers (analysisCache_L1.c, analysisCache_L2.c) decide which
+   accesses reach the level and what the classifications cost, everything
+   else is done by the functions below for any level. */
+typedef struct
+{
+  // index of the level's cache state in 'block::bb_cache_state'
+  int index;
+  const cache_t *config;
+  /* The persistence state has one more way than the cache which collects
+     the victims of the other ways. Whether an access to that way updates
+     the state like a hit differs between the levels. */
+  _Bool victim_way_hits;
+} cache_level_t;
+
+/* What the traversal of 'mapLevelFunctionCall' does differently per level.
+   The hooks which may be NULL are marked as such. */
+typedef struct
+{
+  const cache_level_t *level;
+  /* Whether the access to 'addr' in block 'bb' reaches the level in the loop
+     context 'cnt', the others are classified HIT_UPPER (NULL: all do) */
+  _Bool (*reachesLevel)(const block *bb, int cnt, int addr);
+  /* Called for the first access to each line which reaches the level (may
+     be NULL) */
+  void (*noteAccess)(int addr);
+  /* Called after the 'chmc->hit'th hit was added with the must 'age' of the
+     access (may be NULL) */
+  void (*recordHitAge)(CHMC *chmc, int age);
+  /* Computes the costs of the classifications 'chmc' of 'bb' at the loop
+     nesting level 'lp_level' (may be NULL) */
+  void (*computeCost)(const block *bb, int cnt, CHMC *chmc, int lp_level);
+  /* Updates the state of 'bb' for its accesses before a call is entered.
+     'in_loop' is set if the block is traversed as part of a loop. */
+  void (*updateState)(block *bb, int cnt, const CHMC *chmc, _Bool in_loop);
+} cache_level_driver_t;
+
+
+// ######### Global variables  ###########
+
+extern const cache_level_t cache_level_L1;
+extern const cache_level_t cache_level_L2;
+
+/* The sets [first, end) of each level which this process analyses, all of
+   them unless the analysis is split over worker processes (see
+   analysisCache_parallel.c). Accesses to other sets leave the states
+   unchanged. */
+extern int level_first_set[MAX_CACHE_LEVELS];
+extern int level_end_set[MAX_CACHE_LEVELS];
+
+
+// ######### Function declarations  ###########
+
+
+/* Reads the basic configuration of 'config' from 'configFile' and derives
+   the other parameters from it */
+void
+readCacheConfig(cache_t *config, const char *configFile);
+
+void
+printCacheConfig(const cache_t *config);
+
+static inline int
+cacheSetOf(const cache_level_t *level, int addr)
+{
+  return (addr & level->config->s_msk) >> level->config->lsb;
+}
+
+static inline int
+cacheTagSetOf(const cache_level_t *level, int addr)
+{
+  return (addr & level->config->t_s_msk) >> level->config->lsb;
+}
+
+static inline _Bool
+ownsLevelCacheSet(const cache_level_t *level, int addr)
+{
+  const int set = cacheSetOf(level, addr);
+  return set >= level_first_set[level->index] &&
+    set < level_end_set[level->index];
+}
+
+static inline _Bool
+ownsAllLevelCacheSets(const cache_level_t *level)
+{
+  return level_first_set[level->index] == 0 &&
+    level_end_set[level->index] >= level->config->ns;
+}
+
+/* Returns the CHMC array of 'bb' for 'level' and its length in 'num' */
+static inline CHMC ***
+levelCHMCs(const cache_level_t *level, block *bb, int **num)
+{
+  if(level->index == CACHE_LEVEL_L1)
+  {
+    *num = &bb->num_chmc;
+    return &bb->chmc;
+  }
+  *num = &bb->num_chmc_L2;
+  return &bb->chmc_L2;
+}
+
+/* Returns the number of first misses in 'lp' at 'level' */
+static inline char *
+levelFirstMisses(const cache_level_t *level, loop *lp)
+{
+  return level->index == CACHE_LEVEL_L1 ? &lp->num_fm : &lp->num_fm_L2;
+}
+
+/* Allocates an empty cache state for 'level' */
+cache_state *
+allocLevelCacheState(const cache_level_t *level);
+
+/* Updates the must, may and persistence state for an access to 'addr' */
+void
+accessLevelCacheState(const cache_level_t *level, cache_state *cs, int addr);
+
+/* Updates the state for an access to 'addr' which may or may not reach the
+   level: the new state is the join of the states with and without the
+   access. The persistence state is only joined if 'join_persist' is set. */
+void
+accessLevelCacheStateUnknown(const cache_level_t *level, cache_state *cs,
+    int addr, _Bool join_persist);
+
+/* Classifies an access to 'addr' in 'cs' as ALWAYS_HIT, ALWAYS_MISS,
+   FIRST_MISS or UNKNOW. If 'must_age' is given, it receives the age of
+   'addr' in the must state or -1. */
+char
+classifyLevelAccess(const cache_level_t *level, const cache_state *cs,
+    int addr, int *must_age);
+
+/* Traverses 'proc' and the functions it calls with the entry state 'cs',
+   classifies the accesses of each block in the current loop context and
+   stores the output states in the blocks. Returns the output state of the
+   last block of 'proc'. */
+cache_state *
+mapLevelFunctionCall(const cache_level_driver_t *driver, procedure *proc,
+    const cache_state *cs);
+
+/* Frees the cache states of 'level' of all blocks reachable from 'proc' */
+void
+freeLevelCacheStates(const cache_level_t *level, procedure *proc);
+
+/* Frees the CHMCs of 'level' of all blocks reachable from 'proc' */
+void
+freeLevelCHMCs(const cache_level_t *level, procedure *proc);
+
+
+#endif
@@ -0,0 +1,746 @@
+// MAP_ANONYMOUS, kill and nanosleep are not part of C99
+#define _DEFAULT_SOURCE
+
+// Include standard library headers
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <signal.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+// Include local library headers
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <debugmacros/debugmacros.h>
+
+// Include local headers
+#include "analysisCache_parallel.h"
+#include "analysisCache_L2.h"
+#include "analysisCache_store.h"
+#include "handler.h"
+
+
+/* The must/may/persistence update of an access only touches the set of the
+   accessed address, so the cache sets can be analysed independently. A
+   worker is a forked process which runs the normal traversal of the level
+   driver, but ignores all accesses to sets outside of its range (see
+   ownsLevelCacheSet), so it only classifies the instructions of its sets.
+   The states of the other sets stay the initial ones and are shared by all
+   states, which makes the joins skip them.
+
+   Forking gives every worker a private copy of the CFG, whose blocks hold
+   the intermediate cache states and traversal bookkeeping of the drivers.
+   After the traversal each worker writes the CHMCs of the level for all
+   blocks of the task to a temporary file. Every instruction is classified by
+   exactly one worker, so the main process gets the CHMCs of a single
+   process run by summing up the classifications, counts and costs, and by
+   merging the address lists (which are in instruction order) of all
+   workers. */
+
+
+// ######### Macros #########
+
+
+#define MAX_CACHE_WORKERS 256
+
+/* The size of a CHMC written by writeCHMC with empty lists */
+#define MIN_CHMC_SIZE (12 * sizeof(int))
+
+
+// ######### Datatype declarations  ###########
+
+
+/* Shared memory of the workers of one analysis: the cuts they passed to
+   agreeOnCacheCut, in two alternating rounds, and the barrier state. */
+typedef struct
+{
+  unsigned int arrived;
+  unsigned int generation;
+  int cut[2][MAX_CACHE_WORKERS];
+} worker_sync_t;
+
+/* Where the results of the workers go to or come from */
+typedef struct
+{
+  const cache_level_t *level;
+  FILE **files;
+  int num_files;
+  _Bool writing;
+  _Bool failed; // set if writing or reading failed
+} result_io_t;
+
+
+// ######### Static variables  ###########
+
+
+/* Set in the worker processes only */
+static worker_sync_t *worker_sync = NULL;
+static int num_workers = 1;
+static int worker_id = 0;
+static int sync_round = 0;
+
+
+// Forward declarations of static functions
+
+static void
+transferProcResults(result_io_t *io, procedure *proc);
+
+
+// #### Synchronisation of the workers ####
+
+
+static void
+waitForWorkers(void)
+{
+  const unsigned int generation =
+    __atomic_load_n(&worker_sync->generation, __ATOMIC_ACQUIRE);
+
+  if(__atomic_add_fetch(&worker_sync->arrived, 1, __ATOMIC_ACQ_REL) ==
+      (unsigned int)num_workers)
+  {
+    __atomic_store_n(&worker_sync->arrived, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&worker_sync->generation, generation + 1,
+        __ATOMIC_RELEASE);
+    return;
+  }
+
+  int spins = 0;
+  while(__atomic_load_n(&worker_sync->generation, __ATOMIC_ACQUIRE) ==
+      generation)
+  {
+    if(++spins > 1000)
+      sched_yield();
+  }
+}
+
+
+int
+agreeOnCacheCut(int cut)
+{
+  if(!worker_sync)
+    return cut;
+
+  /* A worker may only write a round again after all workers passed the
+     barrier of the round in between, by then all of them read this one. */
+  int * const cuts = worker_sync->cut[sync_round];
+  sync_round ^= 1;
+
+  cuts[worker_id] = cut;
+  waitForWorkers();
+
+  int i;
+  for(i = 0; i < num_workers; i++)
+    if(cuts[i] < cut)
+      cut = cuts[i];
+
+  return cut;
+}
+
+
+// #### Transfer of the results ####
+
+
+static void
+writeInts(result_io_t *io, const int *values, int n)
+{
+  if(n > 0 && fwrite(values, sizeof(int), n, io->files[0]) != (size_t)n)
+    io->failed = 1;
+}
+
+
+static void
+writeInt(result_io_t *io, int value)
+{
+  writeInts(io, &value, 1);
+}
+
+
+static void
+writeChars(result_io_t *io, const char *values, int n)
+{
+  if(n > 0 && fwrite(values, 1, n, io->files[0]) != (size_t)n)
+    io->failed = 1;
+}
+
+
+/* Reads 'n' values into 'values', or zeros once anything was missing */
+static void
+readValues(result_io_t *io, FILE *f, void *values, size_t size, int n)
+{
+  if(n <= 0)
+    return;
+  if(io->failed || fread(values, size, n, f) != (size_t)n)
+  {
+    io->failed = 1;
+    memset(values, 0, size * n);
+  }
+}
+
+
+static int
+readInt(result_io_t *io, FILE *f)
+{
+  int value;
+  readValues(io, f, &value, sizeof(int), 1);
+  return value;
+}
+
+
+/* Reads an int which must be in [0, max] */
+static int
+readCount(result_io_t *io, FILE *f, int max)
+{
+  const int value = readInt(io, f);
+  if(value >= 0 && value <= max)
+    return value;
+  io->failed = 1;
+  return 0;
+}
+
+
+long
+remainingResultBytes(FILE *f)
+{
+  struct stat st;
+  const long pos = ftell(f);
+  if(pos < 0 || fstat(fileno(f), &st) != 0 || st.st_size < pos)
+    return 0;
+  return st.st_size - pos;
+}
+
+
+static int *
+readIntList(result_io_t *io, FILE *f, int n)
+{
+  int *values = NULL;
+  if(n > 0)
+  {
+    MALLOC(values, int*, n * sizeof(int), "worker results");
+    readValues(io, f, values, sizeof(int), n);
+  }
+  return values;
+}
+
+
+static char *
+readCharList(result_io_t *io, FILE *f, int n)
+{
+  char *values = NULL;
+  if(n > 0)
+  {
+    MALLOC(values, char*, n * sizeof(char), "worker results");
+    readValues(io, f, values, sizeof(char), n);
+  }
+  return values;
+}
+
+
+static void
+writeCHMC(result_io_t *io, const CHMC *chmc)
+{
+  const _Bool hit_info = chmc->hit > 0 && chmc->age != NULL;
+
+  writeInt(io, chmc->hitmiss);
+  writeInt(io, chmc->hitmiss_addr != NULL);
+  if(chmc->hitmiss_addr)
+    writeChars(io, chmc->hitmiss_addr, chmc->hitmiss);
+
+  writeInt(io, chmc->hit);
+  writeInts(io, chmc->hit_addr, chmc->hit);
+  writeInt(io, hit_info);
+  if(hit_info)
+  {
+    writeChars(io, chmc->age, chmc->hit);
+    writeChars(io, chmc->hit_change_miss, chmc->hit);
+  }
+  writeInt(io, chmc->miss);
+  writeInts(io, chmc->miss_addr, chmc->miss);
+  writeInt(io, chmc->unknow);
+  writeInts(io, chmc->unknow_addr, chmc->unknow);
+
+  writeInt(io, chmc->hit_copy);
+  writeInt(io, chmc->unknow_copy);
+  writeInt(io, chmc->bcost);
+  writeInt(io, chmc->bcost_copy);
+  writeInt(io, chmc->wcost);
+  writeInt(io, chmc->wcost_copy);
+}
+
+
+/* Reads a CHMC of a block of 'num_instr' instructions as written by
+   writeCHMC into 'chmc'. The lists are freshly allocated, the age and
+   hit_change_miss lists only if the worker had them. */
+static void
+readCHMC(result_io_t *io, FILE *f, CHMC *chmc, int num_instr)
+{
+  memset(chmc, 0, sizeof(CHMC));
+
+  chmc->hitmiss = readCount(io, f, num_instr);
+  if(readInt(io, f))
+  {
+    CALLOC(chmc->hitmiss_addr, char*, chmc->hitmiss + 1, sizeof(char),
+        "worker results");
+    readValues(io, f, chmc->hitmiss_addr, sizeof(char), chmc->hitmiss);
+  }
+
+  chmc->hit = readCount(io, f, chmc->hitmiss);
+  chmc->hit_addr = readIntList(io, f, chmc->hit);
+  if(readInt(io, f))
+  {
+    chmc->age = readCharList(io, f, chmc->hit);
+    chmc->hit_change_miss = readCharList(io, f, chmc->hit);
+  }
+  chmc->miss = readCount(io, f, chmc->hitmiss);
+  chmc->miss_addr = readIntList(io, f, chmc->miss);
+  chmc->unknow = readCount(io, f, chmc->hitmiss);
+  chmc->unknow_addr = readIntList(io, f, chmc->unknow);
+
+  chmc->hit_copy = readInt(io, f);
+  chmc->unknow_copy = readInt(io, f);
+  chmc->bcost = readInt(io, f);
+  chmc->bcost_copy = readInt(io, f);
+  chmc->wcost = readInt(io, f);
+  chmc->wcost_copy = readInt(io, f);
+}
+
+
+static void
+freeCHMCLists(CHMC *chmc)
+{
+  free(chmc->hitmiss_addr);
+  free(chmc->hit_addr);
+  free(chmc->age);
+  free(chmc->hit_change_miss);
+  free(chmc->miss_addr);
+  free(chmc->unknow_addr);
+}
+
+
+/* Merges the address lists 'lists[i]' of 'counts[i]' ascending entries each
+   into one list of 'total' entries. If 'ages' and 'changes' are given, their
+   entries are moved along with the addresses. */
+static int *
+mergeAddressLists(int total, int * const *lists, const int *counts,
+    char * const *ages, char * const *changes, int n,
+    char **merged_ages, char **merged_changes)
+{
+  int *result = NULL, *pos = NULL;
+  int i, w;
+
+  if(total == 0)
+    return NULL;
+
+  MALLOC(result, int*, total * sizeof(int), "merged addresses");
+  CALLOC(pos, int*, n, sizeof(int), "merge positions");
+  if(ages)
+  {
+    MALLOC(*merged_ages, char*, total * sizeof(char), "merged ages");
+    MALLOC(*merged_changes, char*, total * sizeof(char), "merged changes");
+  }
+
+  for(i = 0; i < total; i++)
+  {
+    int best = -1;
+    for(w = 0; w < n; w++)
+      if(pos[w] < counts[w] &&
+          (best == -1 || lists[w][pos[w]] < lists[best][pos[best]]))
+        best = w;
+
+    result[i] = lists[best][pos[best]];
+    if(ages)
+    {
+      //hits of a worker without ages may have been evicted by anything
+      (*merged_ages)[i] = ages[best] ? ages[best][pos[best]] : CHAR_MAX;
+      (*merged_changes)[i] = changes[best] ? changes[best][pos[best]] : HIT;
+    }
+    pos[best]++;
+  }
+
+  free(pos);
+  return result;
+}
+
+
+/* Combines the CHMCs 'parts' of the same block and context which the workers
+   computed for their sets into 'chmc' */
+static void
+mergeCHMC(CHMC *chmc, CHMC *parts, int n)
+{
+  int *lists[MAX_CACHE_WORKERS], counts[MAX_CACHE_WORKERS];
+  char *ages[MAX_CACHE_WORKERS], *changes[MAX_CACHE_WORKERS];
+  _Bool hit_info = 0;
+  int i, w;
+
+  chmc->hitmiss = parts[0].hitmiss;
+  for(w = 0; w < n; w++)
+  {
+    if(!parts[w].hitmiss_addr)
+      continue;
+    if(!chmc->hitmiss_addr)
+      CALLOC(chmc->hitmiss_addr, char*, chmc->hitmiss, sizeof(char),
+          "hitmiss_addr");
+    for(i = 0; i < chmc->hitmiss; i++)
+      chmc->hitmiss_addr[i] += parts[w].hitmiss_addr[i];
+  }
+
+  chmc->hit = 0;
+  for(w = 0; w < n; w++)
+  {
+    lists[w] = parts[w].hit_addr;
+    counts[w] = parts[w].hit;
+    ages[w] = parts[w].age;
+    changes[w] = parts[w].hit_change_miss;
+    chmc->hit += parts[w].hit;
+    hit_info = hit_info || parts[w].age;
+  }
+  if(chmc->hit > 0)
+    chmc->hit_addr = mergeAddressLists(chmc->hit, lists, counts,
+        hit_info ? ages : NULL, changes, n, &chmc->age,
+        &chmc->hit_change_miss);
+
+  chmc->miss = 0;
+  for(w = 0; w < n; w++)
+  {
+    lists[w] = parts[w].miss_addr;
+    counts[w] = parts[w].miss;
+    chmc->miss += parts[w].miss;
+  }
+  if(chmc->miss > 0)
+    chmc->miss_addr = mergeAddressLists(chmc->miss, lists, counts,
+        NULL, NULL, n, NULL, NULL);
+
+  chmc->unknow = 0;
+  for(w = 0; w < n; w++)
+  {
+    lists[w] = parts[w].unknow_addr;
+    counts[w] = parts[w].unknow;
+    chmc->unknow += parts[w].unknow;
+  }
+  if(chmc->unknow > 0)
+    chmc->unknow_addr = mergeAddressLists(chmc->unknow, lists, counts,
+        NULL, NULL, n, NULL, NULL);
+
+  chmc->hit_copy = chmc->unknow_copy = 0;
+  chmc->bcost = chmc->bcost_copy = chmc->wcost = chmc->wcost_copy = 0;
+  for(w = 0; w < n; w++)
+  {
+    chmc->hit_copy += parts[w].hit_copy;
+    chmc->unknow_copy += parts[w].unknow_copy;
+    chmc->bcost += parts[w].bcost;
+    chmc->bcost_copy += parts[w].bcost_copy;
+    chmc->wcost += parts[w].wcost;
+    chmc->wcost_copy += parts[w].wcost_copy;
+  }
+}
+
+
+static void
+transferBlockResults(result_io_t *io, block *bb)
+{
+  int *num_chmc;
+  CHMC *** const chmc = levelCHMCs(io->level, bb, &num_chmc);
+  int i, w;
+
+  if(io->writing)
+  {
+    writeInt(io, bb->num_instr);
+    writeInt(io, *num_chmc);
+    for(i = 0; i < *num_chmc; i++)
+      writeCHMC(io, (*chmc)[i]);
+    return;
+  }
+
+  const int num_instr = bb->size / INSN_SIZE;
+  int num = 0;
+  for(w = 0; w < io->num_files; w++)
+  {
+    bb->num_instr = readCount(io, io->files[w], num_instr);
+    num = readCount(io, io->files[w],
+        remainingResultBytes(io->files[w]) / MIN_CHMC_SIZE);
+  }
+  if(*num_chmc != 0 && num != *num_chmc)
+    io->failed = 1;
+  if(io->failed)
+    return;
+
+  if(*num_chmc == 0 && num > 0)
+  {
+    *num_chmc = num;
+    CALLOC(*chmc, CHMC**, num, sizeof(CHMC*), "CHMC");
+    for(i = 0; i < num; i++)
+      CALLOC((*chmc)[i], CHMC*, 1, sizeof(CHMC), "CHMC");
+  }
+
+  CHMC parts[MAX_CACHE_WORKERS];
+  for(i = 0; i < num; i++)
+  {
+    for(w = 0; w < io->num_files; w++)
+      readCHMC(io, io->files[w], &parts[w], num_instr);
+
+    mergeCHMC((*chmc)[i], parts, io->num_files);
+
+    for(w = 0; w < io->num_files; w++)
+      freeCHMCLists(&parts[w]);
+  }
+}
+
+
+static void
+transferLoopCounters(result_io_t *io, loop *lp)
+{
+  char * const num_fm = levelFirstMisses(io->level, lp);
+  int w;
+
+  if(io->writing)
+  {
+    writeInt(io, *num_fm);
+    return;
+  }
+
+  int sum = 0;
+  for(w = 0; w < io->num_files; w++)
+    sum += readInt(io, io->files[w]);
+  *num_fm = sum;
+}
+
+
+static void
+transferLoopResults(result_io_t *io, procedure *proc, loop *lp)
+{
+  procedure *p = proc;
+  block *bb;
+  int i;
+  int  num_blk = lp->num_topo;
+
+  transferLoopCounters(io, lp);
+
+  for(i = num_blk -1 ; i >= 0 ; i--)
+  {
+    bb = lp ->topo[i];
+    bb = p->bblist[ bb->bbid ];
+
+    if(bb->is_loophead && i!= num_blk -1)
+      transferLoopResults(io, p, p->loops[bb->loopid]);
+    else
+    {
+      transferBlockResults(io, bb);
+      if(bb->callpid != -1)
+        transferProcResults(io, bb->proc_ptr);
+    }
+  }
+}
+
+
+/* Writes or reads the results of the blocks reachable from 'proc' in the
+   order in which freeLevelCacheStates visits them */
+static void
+transferProcResults(result_io_t *io, procedure *proc)
+{
+  procedure *p = proc;
+  block *bb;
+  int i;
+  int  num_blk = p->num_topo;
+
+  for(i = num_blk -1 ; i >= 0 ; i--)
+  {
+    bb = p ->topo[i];
+    bb = p->bblist[ bb->bbid ];
+
+    if(bb->is_loophead)
+      transferLoopResults(io, p, p->loops[bb->loopid]);
+    else
+    {
+      transferBlockResults(io, bb);
+      if(bb->callpid != -1)
+        transferProcResults(io, bb->proc_ptr);
+    }
+  }
+}
+
+
+_Bool
+writeLevelCacheResults(const cache_level_t *level,
+    const cache_set_results_t *set_results, FILE *f)
+{
+  FILE *files[] = { f };
+  result_io_t io = { level, files, 1, 1, 0 };
+  transferProcResults(&io, main_copy);
+  if(set_results)
+    set_results->write(f, 0, level->config->ns);
+
+  return !io.failed && !ferror(f);
+}
+
+
+_Bool
+readLevelCacheResults(const cache_level_t *level,
+    const cache_set_results_t *set_results, FILE *f)
+{
+  FILE *files[] = { f };
+  result_io_t io = { level, files, 1, 0, 0 };
+  transferProcResults(&io, main_copy);
+  if(io.failed)
+    return 0;
+
+  return !set_results || set_results->read(f, 0, level->config->ns);
+}
+
+
+// #### Worker processes ####
+
+
+static void
+runWorker(const cache_level_t *level, void (*analysis)(void),
+    const cache_set_results_t *set_results, FILE *f, int first, int end)
+{
+  level_first_set[level->index] = first;
+  level_end_set[level->index] = end;
+
+  analysis();
+
+  FILE *files[] = { f };
+  result_io_t io = { level, files, 1, 1, 0 };
+  transferProcResults(&io, main_copy);
+  if(set_results)
+    set_results->write(f, first, end);
+
+  _exit(!io.failed && fflush(f) == 0 && !ferror(f) ? 0 : 1);
+}
+
+
+static void
+waitForWorkerProcesses(pid_t *pids, int n)
+{
+  /* A failed worker must not leave the others waiting for it at a cut */
+  const struct timespec pause = { 0, 1000000 };
+  int i, k, remaining = n;
+  while(remaining > 0)
+  {
+    int reaped = 0;
+    for(i = 0; i < n; i++)
+    {
+      int status;
+      if(pids[i] == 0)
+        continue;
+
+      const pid_t pid = waitpid(pids[i], &status, WNOHANG);
+      if(pid == 0)
+        continue;
+      if(pid == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+      {
+        pids[i] = 0;
+        for(k = 0; k < n; k++)
+          if(pids[k] != 0)
+          {
+            kill(pids[k], SIGKILL);
+            waitpid(pids[k], NULL, 0);
+            pids[k] = 0;
+          }
+        prerr("Error: A cache analysis worker failed\n");
+      }
+      pids[i] = 0;
+      remaining--;
+      reaped = 1;
+    }
+    if(!reaped)
+      nanosleep(&pause, NULL);
+  }
+}
+
+
+void
+runLevelCacheAnalysis(const cache_level_t *level, void (*analysis)(void),
+    const cache_set_results_t *set_results)
+{
+  DSTART( "runLevelCacheAnalysis" );
+
+  const int ns = level->config->ns;
+  int n = g_cache_analysis_workers;
+  int w;
+
+  if(n > ns)
+    n = ns;
+  if(n > MAX_CACHE_WORKERS)
+    n = MAX_CACHE_WORKERS;
+  if(loadStoredCacheResults(level, set_results))
+  {
+    DOUT("Using the stored results\n");
+    DEND();
+    return;
+  }
+  if(n <= 1)
+  {
+    analysis();
+    storeCacheResults(level, set_results);
+    DEND();
+    return;
+  }
+
+  DOUT("Analysing %d sets in %d workers\n", ns, n);
+
+  worker_sync_t * const sync = mmap(NULL, sizeof(worker_sync_t),
+      PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if(sync == MAP_FAILED)
+    prerr("Error: Could not map memory for the cache analysis workers\n");
+  memset(sync, 0, sizeof(worker_sync_t));
+
+  FILE **files = NULL;
+  pid_t *pids = NULL;
+  CALLOC(files, FILE**, n, sizeof(FILE*), "worker files");
+  CALLOC(pids, pid_t*, n, sizeof(pid_t), "worker pids");
+
+  // Do not let the workers write out what is still buffered here
+  fflush(NULL);
+
+  for(w = 0; w < n; w++)
+  {
+    files[w] = tmpfile();
+    if(!files[w])
+      prerr("Error: Could not create a file for a cache analysis worker\n");
+
+    pids[w] = fork();
+    if(pids[w] == -1)
+      prerr("Error: Could not start a cache analysis worker\n");
+    if(pids[w] == 0)
+    {
+      worker_sync = sync;
+      num_workers = n;
+      worker_id = w;
+      runWorker(level, analysis, set_results, files[w],
+          (int)((long long)w * ns / n), (int)((long long)(w + 1) * ns / n));
+    }
+  }
+
+  waitForWorkerProcesses(pids, n);
+
+  for(w = 0; w < n; w++)
+    rewind(files[w]);
+
+  result_io_t io = { level, files, n, 0, 0 };
+  transferProcResults(&io, main_copy);
+  _Bool ok = !io.failed;
+  if(set_results)
+    for(w = 0; ok && w < n; w++)
+      ok = set_results->read(files[w], (int)((long long)w * ns / n),
+          (int)((long long)(w + 1) * ns / n));
+  if(!ok)
+    prerr("Error: Incomplete cache analysis results\n");
+
+  for(w = 0; w < n; w++)
+    fclose(files[w]);
+  free(files);
+  free(pids);
+  munmap(sync, sizeof(worker_sync_t));
+
+  storeCacheResults(level, set_results);
+
+  DEND();
+}
@@ -0,0 +1,71 @@
+/*! This is a header file of the Chronos timing analyzer. */
+
+/*!
+  Splitting the abstract cache analysis of a cache level over worker
+  processes which each analyse a range of the cache sets
+*/
+
+#ifndef __CHRONOS_ANALYSIS_CACHE_PARALLEL_H
+#define __CHRONOS_ANALYSIS_CACHE_PARALLEL_H
+
+#include <stdio.h>
+
+#include "header.h"
+#include "analysisCache_level.h"
+
+// ######### Datatype declarations  ###########
+
+
+/* Per-set results a level driver keeps outside of the CHMCs. A worker writes
+   them for the sets [first, end) it analysed, the main process reads them
+   back into its own data structures. If they are incomplete, 'read'
+   returns 0 and leaves the sets as they were before the analysis. */
+typedef struct
+{
+  void (*write)(FILE *f, int first, int end);
+  _Bool (*read)(FILE *f, int first, int end);
+} cache_set_results_t;
+
+
+// ######### Function declarations  ###########
+
+
+/* Runs 'analysis', the traversal of the current task by the driver of
+   'level', either directly or, if more than one worker is requested in
+   'g_cache_analysis_workers', in worker processes which each run it for a
+   contiguous range of the level's sets. If a result store is configured
+   (see analysisCache_store.h), stored results replace the analysis and new
+   ones are stored. Afterwards, the CHMCs of the level
+   and the results in 'set_results' (may be NULL) are the same as those of
+   a direct run. The cache states of the level are not kept in that case. */
+void
+runLevelCacheAnalysis(const cache_level_t *level, void (*analysis)(void),
+    const cache_set_results_t *set_results);
+
+/* Writes the CHMCs of 'level' of all blocks of the current task and the
+   results in 'set_results' (may be NULL) for all sets to 'f'. Returns
+   whether everything could be written. */
+_Bool
+writeLevelCacheResults(const cache_level_t *level,
+    const cache_set_results_t *set_results, FILE *f);
+
+/* Reads what writeLevelCacheResults wrote into the blocks of the current
+   task, which must not have CHMCs of 'level' yet. Returns 0 if 'f' is
+   incomplete or malformed, the CHMCs read so far are kept then. */
+_Bool
+readLevelCacheResults(const cache_level_t *level,
+    const cache_set_results_t *set_results, FILE *f);
+
+/* Returns how many bytes of the results in 'f' are left to read. Readers
+   use it to reject counts which a corrupt file could not hold. */
+long
+remainingResultBytes(FILE *f);
+
+/* Returns the smallest 'cut' any of the workers passed. The drivers use this
+   where the accesses of a block depend on classifications in several sets,
+   without workers it just returns 'cut'. */
+int
+agreeOnCacheCut(int cut);
+
+
+#endif
@@ -0,0 +1,259 @@
+// mkstemp is not part of C99
+#define _DEFAULT_SOURCE
+
+// Include standard library headers
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+// Include local library headers
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <debugmacros/debugmacros.h>
+
+// Include local headers
+#include "analysisCache_store.h"
+#include "handler.h"
+
+
+/* The results of the cache analysis of a level only depend on the task's
+   input files and on the configuration of the level and of the levels
+   above it (whose classifications decide which accesses reach it). An
+   entry of the store is a file named by two 64 bit hashes (FNV-1 and
+   FNV-1a) of all of these, which holds the CHMCs in the format of the
+   cache analysis workers (see analysisCache_parallel.c) between a header
+   repeating the key and a trailer. Entries are written to a temporary file
+   first and renamed, so concurrent runs never see a partial entry. */
+
+
+// ######### Macros #########
+
+
+#define STORE_MAGIC "CHMCST01"
+#define STORE_MAGIC_LEN 8
+
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x00000100000001b3ULL
+
+
+// ######### Datatype declarations  ###########
+
+
+typedef struct
+{
+  ull fnv1;
+  ull fnv1a;
+} store_key_t;
+
+
+// #### Computing the key ####
+
+
+static void
+hashBytes(store_key_t *key, const void *data, size_t n)
+{
+  const unsigned char *bytes = (const unsigned char *)data;
+  size_t i;
+  for(i = 0; i < n; i++)
+  {
+    key->fnv1 = (key->fnv1 * FNV_PRIME) ^ bytes[i];
+    key->fnv1a = (key->fnv1a ^ bytes[i]) * FNV_PRIME;
+  }
+}
+
+
+static void
+hashInt(store_key_t *key, int value)
+{
+  hashBytes(key, &value, sizeof(int));
+}
+
+
+/* Hashes the contents of the input file of the current task with extension
+   'ext'. A missing file is hashed differently from an empty one. */
+static void
+hashTaskFile(store_key_t *key, const char *ext)
+{
+  char path[MAX_LEN];
+  char buffer[4096];
+  size_t n;
+
+  hashBytes(key, ext, strlen(ext) + 1);
+
+  snprintf(path, MAX_LEN, "%s.%s", filename, ext);
+  FILE * const f = fopen(path, "rb");
+  hashInt(key, f != NULL);
+  if(!f)
+    return;
+
+  while((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+    hashBytes(key, buffer, n);
+  fclose(f);
+}
+
+
+static void
+hashCacheConfig(store_key_t *key, const cache_t *config)
+{
+  hashInt(key, config->ns);
+  hashInt(key, config->ls);
+  hashInt(key, config->na);
+  hashInt(key, config->hit_latency);
+  hashInt(key, config->miss_latency);
+}
+
+
+static store_key_t
+computeStoreKey(const cache_level_t *level)
+{
+  store_key_t key = { FNV_OFFSET_BASIS, FNV_OFFSET_BASIS };
+
+  hashBytes(&key, STORE_MAGIC, STORE_MAGIC_LEN);
+  hashInt(&key, level->index);
+
+  hashCacheConfig(&key, cache_level_L1.config);
+  if(level->index >= CACHE_LEVEL_L2)
+    hashCacheConfig(&key, cache_level_L2.config);
+
+  hashTaskFile(&key, "arg");
+  hashTaskFile(&key, "cfg");
+  hashTaskFile(&key, "md");
+  hashTaskFile(&key, "lb");
+  hashTaskFile(&key, "ex");
+
+  return key;
+}
+
+
+static void
+getStorePath(char *path, const cache_level_t *level, const store_key_t *key)
+{
+  snprintf(path, MAX_LEN, "%s/%016llx%016llx-L%d.chmc", g_cache_result_store,
+      key->fnv1, key->fnv1a, level->index + 1);
+}
+
+
+// #### Reading and writing entries ####
+
+
+static _Bool
+writeStoreMark(FILE *f, const store_key_t *key)
+{
+  return fwrite(STORE_MAGIC, 1, STORE_MAGIC_LEN, f) == STORE_MAGIC_LEN &&
+    fwrite(key, sizeof(store_key_t), 1, f) == 1;
+}
+
+
+static _Bool
+readStoreMark(FILE *f, const store_key_t *key)
+{
+  char magic[STORE_MAGIC_LEN];
+  store_key_t stored;
+
+  return fread(magic, 1, STORE_MAGIC_LEN, f) == STORE_MAGIC_LEN &&
+    fread(&stored, sizeof(store_key_t), 1, f) == 1 &&
+    memcmp(magic, STORE_MAGIC, STORE_MAGIC_LEN) == 0 &&
+    stored.fnv1 == key->fnv1 && stored.fnv1a == key->fnv1a;
+}
+
+
+_Bool
+loadStoredCacheResults(const cache_level_t *level,
+    const cache_set_results_t *set_results)
+{
+  DSTART( "loadStoredCacheResults" );
+
+  char path[MAX_LEN];
+
+  if(!g_cache_result_store)
+    DRETURN( 0 );
+
+  const store_key_t key = computeStoreKey(level);
+  getStorePath(path, level, &key);
+
+  FILE * const f = fopen(path, "rb");
+  if(!f)
+  {
+    DOUT("No stored results in %s\n", path);
+    DRETURN( 0 );
+  }
+
+  /* Check the trailer first, the results can only be read if they are
+     complete. An entry which can not be read is a miss, the analysis runs
+     and replaces it. */
+  const long mark_size = STORE_MAGIC_LEN + sizeof(store_key_t);
+  _Bool ok = fseek(f, -mark_size, SEEK_END) == 0 && readStoreMark(f, &key) &&
+    fseek(f, 0, SEEK_SET) == 0 && readStoreMark(f, &key);
+  if(ok)
+  {
+    ok = readLevelCacheResults(level, set_results, f) &&
+      readStoreMark(f, &key) && fgetc(f) == EOF;
+    if(!ok)
+      freeLevelCHMCs(level, main_copy);
+  }
+  fclose(f);
+
+  if(!ok)
+  {
+    fprintf(stderr, "Warning: Discarding invalid cache analysis results in %s\n",
+        path);
+    unlink(path);
+  }
+  DRETURN( ok );
+}
+
+
+void
+storeCacheResults(const cache_level_t *level,
+    const cache_set_results_t *set_results)
+{
+  DSTART( "storeCacheResults" );
+
+  char path[MAX_LEN];
+  char temp_path[MAX_LEN + 8];
+
+  if(!g_cache_result_store)
+  {
+    DEND();
+    return;
+  }
+
+  const store_key_t key = computeStoreKey(level);
+  getStorePath(path, level, &key);
+  snprintf(temp_path, sizeof(temp_path), "%s.XXXXXX", path);
+
+  mkdir(g_cache_result_store, 0777);
+  const int fd = mkstemp(temp_path);
+  FILE * const f = fd == -1 ? NULL : fdopen(fd, "wb");
+  if(!f)
+  {
+    if(fd != -1)
+    {
+      close(fd);
+      unlink(temp_path);
+    }
+    fprintf(stderr, "Warning: Could not store cache analysis results in %s\n",
+        g_cache_result_store);
+    DEND();
+    return;
+  }
+
+  _Bool ok = writeStoreMark(f, &key) &&
+    writeLevelCacheResults(level, set_results, f) &&
+    writeStoreMark(f, &key);
+  ok = fclose(f) == 0 && ok;
+  if(ok && rename(temp_path, path) == 0)
+    DOUT("Stored the results in %s\n", path);
+  else
+  {
+    unlink(temp_path);
+    fprintf(stderr, "Warning: Could not store cache analysis results in %s\n",
+        path);
+  }
+
+  DEND();
+}
@@ -0,0 +1,34 @@
+/*! This is a header file of the Chronos timing analyzer. */
+
+/*!
+  Persistent store of the results of the abstract cache analysis, keyed by
+  a hash of everything they depend on
+*/
+
+#ifndef __CHRONOS_ANALYSIS_CACHE_STORE_H
+#define __CHRONOS_ANALYSIS_CACHE_STORE_H
+
+#include "header.h"
+#include "analysisCache_level.h"
+#include "analysisCache_parallel.h"
+
+// ######### Function declarations  ###########
+
+
+/* If results of 'level' for the current task are in the store directory
+   'g_cache_result_store', reads them into the blocks of the task and into
+   'set_results' (may be NULL) and returns 1. Returns 0 if there is no store
+   or no valid matching entry, an invalid one is deleted. */
+_Bool
+loadStoredCacheResults(const cache_level_t *level,
+    const cache_set_results_t *set_results);
+
+/* Puts the results of 'level' for the current task into the store
+   directory, if there is one. Failing to do so is not an error, the
+   results are just not stored then. */
+void
+storeCacheResults(const cache_level_t *level,
+    const cache_set_results_t *set_results);
+
+
+#endif
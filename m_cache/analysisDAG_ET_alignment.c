@@ -19,8 +19,10 @@
 #include "block.h"
 #include "busSchedule.h"
 #include "dump.h"
+#include "handler.h"
 #include "loopdetect.h"
 #include "offsetGraph.h"
+#include "resultMemo.h"
 #include "wcrt/cycle_time.h"
 
 
@@ -36,6 +38,34 @@ typedef struct {
   ull wcet;
 } combined_result;
 
+/* The kinds of memoized results */
+enum ResultKind {
+  RESULT_KIND_BLOCK,
+  RESULT_KIND_LOOP,
+  RESULT_KIND_LOOP_ITERATION,
+  RESULT_KIND_PROC
+};
+
+/* The key under which a result is memoized. 'id' is the block or loop id
+ * (for RESULT_KIND_LOOP, the id of the loop header, which is analyzed as the
+ * whole loop when entered from the outside),
+ * 'loop_context' the loop context of the block or loop (both are zero for
+ * procedures). 'offsets' canonically encodes the offsets at which the
+ * analysis started:
+ * - offset ranges by their lower and upper bound
+ * - offset interval lists by the bounds of each interval, packed into one
+ *   word per interval
+ * - offset sets by their handle, as equal sets have equal handles
+ * - time ranges by their best-case time modulo the TDMA interval and their
+ *   worst-case time shifted by the same amount, see getResultKey */
+typedef struct {
+  uint kind;
+  uint pid;
+  uint id;
+  uint loop_context;
+  ull offsets[OFFSET_INTERVALS_MAXIMUM];
+} result_memo_key;
+
 
 // #########################################
 // #### Declaration of static variables ####
@@ -54,37 +84,9 @@ static _Bool tryPenalizedAlignment = 1;
 /* The currently used offset representation. */
 static enum OffsetDataType currentOffsetRepresentation;
 
-/* This is a multi-level array for buffering the computed results
- * per block. In an access like
- *
- * block_results[p][b][lc][ol][ou]
- *
- * p = procedure id
- * b = block id
- * lc = loop context
- * ol = lower offset bound
- * ou = upper offset bound */
-static combined_result ******block_results = NULL;
-/* This is a multi-level array for buffering the computed results
- * per loop. In an access like
- *
- * loop_results[p][l][lc][ol][ou]
- *
- * p = procedure id
- * l = loop id
- * lc = loop context
- * ol = lower offset bound
- * ou = upper offset bound */
-static combined_result ******loop_results = NULL;
-/* This is a multi-level array for buffering the computed results
- * per procedure. In an access like
- *
- * proc_results[p][ol][ou]
- *
- * p = procedure id
- * ol = lower offset bound
- * ou = upper offset bound */
-static combined_result ****proc_results = NULL;
+/* The computed results of the blocks, single loop iterations and
+ * procedures of the current task, see result_memo_key. */
+static result_memo *result_buffer = NULL;
 
 
 // ##################################################
@@ -114,6 +116,7 @@ static _Bool isResultValid( const offset_data * const start_offsets,
 {
   if ( start_offsets != NULL ) {
     if ( start_offsets->type == OFFSET_DATA_TYPE_RANGE ||
+         start_offsets->type == OFFSET_DATA_TYPE_INTERVALS ||
          start_offsets->type == OFFSET_DATA_TYPE_SET ) {
       if ( r->bcet > r->wcet ) {
         return FALSE;
@@ -135,100 +138,217 @@ static _Bool isResultValid( const offset_data * const start_offsets,
 }
 
 
-/* Initializes the buffers to store intermediate results for the given task. */
-static void initResultBuffers( const task_t * const task )
+/* Initializes the buffer to store intermediate results for the given task.
+ * It gets half of the result memory, the flow problem solutions of the
+ * graph-tracking loop analysis share the rest (see 'g_result_memo_cap').
+ * The offset sets of the previous task are dropped as well, since the
+ * buffer was the last place to refer to them. */
+static void initResultBuffers( void )
+{
+  resetOffsetDataSets();
+  result_buffer = createResultMemo( sizeof( result_memo_key ),
+      sizeof( combined_result ), g_result_memo_cap / 2 );
+}
+/* Frees the buffer to store intermediate results for the given task. */
+static void freeResultBuffers( void )
+{
+  DACTION(
+    const result_memo_stats stats = getResultMemoStats( result_buffer );
+    DOUT( "Result buffer: %llu hits, %llu misses, %llu stores, "
+        "%llu evictions\n", stats.hits, stats.misses, stats.stores,
+        stats.evictions );
+  );
+  freeResultMemo( result_buffer );
+  result_buffer = NULL;
+}
+
+
+/* Sets 'key' to the key of the result of 'kind' for the given procedure,
+ * block or loop id and loop context, when starting from 'start_offsets'.
+ * Returns 0 if such results are not buffered.
+ *
+ * With the time range representation, the analysis only depends on the
+ * start times modulo the TDMA interval, and the resulting times move along
+ * with the start times. Therefore both start times are moved back by the
+ * same multiple of the TDMA interval for the key. This amount is written
+ * to '*time_shift' (it is 0 for all other representations) and must be
+ * removed from results before storing them with shiftResultTimes. */
+static _Bool getResultKey( result_memo_key *key, ull *time_shift,
+    enum ResultKind kind, uint pid, uint id, uint loop_context,
+    const offset_data * const start_offsets )
 {
-  int i, j, k, offset;
-  const uint tdma_interval = getCoreSchedule( ncore, 0 )->interval;
-
-  #define INIT_TDMA_GRID( ptr ) \
-    CALLOC( ptr, combined_result***, tdma_interval, \
-      sizeof( combined_result** ), #ptr ); \
-    for ( offset = 0; offset < tdma_interval; offset++ ) { \
-      CALLOC( ptr[offset], combined_result**, tdma_interval, \
-        sizeof( combined_result* ), #ptr "[offset]" ); \
+  memset( key, 0, sizeof( result_memo_key ) );
+  key->kind = kind;
+  key->pid = pid;
+  key->id = id;
+  key->loop_context = loop_context;
+  *time_shift = 0;
+
+  if ( currentOffsetRepresentation == OFFSET_DATA_TYPE_RANGE ) {
+    key->offsets[0] = getOffsetDataMinimumOffset( start_offsets );
+    key->offsets[1] = getOffsetDataMaximumOffset( start_offsets );
+    return 1;
+  } else if ( currentOffsetRepresentation == OFFSET_DATA_TYPE_INTERVALS ) {
+    const tdma_offset_intervals * const l = &start_offsets->content.offset_intervals;
+    uint i;
+    for ( i = 0; i < l->num_intervals; i++ ) {
+      key->offsets[i] = ( (ull)l->intervals[i].lower_bound << 32 ) |
+                        l->intervals[i].upper_bound;
+    }
+    return 1;
+  } else if ( currentOffsetRepresentation == OFFSET_DATA_TYPE_SET ) {
+    key->offsets[0] = start_offsets->content.offset_set.handle;
+    return 1;
+  } else if ( currentOffsetRepresentation == OFFSET_DATA_TYPE_TIME_RANGE ) {
+    /* The latencies of segmented schedules are not periodic. */
+    if ( getSchedule()->type != SCHED_TYPE_1 ) {
+      return 0;
     }
+    const time_bounds * const times = &start_offsets->content.time_range;
+    const uint tdma_interval = getCoreSchedule( ncore, 0 )->interval;
+    *time_shift = times->bcet_time - times->bcet_time % tdma_interval;
+    key->offsets[0] = times->bcet_time - *time_shift;
+    key->offsets[1] = times->wcet_time - *time_shift;
+    return 1;
+  }
+  return 0;
+}
+
+
+/* Adds 'shift' to the times of a result in the time range representation.
+ * Subtracting is done by passing the negated shift, which works because
+ * unsigned arithmetic wraps around. */
+static void shiftResultTimes( combined_result * const r, const ull shift )
+{
+  if ( r->offsets.type == OFFSET_DATA_TYPE_TIME_RANGE ) {
+    r->offsets.content.time_range.bcet_time += shift;
+    r->offsets.content.time_range.wcet_time += shift;
+  }
+}
 
-  CALLOC( block_results, combined_result******, task->num_proc,
-      sizeof( combined_result***** ), "block_results" );
-  CALLOC( loop_results, combined_result******, task->num_proc,
-        sizeof( combined_result***** ), "loop_results" );
-  CALLOC( proc_results, combined_result****, task->num_proc,
-        sizeof( combined_result*** ), "proc_results" );
 
-  for ( i = 0; i < task->num_proc; i++ ) {
-    const procedure * const proc = task->procs[i];
+/* Looks up the result under 'key' and writes it, moved by 'time_shift',
+ * into '*result'. Returns 0 if there is no such result. */
+static _Bool lookupResult( const result_memo_key * const key,
+    const ull time_shift, combined_result * const result )
+{
+  const combined_result * const r = lookupResultMemo( result_buffer, key );
+  if ( r == NULL ) {
+    return 0;
+  }
+  *result = *r;
+  shiftResultTimes( result, time_shift );
+  return 1;
+}
 
-    INIT_TDMA_GRID( proc_results[i] );
 
-    // One slot for each context + 1 for context zero
-    const int contextSlots = getMaximumLoopContext( proc ) + 1;
+/* Stores 'result' under 'key' after removing 'time_shift' from it. */
+static void storeResult( const result_memo_key * const key,
+    const ull time_shift, combined_result result )
+{
+  shiftResultTimes( &result, -time_shift );
+  storeResultMemo( result_buffer, key, &result );
+}
 
-    CALLOC( block_results[i], combined_result*****, proc->num_bb,
-          sizeof( combined_result**** ), "block_results[i]" );
-    for ( j = 0; j < proc->num_bb; j++ ) {
-      CALLOC( block_results[i][j], combined_result****, contextSlots,
-            sizeof( combined_result*** ), "block_results[i][j]" );
-      for ( k = 0; k < contextSlots; k++ ) {
-        INIT_TDMA_GRID( block_results[i][j][k] );
-      }
-    }
 
-    CALLOC( loop_results[i], combined_result*****, proc->num_loops,
-          sizeof( combined_result**** ), "loop_results[i]" );
-    for ( j = 0; j < proc->num_loops; j++ ) {
-      CALLOC( loop_results[i][j], combined_result****, contextSlots,
-            sizeof( combined_result*** ), "loop_results[i][j]" );
-      for ( k = 0; k < contextSlots; k++ ) {
-        INIT_TDMA_GRID( loop_results[i][j][k] );
-      }
+/* Returns the minimum (BCET) or maximum (WCET) latency of an access of 'type'
+ * over all offsets in 'offsets', see boundLatencyOverOffsets. Empty offsets
+ * give the bound over all offsets. */
+static latency_bound boundLatency( const offset_data * const offsets,
+    const acc_type type, enum AccessScenario scenario )
+{
+  latency_bound bound;
+  initLatencyBound( &bound, scenario );
+
+  if ( isOffsetDataEmpty( offsets ) ) {
+    offset_data all = *offsets;
+    setOffsetDataMaximal( &all );
+    return boundLatency( &all, type, scenario );
+  }
+
+  if ( offsets->type == OFFSET_DATA_TYPE_RANGE ) {
+    const tdma_offset_bounds * const range = &offsets->content.offset_range;
+    boundLatencyOverOffsets( &bound, range->lower_bound, range->upper_bound,
+                             type, scenario );
+  } else if ( offsets->type == OFFSET_DATA_TYPE_INTERVALS ) {
+    const tdma_offset_intervals * const l = &offsets->content.offset_intervals;
+    uint i;
+    for ( i = 0; i < l->num_intervals; i++ ) {
+      boundLatencyOverOffsets( &bound, l->intervals[i].lower_bound,
+                               l->intervals[i].upper_bound, type, scenario );
     }
+  } else if ( offsets->type == OFFSET_DATA_TYPE_SET ) {
+    /* Pass the maximal runs of offsets in the set in ascending order. */
+    _Bool inRun = 0;
+    uint run_start = 0;
+    uint run_end = 0;
+    ITERATE_OFFSETS( (*offsets), o,
+      if ( inRun && o == run_end + 1 ) {
+        run_end = o;
+      } else {
+        if ( inRun ) {
+          boundLatencyOverOffsets( &bound, run_start, run_end, type, scenario );
+        }
+        run_start = o;
+        run_end = o;
+        inRun = 1;
+      }
+    );
+    assert( inRun && "Empty offset set!" );
+    boundLatencyOverOffsets( &bound, run_start, run_end, type, scenario );
+  } else {
+    assert( 0 && "Unsupported offset representation!" );
   }
+
+  return bound;
 }
-/* Frees the buffers to store intermediate results for the given task. */
-static void freeResultBuffers( const task_t * const task )
+
+
+/* Adds the offsets at which the best case access 'best_type' and the worst
+ * case access 'worst_type' end, when starting at the offsets in 'offsets',
+ * to 'end_offsets', see addAccessEndOffsets. */
+static void addEndOffsets( offset_data * const end_offsets,
+    const offset_data * const offsets, const acc_type best_type,
+    const acc_type worst_type )
 {
-  int i, j, k, offset_1, offset_2;
-  const uint tdma_interval = getCoreSchedule( ncore, 0 )->interval;
-
-  #define FREE_TDMA_GRID( ptr ) \
-    for ( offset_1 = 0; offset_1 < tdma_interval; offset_1++ ) { \
-      for ( offset_2 = 0; offset_2 < tdma_interval; offset_2++ ) { \
-        if ( ptr[offset_1][offset_2] != NULL ) { \
-          free( ptr[offset_1][offset_2] ); \
-        } \
-      } \
-      free( ptr[offset_1] ); \
-    } \
-    free( ptr );
-
-  for ( i = 0; i < task->num_proc; i++ ) {
-    const procedure * const proc = task->procs[i];
-
-    FREE_TDMA_GRID( proc_results[i] );
-
-    const int maxLoopContext = getMaximumLoopContext( proc ) + 1;
-
-    for ( j = 0; j < proc->num_bb; j++ ) {
-      for ( k = 0; k < maxLoopContext; k++ ) {
-        FREE_TDMA_GRID( block_results[i][j][k] );
-      }
-      free( block_results[i][j] );
-    }
-    free( block_results[i] );
+  #define ADD_END_OFFSETS( lower, upper ) { \
+    addAccessEndOffsets( end_offsets, lower, upper, best_type, \
+                         ACCESS_SCENARIO_BCET ); \
+    addAccessEndOffsets( end_offsets, lower, upper, worst_type, \
+                         ACCESS_SCENARIO_WCET ); \
+  }
 
-    for ( j = 0; j < proc->num_loops; j++ ) {
-      for ( k = 0; k < maxLoopContext; k++ ) {
-        FREE_TDMA_GRID( loop_results[i][j][k] );
-      }
-      free( loop_results[i][j] );
+  if ( offsets->type == OFFSET_DATA_TYPE_INTERVALS ) {
+    const tdma_offset_intervals * const l = &offsets->content.offset_intervals;
+    uint i;
+    for ( i = 0; i < l->num_intervals; i++ ) {
+      ADD_END_OFFSETS( l->intervals[i].lower_bound,
+                       l->intervals[i].upper_bound );
     }
-    free( loop_results[i] );
+  } else if ( offsets->type == OFFSET_DATA_TYPE_SET ) {
+    /* Pass the maximal runs of offsets in the set. */
+    _Bool inRun = 0;
+    uint run_start = 0;
+    uint run_end = 0;
+    ITERATE_OFFSETS( (*offsets), o,
+      if ( inRun && o == run_end + 1 ) {
+        run_end = o;
+      } else {
+        if ( inRun ) {
+          ADD_END_OFFSETS( run_start, run_end );
+        }
+        run_start = o;
+        run_end = o;
+        inRun = 1;
+      }
+    );
+    assert( inRun && "Empty offset set!" );
+    ADD_END_OFFSETS( run_start, run_end );
+  } else {
+    assert( 0 && "Unsupported offset representation!" );
   }
 
-  free( block_results );
-  free( loop_results );
-  free( proc_results );
+  #undef ADD_END_OFFSETS
 }
 
 
@@ -258,8 +378,8 @@ static int getEffectiveDAGPredecessorIndex( const block * const bb,
    * Therefore we must convert that index into an index into the
    * DAG block list. For that purpose we use the block
    * id which identifies the block inside the function. */
-  int conv_pred_idx = getblock( pred->bbid, dag_block_list,
-                                    0, dag_block_number - 1 );
+  int conv_pred_idx = getTopoIndex( proc, pred->bbid, dag_block_list,
+                                    dag_block_number );
 
   /* The predecessor is not in this DAG. */
   if ( conv_pred_idx < 0 ) {
@@ -310,8 +430,8 @@ static int getEffectiveDAGPredecessorIndex( const block * const bb,
       placeholder = exitedLoop->loophead;
     }
 
-    conv_pred_idx = getblock( placeholder->bbid, dag_block_list,
-                              0, dag_block_number - 1 );
+    conv_pred_idx = getTopoIndex( proc, placeholder->bbid, dag_block_list,
+                                  dag_block_number );
     assert( conv_pred_idx >= 0 && "Missing block!" );
   }
 
@@ -338,7 +458,7 @@ static offset_data getStartOffsets( const block * const bb,
   assert( bb && proc && dag_block_results && dag_block_list && "Invalid arguments!" );
   offset_data result;
 
-  DOUT( "Getting start offset for block %u.%u (0x%s)\n",
+  DOUT( "Getting start offset for block %u.%u (0x%x)\n",
       bb->pid, bb->bbid, bb->instrlist[0]->addr );
 
   int i;
@@ -348,7 +468,7 @@ static offset_data getStartOffsets( const block * const bb,
     const block * const pred = proc->bblist[pred_index];
     assert( pred && "Missing basic block!" );
 
-    DOUT( "Accounting for predecessor information from bb %u.%u (0x%s)\n",
+    DOUT( "Accounting for predecessor information from bb %u.%u (0x%x)\n",
         pred->pid, pred->bbid, pred->instrlist[0]->addr );
 
     /* The predecessor may be a loop exit, which must be mapped to its
@@ -417,7 +537,7 @@ static combined_result summarizeDAGResults( uint number_of_blocks,
       block_bcet_propagation_values[i] = block_results[i].bcet;
       block_wcet_propagation_values[i] = block_results[i].wcet;
 
-      DOUT( "Processing head block: BCET %llu, WCET %llu (block 0x%s, index %d)\n",
+      DOUT( "Processing head block: BCET %llu, WCET %llu (block 0x%x, index %d)\n",
           block_bcet_propagation_values[i],
           block_wcet_propagation_values[i], bb->instrlist[0]->addr, i );
     } else {
@@ -446,8 +566,8 @@ static combined_result summarizeDAGResults( uint number_of_blocks,
           block_bcet_propagation_values[i] = bcet_via_pred;
           block_wcet_propagation_values[i] = wcet_via_pred;
 
-          DOUT( "Propagating from predecessor (0x%s, index %d): BCET %llu, "
-            "WCET %llu (block 0x%s, index %d)\n", pred->instrlist[0]->addr,
+          DOUT( "Propagating from predecessor (0x%x, index %d): BCET %llu, "
+            "WCET %llu (block 0x%x, index %d)\n", pred->instrlist[0]->addr,
             conv_pred_idx, block_bcet_propagation_values[i],
             block_wcet_propagation_values[i], bb->instrlist[0]->addr, i );
         } else {
@@ -456,8 +576,8 @@ static combined_result summarizeDAGResults( uint number_of_blocks,
           block_wcet_propagation_values[i] =
               MAX( block_wcet_propagation_values[i], wcet_via_pred );
 
-          DOUT( "MIN/MAXed with predecessor (0x%s, index %d): BCET %llu, "
-            "WCET %llu (block 0x%s, index %d)\n", pred->instrlist[0]->addr,
+          DOUT( "MIN/MAXed with predecessor (0x%x, index %d): BCET %llu, "
+            "WCET %llu (block 0x%x, index %d)\n", pred->instrlist[0]->addr,
             conv_pred_idx, block_bcet_propagation_values[i],
             block_wcet_propagation_values[i], bb->instrlist[0]->addr, i );
         }
@@ -509,38 +629,33 @@ static combined_result analyze_block( const block * const bb,
       "offsets %s\n", proc->pid, bb->bbid, loop_context,
       getOffsetDataString( &start_offsets ) );
 
-  /* Check whether we have already computed the requested result. */
-  combined_result **bufferLocation = NULL;
-  if ( currentOffsetRepresentation == OFFSET_DATA_TYPE_RANGE ) {
-    bufferLocation = &block_results[proc->pid][bb->bbid]
-      [loop_context][getOffsetDataMinimumOffset( &start_offsets )]
-                    [getOffsetDataMaximumOffset( &start_offsets )];
-  } else if ( currentOffsetRepresentation == OFFSET_DATA_TYPE_SET ) {
-    tdma_offset_bounds range;
-    if ( isOffsetDataRangeValue( &start_offsets, &range ) ) {
-      bufferLocation = &block_results[proc->pid][bb->bbid]
-        [loop_context][range.lower_bound][range.upper_bound];
-    } else {
-      bufferLocation = NULL;
-    }
-  } else {
-    bufferLocation = NULL;
-  }
-  if ( bufferLocation != NULL && *bufferLocation != NULL ) {
-    DRETURN( **bufferLocation );
+  /* Check whether the block is some header of a loop structure.
+   * In that case do separate analysis of the loop */
+  /* Exception is when we are currently in the process of analyzing
+   * the same loop */
+  loop * const inlp = check_loop( bb, proc );
+  const _Bool enters_loop =
+    inlp && ( !cur_lp || ( inlp->lpid != cur_lp->lpid ) );
+
+  /* Check whether we have already computed the requested result. The first
+   * iteration of a loop runs in the context of the surrounding code, so the
+   * result of the whole loop needs a different kind than that of its header
+   * from the inside. */
+  result_memo_key bufferKey;
+  ull bufferShift;
+  const _Bool buffered = getResultKey( &bufferKey, &bufferShift,
+      enters_loop ? RESULT_KIND_LOOP : RESULT_KIND_BLOCK, proc->pid,
+      bb->bbid, loop_context, &start_offsets );
+  combined_result result;
+  if ( buffered && lookupResult( &bufferKey, bufferShift, &result ) ) {
+    DRETURN( result );
   }
 
-  combined_result result;
   result.bcet = 0;
   result.wcet = 0;
   result.offsets = start_offsets;
 
-  /* Check whether the block is some header of a loop structure.
-   * In that case do separate analysis of the loop */
-  /* Exception is when we are currently in the process of analyzing
-   * the same loop */
-  loop * const inlp = check_loop( bb, proc );
-  if ( inlp && ( !cur_lp || ( inlp->lpid != cur_lp->lpid ) ) ) {
+  if ( enters_loop ) {
 
     DOUT( "Block represents inner loop!\n" );
     result = analyze_loop( inlp, proc, loop_context, start_offsets );
@@ -572,9 +687,18 @@ static combined_result analyze_block( const block * const bb,
         currentOffsetRepresentation == OFFSET_DATA_TYPE_TIME_RANGE;
     const _Bool haveSetRepresentation =
         currentOffsetRepresentation == OFFSET_DATA_TYPE_SET;
+    const _Bool haveIntervalRepresentation =
+        currentOffsetRepresentation == OFFSET_DATA_TYPE_INTERVALS;
+    /* Whether the offsets are computed along with the latencies. */
+    const _Bool haveOffsetResults =
+        haveSetRepresentation || haveIntervalRepresentation;
 
-    // TODO: This won't work correctly for segmented schedules
-    const uint tdma_interval = getCoreSchedule( ncore, 0 )->interval;
+    const uint tdma_interval = getOffsetDataMaxOffset() + 1;
+
+    const unsigned char * const best_acc_types = getAccessTypes( bb,
+        loop_context, ACCESS_SCENARIO_BCET );
+    const unsigned char * const worst_acc_types = getAccessTypes( bb,
+        loop_context, ACCESS_SCENARIO_WCET );
 
     int i;
     for ( i = 0; i < bb->num_instr; i++ ) {
@@ -593,12 +717,11 @@ static combined_result analyze_block( const block * const bb,
       _Bool usedFixedBCOffset = FALSE;
       _Bool usedFixedWCOffset = FALSE;
 
-      /* Some temporaries. */
-      _Bool waitedForNextTDMASlot;
-
       /* This will hold the offset results in case we are analyzing
-       * with the set representation. */
-      offset_data offsetSetResults = createOffsetDataSet();
+       * with the set or interval list representation. */
+      offset_data offsetSetResults = ( haveIntervalRepresentation ?
+                                       createOffsetDataIntervals() :
+                                       createOffsetDataSet() );
 
       /* TODO: The access latencies and the instruction BCET/WCET
        *       are currently just given as a single value. For the
@@ -608,11 +731,10 @@ static combined_result analyze_block( const block * const bb,
        */
 
       /* Compute instruction cache access duration. */
-      const acc_type best_acc  = check_hit_miss( bb, inst, loop_context,
-                                                 ACCESS_SCENARIO_BCET );
+      const acc_type best_acc  = best_acc_types[i];
       if ( useFixedBCOffset || haveExplicitTime ) {
         /* Update with fixed offset. */
-        uint bcOffset;
+        ull bcOffset;
         if ( useFixedBCOffset ) {
           bcOffset = fixedBCOffset;
         } else {
@@ -622,44 +744,35 @@ static combined_result analyze_block( const block * const bb,
             assert( 0 && "Unsupported offset representation!" );
           }
         }
-        const uint latency = determine_latency( bb, bcOffset, best_acc,
-                                                NULL, ACCESS_SCENARIO_BCET );
+        const uint latency = determineOffsetLatency( bb, bcOffset, best_acc,
+                                                     ACCESS_SCENARIO_BCET );
         result.bcet += latency;
         usedFixedBCOffset = TRUE;
 
-        // Add the resulting offset if we analyze with offset sets
-        if ( haveSetRepresentation ) {
+        // Add the resulting offset if we analyze with offset sets or lists
+        if ( haveOffsetResults ) {
           updateOffsetData( &offsetSetResults, &result.offsets,
                             latency, latency, TRUE );
         }
       } else {
-        /* Iterate over the current offset range and determine minimum latency. */
-        uint min_latency = UINT_MAX;
-
-        ITERATE_OFFSETS( result.offsets, j,
-          const uint latency = determine_latency( bb, j, best_acc,
-                                                  &waitedForNextTDMASlot,
-                                                  ACCESS_SCENARIO_BCET );
-          if ( latency < min_latency ) {
-            min_latency = latency;
-
-            /* Check whether we have reached a block-internal fixed alignment. */
-            if ( waitedForNextTDMASlot ) {
-              useFixedBCOffset = 1;
-              fixedBCOffset    = j;
-            }
-          }
-        );
-        assert( min_latency != UINT_MAX );
-        result.bcet += min_latency;
+        /* Determine the minimum latency over the current offset range. */
+        const latency_bound min_latency = boundLatency( &result.offsets,
+            best_acc, ACCESS_SCENARIO_BCET );
+        assert( min_latency.latency != UINT_MAX );
+        result.bcet += min_latency.latency;
+
+        /* Check whether we have reached a block-internal fixed alignment. */
+        if ( min_latency.has_waited_for_next_tdma_slot ) {
+          useFixedBCOffset = 1;
+          fixedBCOffset    = min_latency.waited_offset;
+        }
       }
 
       /* Compute instruction cache access duration for worst case. */
-      const acc_type worst_acc = check_hit_miss( bb, inst, loop_context,
-                                                 ACCESS_SCENARIO_WCET );
+      const acc_type worst_acc = worst_acc_types[i];
       if ( useFixedWCOffset || haveExplicitTime ) {
         /* Update with fixed offset. */
-        uint wcOffset;
+        ull wcOffset;
         if ( useFixedWCOffset ) {
           wcOffset = fixedWCOffset;
         } else {
@@ -669,49 +782,32 @@ static combined_result analyze_block( const block * const bb,
             assert( 0 && "Unsupported offset representation!" );
           }
         }
-        const uint latency = determine_latency( bb, wcOffset, worst_acc,
-                                                NULL, ACCESS_SCENARIO_WCET );
+        const uint latency = determineOffsetLatency( bb, wcOffset, worst_acc,
+                                                     ACCESS_SCENARIO_WCET );
         result.wcet += latency;
         usedFixedWCOffset = TRUE;
 
-        // Add the resulting offset if we analyze with offset sets
-        if ( haveSetRepresentation ) {
+        // Add the resulting offset if we analyze with offset sets or lists
+        if ( haveOffsetResults ) {
           updateOffsetData( &offsetSetResults, &result.offsets,
                             latency, latency, TRUE );
         }
       } else {
-        /* Iterate over the current offset range and determine maximum latency. */
-        uint max_latency = 0;
-        ITERATE_OFFSETS( result.offsets, j,
-          const uint latency = determine_latency( bb, j, worst_acc,
-                                                  &waitedForNextTDMASlot,
-                                                  ACCESS_SCENARIO_WCET );
-          if ( latency > max_latency ) {
-            max_latency = latency;
-
-            /* Check whether we have reached a block-internal fixed alignment. */
-            if ( waitedForNextTDMASlot ) {
-              useFixedWCOffset = 1;
-              fixedWCOffset    = j;
-            }
-          }
-        );
-        result.wcet += max_latency;
+        /* Determine the maximum latency over the current offset range. */
+        const latency_bound max_latency = boundLatency( &result.offsets,
+            worst_acc, ACCESS_SCENARIO_WCET );
+        result.wcet += max_latency.latency;
+
+        /* Check whether we have reached a block-internal fixed alignment. */
+        if ( max_latency.has_waited_for_next_tdma_slot ) {
+          useFixedWCOffset = 1;
+          fixedWCOffset    = max_latency.waited_offset;
+        }
       }
 
       /* Compute the offset results if in set analysis mode. */
-      if ( haveSetRepresentation &&
-           ( !usedFixedBCOffset || !usedFixedWCOffset ) ) {
-        ITERATE_OFFSETS( result.offsets, j,
-          const uint best_latency  = determine_latency( bb, j, best_acc,  NULL,
-                                                        ACCESS_SCENARIO_BCET );
-          const uint worst_latency = determine_latency( bb, j, worst_acc, NULL,
-                                                        ACCESS_SCENARIO_WCET );
-          updateOffsetData( &offsetSetResults, &result.offsets, best_latency,
-                            best_latency, TRUE );
-          updateOffsetData( &offsetSetResults, &result.offsets, worst_latency,
-                            worst_latency, TRUE );
-        );
+      if ( haveOffsetResults && ( !usedFixedBCOffset || !usedFixedWCOffset ) ) {
+        addEndOffsets( &offsetSetResults, &result.offsets, best_acc, worst_acc );
       }
 
       /* Then add cost for executing the instruction. */
@@ -721,7 +817,7 @@ static combined_result analyze_block( const block * const bb,
       result.wcet += execution_wcet;
 
       /* Update the offset results if in set analysis mode. */
-      if ( haveSetRepresentation ) {
+      if ( haveOffsetResults ) {
         assert( !isOffsetDataEmpty( &offsetSetResults ) && "Internal error!" );
         updateOffsetData( &offsetSetResults, &offsetSetResults, execution_bcet,
             execution_wcet, FALSE );
@@ -739,7 +835,7 @@ static combined_result analyze_block( const block * const bb,
 
       /* For the set representation the offsets are computed during
        * the timing computation above. */
-      if ( haveSetRepresentation ) {
+      if ( haveOffsetResults ) {
         assert( result.offsets.type == offsetSetResults.type && "Type mismatch!" );
         result.offsets = offsetSetResults;
       } else {
@@ -751,8 +847,8 @@ static combined_result analyze_block( const block * const bb,
       }
 
       /* Handle procedure call instruction */
-      if ( IS_CALL(inst->op) ) {
-        procedure * const callee = getCallee( inst, proc );
+      if ( IS_CALL(inst) ) {
+        procedure * const callee = inst->callee;
 
         /* Deactivate block-internal fixed offset mode, because the call will
          * return its own offset information which overrides ours. */
@@ -785,36 +881,24 @@ static combined_result analyze_block( const block * const bb,
           stringPtr += sprintf( stringPtr, " %s",
               getOffsetDataString( &result.offsets ) );
 
-          DOUT( "  Instruction 0x%s: BCET %llu, WCET %llu %s\n", inst->addr,
+          DOUT( "  Instruction 0x%x: BCET %llu, WCET %llu %s\n", inst->addr,
             result.bcet - old_bcet, result.wcet - old_wcet, offsetString );
       );
     }
   }
 
   /* Insert result into result buffer. */
-  if ( bufferLocation != NULL ) {
-    /* This function will be entered twice for loop headers, one time from
-     * the outside and one time from inside the loop. Therefore the buffer
-     * will have been filled during the loop header analysis which comes
-     * from the outside.
-     */
-    const _Bool nested_loopheader = ( inlp && cur_lp != inlp );
-    if ( nested_loopheader && inlp->loopbound != 0 ) {
-      assert( *bufferLocation != NULL &&
-          "Nested loop header information should have been computed!" );
-    } else {
-      assert( *bufferLocation == NULL &&  "Tried to overwrite buffered result!" );
-      MALLOC( *bufferLocation, combined_result*,
-          sizeof( combined_result ), "*bufferLocation" );
-    }
-    **bufferLocation = result;
+  if ( buffered ) {
+    assert( lookupResultMemo( result_buffer, &bufferKey ) == NULL &&
+            "Tried to overwrite buffered result!" );
+    storeResult( &bufferKey, bufferShift, result );
   }
 
   DACTION(
-    DOUT( "Accounting BCET %llu, WCET %llu for block %u.%u 0x%s - 0x%s\n",
+    DOUT( "Accounting BCET %llu, WCET %llu for block %u.%u 0x%x - 0x%x\n",
       result.bcet, result.wcet, bb->pid, bb->bbid,
-        bb->num_instr > 0 ? bb->instrlist[0]->addr                 : "0x0",
-        bb->num_instr > 0 ? bb->instrlist[bb->num_instr - 1]->addr : "0x0" );
+        bb->num_instr > 0 ? bb->instrlist[0]->addr                 : 0,
+        bb->num_instr > 0 ? bb->instrlist[bb->num_instr - 1]->addr : 0 );
   );
 
   assert( isResultValid( &start_offsets, &result ) && "Invalid result!" );
@@ -834,28 +918,18 @@ static combined_result analyze_single_loop_iteration( const loop * const lp,
       getOffsetDataString( &start_offsets ) );
 
   /* Check whether we have already computed the requested result. */
-  combined_result **bufferLocation = NULL;
-  if ( currentOffsetRepresentation == OFFSET_DATA_TYPE_RANGE ) {
-    bufferLocation = &loop_results[proc->pid][lp->lpid]
-      [loop_context][getOffsetDataMinimumOffset( &start_offsets )]
-                    [getOffsetDataMaximumOffset( &start_offsets )];
-  } else if ( currentOffsetRepresentation == OFFSET_DATA_TYPE_SET ) {
-    tdma_offset_bounds range;
-    if ( isOffsetDataRangeValue( &start_offsets, &range ) ) {
-      bufferLocation = &loop_results[proc->pid][lp->lpid]
-        [loop_context][range.lower_bound][range.upper_bound];
-    } else {
-      bufferLocation = NULL;
-    }
-  } else {
-    bufferLocation = NULL;
-  }
-  if ( bufferLocation != NULL && *bufferLocation != NULL ) {
+  result_memo_key bufferKey;
+  ull bufferShift;
+  const _Bool buffered = getResultKey( &bufferKey, &bufferShift,
+      RESULT_KIND_LOOP_ITERATION, proc->pid, lp->lpid, loop_context,
+      &start_offsets );
+  combined_result buffered_result;
+  if ( buffered && lookupResult( &bufferKey, bufferShift, &buffered_result ) ) {
     DOUT( "Returned result from buffer!\n" );
     DOUT( "Loop iteration analysis BCET / WCET result is %llu / %llu"
-        " with offsets %s\n", (*bufferLocation)->bcet, (*bufferLocation)->wcet,
-        getOffsetDataString( &(*bufferLocation)->offsets ) );
-    DRETURN( **bufferLocation );
+        " with offsets %s\n", buffered_result.bcet, buffered_result.wcet,
+        getOffsetDataString( &buffered_result.offsets ) );
+    DRETURN( buffered_result );
   }
 
   /* Get an array for the result values per basic block. */
@@ -887,11 +961,10 @@ static combined_result analyze_single_loop_iteration( const loop * const lp,
   free( block_results );
 
   /* Insert result into result buffer. */
-  if ( bufferLocation != NULL ) {
-    assert( *bufferLocation == NULL && "Tried to overwrite buffered result!" );
-    MALLOC( *bufferLocation, combined_result*,
-        sizeof( combined_result ), "*bufferLocation" );
-    **bufferLocation = result;
+  if ( buffered ) {
+    assert( lookupResultMemo( result_buffer, &bufferKey ) == NULL &&
+            "Tried to overwrite buffered result!" );
+    storeResult( &bufferKey, bufferShift, result );
   }
 
   DOUT( "Loop iteration analysis BCET / WCET result is %llu / %llu"
@@ -1052,8 +1125,7 @@ static combined_result analyze_loop_graph_tracking( const loop * const lp,
       getOffsetDataString( &start_offsets ) );
 
   // Get the current TDMA interval
-  // TODO: This won't work correctly for segmented schedules
-  const uint tdma_interval = getCoreSchedule( ncore, 0 )->interval;
+  const uint tdma_interval = getOffsetDataMaxOffset() + 1;
 
   // The first iteration must be unrolled, because its overly big execution times
   // would disturb the ILP (it does not know that these execution times can only
@@ -1322,6 +1394,356 @@ static combined_result analyze_loop_graph_tracking( const loop * const lp,
 }
 
 
+/* Marks a missing entry of an offset matrix / vector (no sequence of
+ * iterations leads from the start to the end offset). */
+#define OFFSET_MATRIX_NO_PATH ULLONG_MAX
+
+/* The maximum number of reachable offsets for which analyze_loop_max_plus
+ * builds its dense matrices, beyond that it falls back to graph tracking. */
+#define MAX_PLUS_MAXIMUM_OFFSETS 1024
+
+/* Returns the better one of two execution times in the max-plus (WCET,
+ * 'maximize' is set) or min-plus (BCET) semiring. */
+static ull betterTime( const ull a, const ull b, const _Bool maximize )
+{
+  if ( a == OFFSET_MATRIX_NO_PATH ) {
+    return b;
+  } else if ( b == OFFSET_MATRIX_NO_PATH ) {
+    return a;
+  } else {
+    return ( maximize ? MAX( a, b ) : MIN( a, b ) );
+  }
+}
+
+/* Computes the 'size' x 'size' offset matrix product 'result' = 'a' * 'b'
+ * in the max-plus (min-plus) semiring. Entry (i, j) of such a matrix is
+ * stored at [i * size + j] and holds the maximum (minimum) execution time
+ * from offset i to offset j. */
+static void multiplyOffsetMatrices( ull * const result, const ull * const a,
+    const ull * const b, const uint size, const _Bool maximize )
+{
+  uint i, j, k;
+  for ( i = 0; i < size * size; i++ ) {
+    result[i] = OFFSET_MATRIX_NO_PATH;
+  }
+  for ( i = 0; i < size; i++ ) {
+    for ( k = 0; k < size; k++ ) {
+      const ull a_ik = a[i * size + k];
+      if ( a_ik == OFFSET_MATRIX_NO_PATH ) {
+        continue;
+      }
+      for ( j = 0; j < size; j++ ) {
+        const ull b_kj = b[k * size + j];
+        if ( b_kj != OFFSET_MATRIX_NO_PATH ) {
+          result[i * size + j] = betterTime( result[i * size + j],
+                                             a_ik + b_kj, maximize );
+        }
+      }
+    }
+  }
+}
+
+/* Computes the vector product 'result' = 'v' * 'm' like
+ * multiplyOffsetMatrices. */
+static void multiplyOffsetVector( ull * const result, const ull * const v,
+    const ull * const m, const uint size, const _Bool maximize )
+{
+  uint i, j;
+  for ( j = 0; j < size; j++ ) {
+    result[j] = OFFSET_MATRIX_NO_PATH;
+  }
+  for ( i = 0; i < size; i++ ) {
+    if ( v[i] == OFFSET_MATRIX_NO_PATH ) {
+      continue;
+    }
+    for ( j = 0; j < size; j++ ) {
+      const ull m_ij = m[i * size + j];
+      if ( m_ij != OFFSET_MATRIX_NO_PATH ) {
+        result[j] = betterTime( result[j], v[i] + m_ij, maximize );
+      }
+    }
+  }
+}
+
+/* Replaces 'v' by 'v' * 'm'^'exponent', see multiplyOffsetMatrices. */
+static void powerOffsetVector( ull * const v, const ull * const m,
+    const uint size, ull exponent, const _Bool maximize )
+{
+  ull *next;
+  CALLOC( next, ull*, size, sizeof( ull ), "next" );
+
+  /* Squaring costs size^3 per bit of the exponent, while multiplying the
+   * vector costs size^2 per step. */
+  uint exponent_bits = 0;
+  while ( ( exponent >> exponent_bits ) != 0 ) {
+    exponent_bits++;
+  }
+  if ( exponent <= (ull)size * exponent_bits ) {
+    for ( ; exponent > 0; exponent-- ) {
+      multiplyOffsetVector( next, v, m, size, maximize );
+      memcpy( v, next, size * sizeof( ull ) );
+    }
+    free( next );
+    return;
+  }
+
+  ull *power, *square;
+  MALLOC( power, ull*, size * size * sizeof( ull ), "power" );
+  MALLOC( square, ull*, size * size * sizeof( ull ), "square" );
+  memcpy( power, m, size * size * sizeof( ull ) );
+  while ( exponent > 0 ) {
+    if ( exponent & 1 ) {
+      multiplyOffsetVector( next, v, power, size, maximize );
+      memcpy( v, next, size * sizeof( ull ) );
+    }
+    exponent >>= 1;
+    if ( exponent > 0 ) {
+      multiplyOffsetMatrices( square, power, power, size, maximize );
+      ull * const tmp = power;
+      power = square;
+      square = tmp;
+    }
+  }
+  free( power );
+  free( square );
+  free( next );
+}
+
+
+/* Computes the BCET, WCET and offset bounds for the given loop when starting from
+ * the given offset range.
+ *
+ * After peeling off the first iteration (like analyze_loop_graph_tracking),
+ * one iteration is analyzed separately for each reachable start offset.
+ * Its WCET (BCET) leads from that offset to each of its end offsets, which
+ * gives a max-plus (min-plus) matrix over the reachable TDMA offsets.
+ * Raising it to the number of remaining iterations bounds the loop without
+ * any solver. If more than MAX_PLUS_MAXIMUM_OFFSETS offsets are reachable,
+ * the loop is analyzed by analyze_loop_graph_tracking instead.
+ * With explicit times only the worst-case (best-case) end time is used as
+ * the end offset in the WCET (BCET) matrix.
+ *
+ * This function should not be called directly, only through its wrapper 'analyze_loop'. */
+static combined_result analyze_loop_max_plus( const loop * const lp,
+    const procedure * const proc, const uint loop_context, const offset_data start_offsets )
+{
+  DSTART( "analyze_loop_max_plus" );
+  assert( lp && proc && isOffsetDataValid( &start_offsets ) &&
+          "Invalid arguments!" );
+
+  DOUT( "Starting max-plus analysis for loop %u.%u (loopbound %u) "
+      "with offsets %s\n", proc->pid, lp->lpid, lp->loopbound,
+      getOffsetDataString( &start_offsets ) );
+
+  const uint tdma_interval = getOffsetDataMaxOffset() + 1;
+  const _Bool haveExplicitTime = currentOffsetRepresentation == OFFSET_DATA_TYPE_TIME_RANGE;
+
+  // Peel off the first iteration, it runs in a different context
+  combined_result result;
+  if ( lp->loopbound <= 0 ) {
+    result.bcet = 0;
+    result.wcet = 0;
+    result.offsets = start_offsets;
+    DRETURN( result );
+  }
+  const uint first_context = getInnerLoopContext( lp, loop_context, 1 );
+  result = analyze_single_loop_iteration( lp, proc, first_context, start_offsets );
+  DOUT( "Analyzed first iteration: BCET %llu, WCET %llu, offsets %s "
+      "(context %u)\n", result.bcet, result.wcet,
+      getOffsetDataString( &result.offsets ), first_context );
+  if ( lp->loopbound == 1 ) {
+    DRETURN( result );
+  }
+
+  /* The matrices only range over the offsets which can be reached, each of
+   * which gets a compressed index in the order in which it is reached. */
+  const uint max_size = MIN( tdma_interval, MAX_PLUS_MAXIMUM_OFFSETS );
+  uint *index, *worklist;
+  combined_result *rows, *wc_rows;
+  MALLOC( index, uint*, tdma_interval * sizeof( uint ), "index" );
+  CALLOC( worklist, uint*, tdma_interval, sizeof( uint ), "worklist" );
+  CALLOC( rows, combined_result*, max_size, sizeof( combined_result ), "rows" );
+  CALLOC( wc_rows, combined_result*, max_size, sizeof( combined_result ), "wc_rows" );
+  memset( index, 0xff, tdma_interval * sizeof( uint ) );
+  uint size = 0;
+  uint worklist_size = 0;
+  #define OFFSET_NOT_REACHED UINT_MAX
+  #define REACH_OFFSET( offset ) \
+    if ( index[offset] == OFFSET_NOT_REACHED ) { \
+      index[offset] = size++; \
+      worklist[worklist_size++] = offset; \
+    }
+
+  uint i;
+  if ( haveExplicitTime ) {
+    REACH_OFFSET( result.offsets.content.time_range.bcet_time % tdma_interval );
+    REACH_OFFSET( result.offsets.content.time_range.wcet_time % tdma_interval );
+  } else {
+    ITERATE_OFFSETS( result.offsets, o,
+      REACH_OFFSET( o );
+    );
+  }
+
+  /* The alternative of starting each iteration at offset zero, see
+   * analyze_loop_graph_tracking. It only bounds the WCET, so the BCET matrix
+   * always follows the unaligned iterations. */
+  const uint inner_context = getInnerLoopContext( lp, loop_context, 0 );
+  combined_result aligned_result;
+  if ( tryPenalizedAlignment ) {
+    const offset_data zero_offsets = createOffsetDataFromOffsetBounds(
+                                       currentOffsetRepresentation, 0, 0 );
+    aligned_result = analyze_single_loop_iteration( lp, proc, inner_context,
+                                                    zero_offsets );
+    aligned_result.wcet += startAlign( 0 );
+    if ( isOffsetDataMaximal( &aligned_result.offsets ) ) {
+      aligned_result.wcet += endAlign( aligned_result.wcet );
+      aligned_result.offsets = createOffsetDataFromOffsetBounds(
+                                 currentOffsetRepresentation, 0, 0 );
+    }
+  }
+
+  // Analyze the rows of all offsets which can be reached
+  while ( worklist_size > 0 && size <= max_size ) {
+    const uint offset = worklist[--worklist_size];
+
+    const combined_result row = analyze_single_loop_iteration( lp, proc,
+        inner_context, createOffsetDataFromOffsetBounds(
+          currentOffsetRepresentation, offset, offset ) );
+    const combined_result wc_row = ( tryPenalizedAlignment &&
+        aligned_result.wcet < row.wcet ? aligned_result : row );
+    DOUT( "Iteration from offset %u: BCET %llu, WCET %llu, offsets %s / %s\n",
+        offset, row.bcet, wc_row.wcet, getOffsetDataString( &row.offsets ),
+        getOffsetDataString( &wc_row.offsets ) );
+    rows[index[offset]] = row;
+    wc_rows[index[offset]] = wc_row;
+
+    if ( haveExplicitTime ) {
+      REACH_OFFSET( row.offsets.content.time_range.bcet_time % tdma_interval );
+      REACH_OFFSET( wc_row.offsets.content.time_range.wcet_time % tdma_interval );
+    } else {
+      ITERATE_OFFSETS( row.offsets, end,
+        REACH_OFFSET( end );
+      );
+      ITERATE_OFFSETS( wc_row.offsets, end,
+        REACH_OFFSET( end );
+      );
+    }
+  }
+  #undef REACH_OFFSET
+
+  /* Too many offsets are reachable to afford the dense matrices, graph
+   * tracking only needs memory linear in the number of edges. */
+  if ( size > max_size ) {
+    DOUT( "%u reachable offsets exceed the max-plus limit of %u, "
+          "falling back to graph tracking\n", size, max_size );
+    free( index );
+    free( worklist );
+    free( rows );
+    free( wc_rows );
+    result = analyze_loop_graph_tracking( lp, proc, loop_context,
+                                          start_offsets );
+    DRETURN( result );
+  }
+
+  // The start vectors and the iteration matrices
+  ull *wcet_vector, *bcet_vector, *wcet_matrix, *bcet_matrix;
+  MALLOC( wcet_vector, ull*, size * sizeof( ull ), "wcet_vector" );
+  MALLOC( bcet_vector, ull*, size * sizeof( ull ), "bcet_vector" );
+  MALLOC( wcet_matrix, ull*, size * size * sizeof( ull ), "wcet_matrix" );
+  MALLOC( bcet_matrix, ull*, size * size * sizeof( ull ), "bcet_matrix" );
+  memset( wcet_vector, 0xff, size * sizeof( ull ) );
+  memset( bcet_vector, 0xff, size * sizeof( ull ) );
+  memset( wcet_matrix, 0xff, size * size * sizeof( ull ) );
+  memset( bcet_matrix, 0xff, size * size * sizeof( ull ) );
+
+  if ( haveExplicitTime ) {
+    bcet_vector[index[result.offsets.content.time_range.bcet_time % tdma_interval]] = 0;
+    wcet_vector[index[result.offsets.content.time_range.wcet_time % tdma_interval]] = 0;
+  } else {
+    ITERATE_OFFSETS( result.offsets, o,
+      bcet_vector[index[o]] = 0;
+      wcet_vector[index[o]] = 0;
+    );
+  }
+
+  for ( i = 0; i < size; i++ ) {
+    const combined_result * const row = &rows[i];
+    const combined_result * const wc_row = &wc_rows[i];
+    ull * const wcet_row = &wcet_matrix[i * size];
+    ull * const bcet_row = &bcet_matrix[i * size];
+    if ( haveExplicitTime ) {
+      const uint bc_end = row->offsets.content.time_range.bcet_time % tdma_interval;
+      const uint wc_end = wc_row->offsets.content.time_range.wcet_time % tdma_interval;
+      bcet_row[index[bc_end]] = row->bcet;
+      wcet_row[index[wc_end]] = wc_row->wcet;
+    } else {
+      ITERATE_OFFSETS( row->offsets, end,
+        bcet_row[index[end]] = row->bcet;
+      );
+      ITERATE_OFFSETS( wc_row->offsets, end,
+        wcet_row[index[end]] = wc_row->wcet;
+      );
+    }
+  }
+
+  // Bound the remaining iterations
+  const uint remaining_iterations = lp->loopbound - 1;
+  powerOffsetVector( wcet_vector, wcet_matrix, size, remaining_iterations, 1 );
+  powerOffsetVector( bcet_vector, bcet_matrix, size, remaining_iterations, 0 );
+
+  ull loop_wcet = OFFSET_MATRIX_NO_PATH;
+  ull loop_bcet = OFFSET_MATRIX_NO_PATH;
+  for ( i = 0; i < size; i++ ) {
+    loop_wcet = betterTime( loop_wcet, wcet_vector[i], 1 );
+    loop_bcet = betterTime( loop_bcet, bcet_vector[i], 0 );
+  }
+  assert( loop_wcet != OFFSET_MATRIX_NO_PATH &&
+          loop_bcet != OFFSET_MATRIX_NO_PATH && "Internal error!" );
+  result.bcet += loop_bcet;
+  result.wcet += loop_wcet;
+
+  /* The end offsets are those which are reached after the last iteration
+   * in either matrix. */
+  if ( haveExplicitTime ) {
+    result.offsets = start_offsets;
+    result.offsets.content.time_range.bcet_time += result.bcet;
+    result.offsets.content.time_range.wcet_time += result.wcet;
+  } else {
+    _Bool first = 1;
+    for ( i = 0; i < tdma_interval; i++ ) {
+      const uint j = index[i];
+      if ( j == OFFSET_NOT_REACHED || (
+             wcet_vector[j] == OFFSET_MATRIX_NO_PATH &&
+             bcet_vector[j] == OFFSET_MATRIX_NO_PATH ) ) {
+        continue;
+      }
+      if ( first ) {
+        result.offsets = createOffsetDataFromOffsetBounds(
+                           currentOffsetRepresentation, i, i );
+        first = 0;
+      } else {
+        addOffsetDataOffsetRange( &result.offsets, i, i );
+      }
+    }
+  }
+  #undef OFFSET_NOT_REACHED
+  DOUT( "Loop results: BCET %llu, WCET %llu, offsets %s\n", result.bcet,
+        result.wcet, getOffsetDataString( &result.offsets ) );
+
+  free( wcet_vector );
+  free( bcet_vector );
+  free( wcet_matrix );
+  free( bcet_matrix );
+  free( index );
+  free( worklist );
+  free( rows );
+  free( wc_rows );
+
+  assert( isResultValid( &start_offsets, &result ) && "Invalid result!" );
+  DRETURN( result );
+}
+
+
 /* Computes the BCET, WCET and offset bounds for the given loop when starting from 
  * the given offset range.
  * 
@@ -1341,6 +1763,9 @@ static combined_result analyze_loop_alignment_aware( const loop * const lp,
     case LOOP_ANALYSIS_GRAPH_TRACKING:
       result = analyze_loop_graph_tracking( lp, proc, loop_context, start_offsets );
       break;
+    case LOOP_ANALYSIS_MAX_PLUS:
+      result = analyze_loop_max_plus( lp, proc, loop_context, start_offsets );
+      break;
     default:
       assert( 0 && "Unsupported analysis method!" );
   }
@@ -1369,8 +1794,6 @@ static combined_result analyze_loop( const loop * const lp,
    * using the zero-alignment and add the appropriate alignment penalties. If this yields a
    * superior solution, then we pick that one instead of the previously computed result. */
   if ( tryPenalizedAlignment ) {
-    // TODO: The alignments may be computed for a wrong segment in case of multi-segment
-    //       schedules (see definitions of startAlign/endAlign)
     DOUT( "Attempting penalized alignment analysis\n" );
     const offset_data zero_offsets = createOffsetDataFromOffsetBounds(
                                        currentOffsetRepresentation, 0, 0 );
@@ -1400,27 +1823,14 @@ static combined_result analyze_proc_alignment_aware( const procedure * const pro
   assert( proc && isOffsetDataValid( &start_offsets ) &&
           "Invalid arguments!" );
 
-  // TODO: Implement buffering for the TIME representation
-
   /* Check whether we have already computed the requested result. */
-  combined_result **bufferLocation = NULL;
-  if ( currentOffsetRepresentation == OFFSET_DATA_TYPE_RANGE ) {
-    bufferLocation = &proc_results[proc->pid]
-      [getOffsetDataMinimumOffset( &start_offsets )]
-      [getOffsetDataMaximumOffset( &start_offsets )];
-  } else if ( currentOffsetRepresentation == OFFSET_DATA_TYPE_SET ) {
-    tdma_offset_bounds range;
-    if ( isOffsetDataRangeValue( &start_offsets, &range ) ) {
-      bufferLocation = &proc_results[proc->pid]
-        [range.lower_bound][range.upper_bound];
-    } else {
-      bufferLocation = NULL;
-    }
-  } else {
-    bufferLocation = NULL;
-  }
-  if ( bufferLocation != NULL && *bufferLocation != NULL ) {
-    DRETURN( **bufferLocation );
+  result_memo_key bufferKey;
+  ull bufferShift;
+  const _Bool buffered = getResultKey( &bufferKey, &bufferShift,
+      RESULT_KIND_PROC, proc->pid, 0, 0, &start_offsets );
+  combined_result buffered_result;
+  if ( buffered && lookupResult( &bufferKey, bufferShift, &buffered_result ) ) {
+    DRETURN( buffered_result );
   }
 
   DOUT( "Analyzing procedure %d with offsets %s\n",
@@ -1455,11 +1865,10 @@ static combined_result analyze_proc_alignment_aware( const procedure * const pro
   free( block_results );
 
   /* Insert result into result buffer. */
-  if ( bufferLocation != NULL ) {
-    assert( *bufferLocation == NULL && "Tried to overwrite buffered result!" );
-    MALLOC( *bufferLocation, combined_result*,
-        sizeof( combined_result ), "*bufferLocation" );
-    **bufferLocation = result;
+  if ( buffered ) {
+    assert( lookupResultMemo( result_buffer, &bufferKey ) == NULL &&
+            "Tried to overwrite buffered result!" );
+    storeResult( &bufferKey, bufferShift, result );
   }
 
   DOUT( "Procedure %d WCET / BCET result is %llu / %llu"
@@ -1488,8 +1897,6 @@ static combined_result analyze_proc( const procedure * const proc,
    * using the zero-alignment and add the appropriate alignment penalties. If this yields a
    * superior solution, then we pick that one instead of the previously computed result. */
   if ( tryPenalizedAlignment ) {
-    // TODO: The alignments may be computed for a wrong segment in case of multi-segment
-    //       schedules (see definitions of startAlign/endAlign)
     const offset_data zero_offsets = createOffsetDataFromOffsetBounds(
                                        currentOffsetRepresentation, 0, 0 );
     combined_result pal_result = analyze_proc_alignment_aware( proc, zero_offsets );
@@ -1535,8 +1942,12 @@ void compute_bus_ET_MSC_alignment( MSC *msc, const char *tdma_bus_schedule_file,
 
   /* Set the global TDMA bus schedule */
   setSchedule( tdma_bus_schedule_file );
-  // TODO: This won't work for segmented schedules
-  setOffsetDataMaxOffset( getCoreSchedule( 0, 0 )->interval - 1 );
+
+  /* The offsets are taken modulo the schedule period. Schedules without a
+   * period bound the latencies over all times, so there only is a single
+   * offset. */
+  const uint tdma_interval = MAX( getScheduleInterval(), 1 );
+  setOffsetDataMaxOffset( tdma_interval - 1 );
 
   /* Set the analysis options to use. */
   currentLoopAnalysisType     = analysis_type;
@@ -1560,9 +1971,10 @@ void compute_bus_ET_MSC_alignment( MSC *msc, const char *tdma_bus_schedule_file,
     cur_task = &( msc->taskList[k] );
     ncore = get_core( cur_task );
     procedure * const task_main = cur_task->main_copy;
+    initScheduleLatencyBounds();
 
     /* Initialize the result buffers. */
-    initResultBuffers( cur_task );
+    initResultBuffers();
 
     /* First get the earliest and latest start time of the current task. */
     const ull earliest_start = get_earliest_task_start_time( cur_task, ncore );
@@ -1589,7 +2001,7 @@ void compute_bus_ET_MSC_alignment( MSC *msc, const char *tdma_bus_schedule_file,
     update_succ_task_latest_start_time( msc, cur_task );
 
     /* Free the result buffers. */
-    freeResultBuffers( cur_task );
+    freeResultBuffers();
 
     /* Measure time needed for single-task analysis. */
     const milliseconds analysis_end = getmsecs();
@@ -27,7 +27,10 @@ enum LoopAnalysisType {
   /* Computes globally valid alignment bounds for the loop header. */
   LOOP_ANALYSIS_GLOBAL_CONVERGENCE,
   /* Tracks the development of the alignment bounds in a graph. */
-  LOOP_ANALYSIS_GRAPH_TRACKING
+  LOOP_ANALYSIS_GRAPH_TRACKING,
+  /* Summarizes an iteration per start offset in a max-plus (min-plus) matrix
+   * and raises it to the loop bound. */
+  LOOP_ANALYSIS_MAX_PLUS
 };
 
 
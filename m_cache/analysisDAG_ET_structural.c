@@ -0,0 +1,561 @@
+// Include standard library headers
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <math.h>
+
+// Include local library headers
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <debugmacros/debugmacros.h>
+
+// Include local headers
+#include "analysisDAG_ET_structural.h"
+#include "analysisDAG_common.h"
+#include "block.h"
+#include "busSchedule.h"
+#include "dump.h"
+#include "handler.h"
+#include "wcrt/cycle_time.h"
+
+
+// Forward declarations of static functions
+static void computeET_block( block* bb, procedure* proc, loop* cur_lp );
+static void computeET_proc( procedure* proc, const ull *start_times );
+
+
+// The total cycles used for aligning the loops to TDMA slots during the WCET analysis
+static ull totalAlignCost = 0;
+
+// The number of loops which are currently preprocessed. The times inside these
+// are relative to an aligned loop start, so only their TDMA offsets are known.
+static uint preprocessedLoops = 0;
+
+
+/***********************************************************************/
+/* sudiptac:: This part of the code is only used for the WCET and
+ * BCET analysis in presence shared data bus. All procedures in the
+ * following is used only for this purpose and therefore can safely
+ * be ignored for analysis which does not include shared data bus
+ */
+/***********************************************************************/
+
+/* sudiptac:: Determines BCET and WCET of a procedure in presence of shared
+ * data bus. We assume the shared cache analysis at this point and CHMC
+ * classification for every instruction has already been computed. We
+ * also assume a statically generated TDMA bus schedule and the
+ * worst/best case starting time of the procedure since in presence of
+ * shared data bus worst/best case execution time of a procedure/loop
+ * depends on its starting time */
+
+/* All times are indexed by the scenario (ACCESS_SCENARIO_BCET/_WCET). Both
+ * scenarios walk the same blocks and contexts in the same order, so they are
+ * computed together. */
+
+
+/* This sets the earliest (BCET) or latest (WCET) starting time of a block.
+ * (Context-aware)
+ */
+static void set_start_time_opt( block* bb, procedure* proc, uint context,
+                                enum AccessScenario scenario )
+{
+  DSTART( "set_start_time_opt" );
+  assert( proc && bb );
+  assert( ( scenario == ACCESS_SCENARIO_BCET || bb->num_incoming > 0 ) &&
+      "Invalid internal data!" );
+
+  ull start = 0;
+
+  int i;
+  for ( i = 0; i < bb->num_incoming; i++ ) {
+
+    block * const pred_bb = proc->bblist[bb->incoming[i]];
+    assert( pred_bb && "Missing basic block!" );
+
+    /* Determine the predecessors' earliest / latest finish time */
+    const ull pred_fin = getContextValue( &pred_bb->fin_opt[scenario],
+                                          context );
+    if ( scenario == ACCESS_SCENARIO_WCET ) {
+      start = MAX( start, pred_fin );
+    } else if ( i == 0 ) {
+      start = pred_fin;
+    } else {
+      start = MIN( start, pred_fin );
+    }
+  }
+
+  /* Now set the starting time of this block to be the earliest / latest
+   * finish time of predecessors block */
+  setContextValue( &bb->start_opt[scenario], context, start );
+
+  DOUT( "Setting %s start of bb %d (context %u) = %Lu\n",
+      scenario == ACCESS_SCENARIO_WCET ? "max" : "min", bb->bbid, context,
+      start );
+  DEND();
+}
+
+
+/* Returns the BCET or WCET of a loop, after loop BCETs and WCETs have been
+ * computed for all CHMC contexts. This method summarises the contexts'
+ * BCETs/WCETs, adds the bus alignment offsets to the WCET and returns the
+ * final loop BCET/WCET.
+ *
+ * 'enclosing_loop_context' should be the context of the surrounding loop,
+ * for which the BCET/WCET should be obtained.
+ * 'first_call' should indicate whether this is the first call to this
+ * method for loop 'lp' during the current analysis.
+ * */
+static ull getLoopET( const loop *lp, const int enclosing_loop_context,
+                      const _Bool first_call, enum AccessScenario scenario )
+{
+  DSTART( "getLoopET" );
+
+  /* Each CHMC index is of the form
+   *
+   * i = x_{head->num_chmc} x_{head->num_chmc - 1} ... x_1
+   *
+   * where each x is a binary digit. We are interested in a bound
+   * on the BCET/WCET of the function in its first and in the succeeding
+   * iterations. We take the least 'lp->level - 1' bits from the
+   * enclosing loop context and add a '0' to get the BCET/WCET for the
+   * first iteration and a '1' to get the BCET/WCET for the successive
+   * iterations.
+   *
+   * For further information about CHMC contexts see header.h:num_chmc
+   */
+
+  const int index_first_iteration = getInnerLoopContext( lp, enclosing_loop_context, 1 );
+  const int index_next_iterations = getInnerLoopContext( lp, enclosing_loop_context, 0 );
+
+  const context_table_t * const loop_et =
+    ( scenario == ACCESS_SCENARIO_WCET ? &lp->wcet_opt : &lp->bcet_opt );
+  const ull firstIterationET =
+    getContextValue( loop_et, index_first_iteration );
+  const ull nextIterationsET =
+    getContextValue( loop_et, index_next_iterations );
+
+  if ( lp->loopbound >= 1 ) {
+    const ull execution_cost = firstIterationET
+          + ( nextIterationsET * ( lp->loopbound - 1 ) );
+
+    // For the BCET analysis we must not consider any alignment penalty
+    if ( scenario == ACCESS_SCENARIO_BCET ) {
+      DRETURN( execution_cost );
+    }
+
+    const ull alignment_cost = startAlign( 0 ) + endAlign( firstIterationET )
+        + ( endAlign( nextIterationsET ) * ( lp->loopbound - 1 ) );
+    DOUT( "Accounting WCET %llu, alignment cost %llu to loop %u.%u",
+        execution_cost, alignment_cost, lp->pid, lp->lpid );
+
+    /* Add alignment cost to summarized alignment cost only on first call. */
+    if ( first_call ) {
+      totalAlignCost += alignment_cost;
+    }
+
+    DRETURN( execution_cost + alignment_cost );
+  } else {
+    DRETURN( 0 );
+  }
+
+}
+
+/* Preprocess one loop for optimized bus aware BCET/WCET calculation */
+/* This takes care of the alignments of loop at the beginning and at the
+ * end */
+static void preprocess_one_loop( loop* lp, procedure* proc )
+{
+  DSTART( "preprocess_one_loop" );
+
+  /* We can assume the start time to be always zero */
+  const ull start_time = 0;
+
+  /* Compute only once */
+  if ( getContextValue( &lp->bcet_opt, 0 ) &&
+       getContextValue( &lp->wcet_opt, 0 ) )
+    DRETURN();
+
+  /* The heads of nested loops have the most contexts among the blocks */
+  int num_contexts = 0;
+  int i, s;
+  for ( i = 0; i < lp->num_topo; i++ ) {
+    num_contexts = MAX( num_contexts, lp->topo[i]->num_chmc );
+  }
+  uint *max_fin[NUM_ACCESS_SCENARIOS];
+  for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+    CALLOC( max_fin[s], uint*, num_contexts, sizeof( uint ), "max_fin" );
+  }
+
+  DOUT( "Visiting loop = %d.%d.0x%x\n", lp->pid, lp->lpid, (uintptr_t)lp );
+  preprocessedLoops++;
+
+  /* Traverse all the blocks in topological order. Topological
+   * order does not assume internal loops. Thus all internal
+   * loops are considered to be black boxes */
+  for ( i = lp->num_topo - 1; i >= 0; i-- ) {
+    block *bb = lp->topo[i];
+    /* bb cannot be empty */
+    assert(bb);
+
+    for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+      memset( max_fin[s], 0, num_contexts * sizeof( uint ) );
+    }
+
+    /* Traverse over all the CHMC-s of this basic block */
+    int j;
+    for ( j = 0; j < bb->num_chmc; j++ ) {
+
+      /* First of all, we have to determine the best/worst-case starting time
+       * in the current context. This time is needed in all cases, also when
+       * the current block 'bb' is a nested loop head, because there may be
+       * other instructions in the loop that precede the nested head. */
+      for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+        if ( i == lp->num_topo - 1 ) {
+          setContextValue( &bb->start_opt[s], j, start_time );
+        } else {
+          set_start_time_opt( bb, proc, j, s );
+        }
+      }
+
+      /* Check whether this basic block is the header of some other
+       * loop */
+      loop * const inlp = check_loop( bb, proc );
+      if ( inlp && i != lp->num_topo - 1 ) {
+
+        /* Backup the start times of the context 'j', because the analysis of
+         * the inner loop will overwrite them. */
+        ull original_start_time[NUM_ACCESS_SCENARIOS];
+        for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+          original_start_time[s] = getContextValue( &bb->start_opt[s], j );
+        }
+        assert( inlp->level == lp->level + 1 && "Invalid internal data!" );
+
+        /* As this inner loop header has twice the amount of CHMC contexts compared to
+         * the outer loop's blocks, it is sufficient to compute the bb->fin_opt values
+         * for the contexts j < bb->num_chmc / 2, because all others are contexts which
+         * belong to the inner loop. */
+        if ( j < bb->num_chmc / 2 ) {
+          preprocess_one_loop( inlp, proc );
+          for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+            setContextValue( &bb->fin_opt[s], j,
+                original_start_time[s] + getLoopET( inlp, j, 1, s ) );
+          }
+        }
+
+      } else {
+
+        ull bb_cost[NUM_ACCESS_SCENARIOS] = { 0, 0 };
+        ull bb_start[NUM_ACCESS_SCENARIOS];
+        const unsigned char *acc_types[NUM_ACCESS_SCENARIOS];
+        for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+          bb_start[s] = getContextValue( &bb->start_opt[s], j );
+          acc_types[s] = getAccessTypes( bb, j, s );
+        }
+
+        int k;
+        for ( k = 0; k < bb->num_instr; k++ ) {
+
+          instr * const inst = bb->instrlist[k];
+          assert(inst);
+
+          for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+            /* First handle instruction cache access time */
+            const acc_type acc_t = acc_types[s][k];
+            bb_cost[s] += determineOffsetLatency( bb, bb_start[s] + bb_cost[s],
+                                                  acc_t, s );
+
+            /* Then add cost for executing the instruction. */
+            bb_cost[s] += getInstructionTime( inst, s );
+          }
+
+          /* Handle procedure call instruction */
+          if ( IS_CALL(inst) ) {
+            procedure * const callee = inst->callee;
+
+            /* For ignoring library calls */
+            if ( callee ) {
+              /* Compute the BCET and WCET of the callee procedure here.
+               * We dont handle recursive procedure call chain */
+              ull callee_start[NUM_ACCESS_SCENARIOS];
+              for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+                callee_start[s] = bb_start[s] + bb_cost[s];
+              }
+              computeET_proc( callee, callee_start );
+              for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+                bb_cost[s] += callee->running_cost[s];
+              }
+            }
+          }
+        }
+
+        /* Set finish time of the basic block */
+        for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+          setContextValue( &bb->fin_opt[s], j, bb_start[s] + bb_cost[s] );
+        }
+      }
+
+      /* Set max finish time */
+      for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+        max_fin[s][j] = MAX( max_fin[s][j],
+                             getContextValue( &bb->fin_opt[s], j ) );
+      }
+    }
+  }
+
+  int j;
+  for ( j = 0; j < lp->loophead->num_chmc; j++ ) {
+    setContextValue( &lp->bcet_opt, j, max_fin[ACCESS_SCENARIO_BCET][j] - 1 );
+    setContextValue( &lp->wcet_opt, j, max_fin[ACCESS_SCENARIO_WCET][j] - 1 );
+    DOUT( "BCET / WCET of loop (%d.%d.0x%x)[%d] = %Lu / %Lu\n", lp->pid,
+        lp->lpid, (unsigned int)(uintptr_t) lp, j,
+        getContextValue( &lp->bcet_opt, j ),
+        getContextValue( &lp->wcet_opt, j ) );
+  }
+  for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+    free( max_fin[s] );
+  }
+  preprocessedLoops--;
+
+  DEND();
+}
+
+/* Preprocess each loop for optimized bus aware BCET/WCET calculation */
+static void preprocess_all_loops( procedure* proc )
+{
+  /* Preprocess loops....in reverse topological order i.e. in reverse
+   * order of detection */
+  int i;
+  for ( i = proc->num_loops - 1; i >= 0; i-- ) {
+    /* Preprocess only outermost loop, inner ones will be processed
+     * recursively */
+    if ( proc->loops[i]->level == 0 )
+      preprocess_one_loop( proc->loops[i], proc );
+  }
+}
+
+/* Compute best and worst case finish time and cost of a block */
+static void computeET_block( block* bb, procedure* proc, loop* cur_lp )
+{
+  DSTART( "computeET_block" );
+
+  const uint proc_body_context = 0;
+  int i, s;
+
+  /* Check whether the block is some header of a loop structure.
+   * In that case do separate analysis of the loop */
+  /* Exception is when we are currently in the process of analyzing
+   * the same loop */
+  loop* inlp = check_loop( bb, proc );
+  if ( inlp && ( !cur_lp || ( inlp->lpid != cur_lp->lpid ) ) ) {
+
+    DOUT( "Block represents inner loop!\n" );
+    for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+      bb->finish_time[s] = bb->start_time[s] +
+        getLoopET( inlp, proc_body_context, 0, s );
+    }
+
+  /* It's not a loop. Go through all the instructions and
+   * compute the BCET and WCET of the block */
+  } else {
+    ull bb_cost[NUM_ACCESS_SCENARIOS] = { 0, 0 };
+    const unsigned char *acc_types[NUM_ACCESS_SCENARIOS];
+    for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+      acc_types[s] = getAccessTypes( bb, proc_body_context, s );
+    }
+
+    for ( i = 0; i < bb->num_instr; i++ ) {
+      instr* inst = bb->instrlist[i];
+      assert(inst);
+
+      for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+        /* First handle instruction cache access. */
+        const acc_type acc_t = acc_types[s][i];
+        const ull access_time = bb->start_time[s] + bb_cost[s];
+        bb_cost[s] += ( preprocessedLoops > 0
+          ? determineOffsetLatency( bb, access_time, acc_t, s )
+          : determine_latency( bb, access_time, acc_t, NULL, s ) );
+
+        /* Then add cost for executing the instruction. */
+        bb_cost[s] += getInstructionTime( inst, s );
+      }
+
+      /* Handle procedure call instruction */
+      if ( IS_CALL(inst) ) {
+        procedure * const callee = inst->callee;
+
+        /* For ignoring library calls */
+        if ( callee ) {
+          DOUT( "Block calls internal function %u\n", callee->pid );
+          /* Compute the BCET and WCET of the callee procedure here.
+           * We dont handle recursive procedure call chain */
+          ull callee_start[NUM_ACCESS_SCENARIOS];
+          for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+            callee_start[s] = bb->start_time[s] + bb_cost[s];
+          }
+          computeET_proc( callee, callee_start );
+          for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+            bb_cost[s] += callee->running_cost[s];
+          }
+        }
+      }
+    }
+    /* The accumulated costs are computed. Now set the earliest and
+     * latest finish time of this block */
+    for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+      bb->finish_time[s] = bb->start_time[s] + bb_cost[s];
+    }
+  }
+
+  DOUT( "Accounting BCET / WCET %llu / %llu for block 0x%x - 0x%x\n",
+      bb->finish_time[ACCESS_SCENARIO_BCET] -
+        bb->start_time[ACCESS_SCENARIO_BCET],
+      bb->finish_time[ACCESS_SCENARIO_WCET] -
+        bb->start_time[ACCESS_SCENARIO_WCET],
+      bb->instrlist[0]->addr, bb->instrlist[bb->num_instr - 1]->addr );
+  DEND();
+}
+
+static void computeET_proc( procedure* proc, const ull *start_times )
+{
+  DSTART( "computeET_proc" );
+
+  /* Preprocess all the loops for optimized BCET/WCET calculation */
+  /********CAUTION*******/
+  preprocess_all_loops( proc );
+
+  /* Reset all timing information */
+  reset_timestamps( proc, start_times );
+
+  /* Recursively compute the finish times and BCET/WCET of each
+   * predecessors first */
+  int i, s;
+  for ( i = proc->num_topo - 1; i >= 0; i-- ) {
+    block* bb = proc->topo[i];
+    assert(bb);
+
+    /* If this is the first block of the procedure then
+     * set the start time of this block to be the same
+     * with the start time of the procedure itself */
+    for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+      if ( i == proc->num_topo - 1 )
+        bb->start_time[s] = start_times[s];
+      else
+        set_start_time( bb, proc, s );
+    }
+
+    DOUT( "Block %u starts at times %llu / %llu\n", bb->bbid,
+        bb->start_time[ACCESS_SCENARIO_BCET],
+        bb->start_time[ACCESS_SCENARIO_WCET] );
+    computeET_block( bb, proc, NULL );
+  }
+
+  /* Now calculate the final BCET and WCET */
+  ull min_f_time = 0;
+  ull max_f_time = 0;
+  for ( i = 0; i < proc->num_topo; i++ ) {
+    assert(proc->topo[i]);
+
+    if ( proc->topo[i]->num_outgoing > 0 )
+      break;
+
+    const ull bc_f_time = proc->topo[i]->finish_time[ACCESS_SCENARIO_BCET];
+    if ( i == 0 ) {
+      min_f_time = bc_f_time;
+    } else {
+      min_f_time = MIN( min_f_time, bc_f_time );
+    }
+    max_f_time = MAX( max_f_time,
+                      proc->topo[i]->finish_time[ACCESS_SCENARIO_WCET] );
+  }
+
+  proc->running_finish_time[ACCESS_SCENARIO_BCET] = min_f_time;
+  proc->running_finish_time[ACCESS_SCENARIO_WCET] = max_f_time;
+  for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+    proc->running_cost[s] = proc->running_finish_time[s] - start_times[s];
+  }
+
+  DOUT( "Set best / worst case cost of the procedure %d = %Lu / %Lu\n",
+      proc->pid, proc->running_cost[ACCESS_SCENARIO_BCET],
+      proc->running_cost[ACCESS_SCENARIO_WCET] );
+  DEND();
+}
+
+/* Analyze best and worst case execution time of all the tasks inside
+ * a MSC. The MSC is given by the argument */
+void compute_bus_ET_MSC_structural( MSC *msc, const char *tdma_bus_schedule_file )
+{
+  DSTART( "compute_bus_ET_MSC_structural" );
+
+  /* Set the global TDMA bus schedule */
+  setSchedule( tdma_bus_schedule_file );
+
+  /* Reset the earliest/latest time of all cores */
+  memset( earliest_core_time, 0, num_core * sizeof(ull) );
+  memset( latest_core_time, 0, num_core * sizeof(ull) );
+  /* reset latest time of all tasks */
+  reset_all_task( msc );
+
+  int k;
+  for ( k = 0; k < msc->num_task; k++ ) {
+
+    DOUT( "Analyzing Task BCET/WCET %s......\n", msc->taskList[k].task_name );
+    const milliseconds analysis_start = getmsecs();
+
+    totalAlignCost = 0;
+
+    /* Get needed inputs. */
+    cur_task = &( msc->taskList[k] );
+    ncore = get_core( cur_task );
+    procedure * const task_main = cur_task->main_copy;
+    initScheduleLatencyBounds();
+
+    /* First get the earliest and latest start time of the current task. */
+    ull start_times[NUM_ACCESS_SCENARIOS];
+    start_times[ACCESS_SCENARIO_BCET] =
+      get_earliest_task_start_time( cur_task, ncore );
+    start_times[ACCESS_SCENARIO_WCET] =
+      get_latest_task_start_time( cur_task, ncore );
+
+    /* Then compute and set the best and worst case cost of this task */
+    computeET_proc( task_main, start_times );
+    cur_task->bcet = task_main->running_cost[ACCESS_SCENARIO_BCET];
+    cur_task->wcet = task_main->running_cost[ACCESS_SCENARIO_WCET];
+
+    /* Now update the earliest/latest starting time in this core */
+    earliest_core_time[ncore] = start_times[ACCESS_SCENARIO_BCET] +
+                                cur_task->bcet;
+    latest_core_time[ncore] = start_times[ACCESS_SCENARIO_WCET] +
+                              cur_task->wcet;
+
+    /* Since the interference file for a MSC was dumped in topological
+     * order and read back in the same order we are assured of the fact
+     * that we analyze the tasks inside a MSC only after all of its
+     * predecessors have been analyzed. Thus After analyzing one task
+     * update all its successor tasks' earliest and latest time */
+    update_succ_task_earliest_start_time( msc, cur_task );
+    update_succ_task_latest_start_time( msc, cur_task );
+
+    /* Measure time needed for single-task analysis. */
+    const milliseconds analysis_end = getmsecs();
+    cur_task->bcet_analysis_time = analysis_end - analysis_start;
+    cur_task->wcet_analysis_time = analysis_end - analysis_start;
+
+    DOUT( "**************************************************************\n" );
+    DOUT( "Earliest / Latest start time of the program = %Lu / %Lu cycles\n",
+        start_times[ACCESS_SCENARIO_BCET], start_times[ACCESS_SCENARIO_WCET] );
+    DOUT( "Earliest / Latest finish time of the task = %Lu / %Lu cycles\n",
+        task_main->running_finish_time[ACCESS_SCENARIO_BCET],
+        task_main->running_finish_time[ACCESS_SCENARIO_WCET] );
+    DOUT( "BCET / WCET of the task %s shared bus = %Lu / %Lu cycles\n",
+        g_shared_bus ? "with" : "without", cur_task->bcet, cur_task->wcet );
+    DOUT( "Final alignment cost in analysis = %llu (%llu%%)\n", totalAlignCost,
+        totalAlignCost * 100 / cur_task->wcet );
+    DASSERT( totalAlignCost < cur_task->wcet && "Invalid alignment cost!" );
+    DOUT( "**************************************************************\n\n" );
+  }
+
+  DEND();
+}
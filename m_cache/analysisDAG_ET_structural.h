@@ -1,15 +1,16 @@
 /*! This is a header file of the Chronos timing analyzer. */
 
 /*
- * DAG-based WCET analysis functions.
+ * DAG-based BCET and WCET analysis functions.
  *
  * The functions in this file use the approach published in the SCOPES paper,
  * which means that they analyse the program from the innermost to the outermost
- * loops, assuming a fixed bus alignment of the loop header.
+ * loops, assuming a fixed bus alignment of the loop header. The BCET and the
+ * WCET are computed together in a single traversal.
  */
 
-#ifndef __CHRONOS_ANALYSIS_DAG_WCET_STRUCTURAL_H
-#define __CHRONOS_ANALYSIS_DAG_WCET_STRUCTURAL_H
+#ifndef __CHRONOS_ANALYSIS_DAG_ET_STRUCTURAL_H
+#define __CHRONOS_ANALYSIS_DAG_ET_STRUCTURAL_H
 
 #include "header.h"
 
@@ -24,9 +25,9 @@
 // ######### Function declarations  ###########
 
 
-/* Analyze worst case execution time of all the tasks inside 
+/* Analyze best and worst case execution time of all the tasks inside
  * a MSC. The MSC is given by the argument */
-void compute_bus_WCET_MSC_structural(MSC *msc, const char *tdma_bus_schedule_file);
+void compute_bus_ET_MSC_structural(MSC *msc, const char *tdma_bus_schedule_file);
 
 
 #endif
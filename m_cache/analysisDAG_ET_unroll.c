@@ -0,0 +1,362 @@
+// Include standard library headers
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+// Include local library headers
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <debugmacros/debugmacros.h>
+
+// Include local headers
+#include "analysisDAG_ET_unroll.h"
+#include "analysisDAG_common.h"
+#include "busSchedule.h"
+#include "dump.h"
+#include "wcrt/cycle_time.h"
+
+
+// ######### Macros #########
+
+
+/* Executes the statements for each scenario 'scenario_variable' which is
+ * still analyzed. */
+#define ITERATE_ACTIVE_SCENARIOS( scenario_variable, loop_body_stmts ) \
+  { \
+    for ( scenario_variable = 0; scenario_variable < NUM_ACCESS_SCENARIOS; \
+          scenario_variable++ ) { \
+      if ( activeScenarios[scenario_variable] ) { \
+        loop_body_stmts \
+      } \
+    } \
+  }
+
+
+// Forward declarations of static functions
+static void computeET_loop( loop* lp, procedure* proc, uint context );
+static void computeET_block( block* bb, procedure* proc, loop* cur_lp, uint context );
+static void computeET_proc( procedure* proc, const ull *start_times );
+
+
+/* The scenarios which are analyzed. A scenario is removed while the
+ * remaining iterations of a loop are skipped for it, see skipLoopPeriods. */
+static _Bool activeScenarios[NUM_ACCESS_SCENARIOS];
+
+
+/***********************************************************************/
+/* sudiptac:: This part of the code is only used for the WCET and
+ * BCET analysis in presence shared data bus. All procedures in the
+ * following is used only for this purpose and therefore can safely
+ * be ignored for analysis which does not include shared data bus
+ */
+/***********************************************************************/
+
+/* sudiptac:: Determines BCET and WCET of a procedure in presence of shared
+ * data bus. We assume the shared cache analysis at this point and CHMC
+ * classification for every instruction has already been computed. We
+ * also assume a statically generated TDMA bus schedule and the
+ * worst/best case starting time of the procedure since in presence of
+ * shared data bus worst/best case execution time of a procedure/loop
+ * depends on its starting time */
+
+/* All times are indexed by the scenario (ACCESS_SCENARIO_BCET/_WCET). Both
+ * scenarios walk the same blocks in the same order, so they are computed
+ * together. The times of a scenario which is not active are left as they
+ * are. */
+
+
+/* Computes the earliest and latest finish time and the best and worst case
+ * cost of a loop. This procedure fully unrolls the loop virtually during
+ * computation.
+ */
+static void computeET_loop( loop* lp, procedure* proc, uint context )
+{
+  DSTART( "computeET_loop" );
+  DOUT( "Analyzing loop %u.%u in context %u with start times %llu / %llu\n",
+      lp->pid, lp->lpid, context,
+      lp->loophead->start_time[ACCESS_SCENARIO_BCET],
+      lp->loophead->start_time[ACCESS_SCENARIO_WCET] );
+  assert( lp && proc && lp->loopsink );
+
+  /* For computing bcet/wcet of the loop it must be visited
+   * multiple times equal to the loop bound */
+  int i, j, s;
+  loop_period * const period = createLoopPeriod( lp, proc );
+  for ( i = 0; i < lp->loopbound; i++ ) {
+    /* See header.h:num_chmc for further details about CHMC contexts. */
+    const uint inner_context = getInnerLoopContext( lp, context, i == 0 );
+
+    /* Go through the blocks in topological order */
+    for ( j = lp->num_topo - 1; j >= 0; j-- ) {
+      block * const bb = lp->topo[j];
+      assert(bb);
+
+      ITERATE_ACTIVE_SCENARIOS( s,
+        /* Set start time for loop header at first iteration. */
+        if ( bb->bbid == lp->loophead->bbid && i == 0 ) {
+          set_start_time( bb, proc, s );
+
+        /* Set start time for loop header at successive iterations. */
+        } else if ( bb->bbid == lp->loophead->bbid ) {
+          bb->start_time[s] = MAX( lp->loopsink->finish_time[s],
+                                   bb->start_time[s] );
+
+        /* Set start time for a block inside the loop. */
+        } else {
+          set_start_time( bb, proc, s );
+        }
+      );
+
+      computeET_block( bb, proc, lp, inner_context );
+    }
+
+    ITERATE_ACTIVE_SCENARIOS( s,
+      assert( lp->loopsink->finish_time[s] >= lp->loophead->start_time[s] &&
+          "Computed negative loop runtime!" );
+    );
+    DOUT( "Setting loop %u.%u iteration %d finish times = %llu / %llu "
+        "(context %u)\n", lp->pid, lp->lpid, i,
+        lp->loopsink->finish_time[ACCESS_SCENARIO_BCET],
+        lp->loopsink->finish_time[ACCESS_SCENARIO_WCET], inner_context );
+
+    /* Skip the iterations which repeat earlier ones. */
+    if ( period ) {
+      i += skipLoopPeriods( period, i, activeScenarios );
+    }
+  }
+  finishLoopPeriod( period, activeScenarios );
+
+  /* TODO: The execution time of the loop header, after the 'loopbound' iterations,
+   *       is not accounted for in any of the DAG-based analyses. If this is fixed,
+   *       then fix it in all analyses. */
+
+  ITERATE_ACTIVE_SCENARIOS( s,
+    /* Carry over the loop BCET/WCET to the loop header. */
+    lp->loophead->finish_time[s] = ( lp->loopbound <= 0
+                                     ? lp->loophead->start_time[s]
+                                     : lp->loopsink->finish_time[s] );
+
+    /* If the loop was not executed at all, set all loop blocks to have the
+     * same finish time as the loop header. */
+    if ( lp->loopbound <= 0 ) {
+      /* Set finish time for all other loop blocks. */
+      for ( j = lp->num_topo - 1; j >= 0; j-- ) {
+        block * const bb = lp->topo[j];
+        assert(bb);
+
+        if ( bb->bbid != lp->loophead->bbid ) {
+          bb->finish_time[s] = lp->loophead->finish_time[s];
+        }
+      }
+    }
+  );
+  if ( lp->loopbound <= 0 ) {
+    DOUT( "Loop %u.%u is not executed at all\n", lp->pid, lp->lpid );
+  }
+
+  DEND();
+}
+
+/* Compute best and worst case finish time and cost of a block */
+static void computeET_block( block* bb, procedure* proc, loop* cur_lp, uint context )
+{
+  DSTART( "computeET_block" );
+  DOUT( "Visiting block %u.%u at times %llu / %llu\n", bb->pid, bb->bbid,
+      bb->start_time[ACCESS_SCENARIO_BCET],
+      bb->start_time[ACCESS_SCENARIO_WCET] );
+
+  /* Check whether the block is some header of a loop structure.
+   * In that case do separate analysis of the loop */
+  /* Exception is when we are currently in the process of analyzing
+   * the same loop */
+  loop* inlp = check_loop( bb, proc );
+  if ( inlp && ( !cur_lp || ( inlp->lpid != cur_lp->lpid ) ) ) {
+
+    computeET_loop( inlp, proc, context );
+
+  /* It's not a loop. Go through all the instructions and
+   * compute the BCET and WCET of the block */
+  } else {
+    ull bb_cost[NUM_ACCESS_SCENARIOS] = { 0, 0 };
+    const unsigned char *acc_types[NUM_ACCESS_SCENARIOS];
+    int i, s;
+    ITERATE_ACTIVE_SCENARIOS( s,
+      acc_types[s] = getAccessTypes( bb, context, s );
+    );
+
+    for ( i = 0; i < bb->num_instr; i++ ) {
+      instr* inst = bb->instrlist[i];
+      assert(inst);
+
+      ITERATE_ACTIVE_SCENARIOS( s,
+        /* First handle instruction cache access time */
+        const acc_type acc_t = acc_types[s][i];
+        bb_cost[s] += determine_latency( bb, bb->start_time[s] + bb_cost[s],
+                                         acc_t, NULL, s );
+
+        /* Then add cost for executing the instruction. */
+        bb_cost[s] += getInstructionTime( inst, s );
+      );
+
+      /* Handle procedure call instruction */
+      if ( IS_CALL(inst) ) {
+        procedure * const callee = inst->callee;
+
+        /* For ignoring library calls */
+        if ( callee ) {
+          /* Compute the BCET and WCET of the callee procedure here.
+           * We dont handle recursive procedure call chain */
+          ull callee_start[NUM_ACCESS_SCENARIOS];
+          for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+            callee_start[s] = bb->start_time[s] + bb_cost[s];
+          }
+          computeET_proc( callee, callee_start );
+          ITERATE_ACTIVE_SCENARIOS( s,
+            bb_cost[s] += callee->running_cost[s];
+          );
+        }
+      }
+    }
+    /* The accumulated costs are computed. Now set the earliest and
+     * latest finish time of this block */
+    ITERATE_ACTIVE_SCENARIOS( s,
+      bb->finish_time[s] = bb->start_time[s] + bb_cost[s];
+    );
+  }
+
+  DOUT( "Setting block %d finish times = %Lu / %Lu\n", bb->bbid,
+      bb->finish_time[ACCESS_SCENARIO_BCET],
+      bb->finish_time[ACCESS_SCENARIO_WCET] );
+  DEND();
+}
+
+static void computeET_proc( procedure* proc, const ull *start_times )
+{
+  DSTART( "computeET_proc" );
+
+  /* Reset all timing information */
+  reset_timestamps( proc, start_times );
+
+  /* Recursively compute the finish times and BCET/WCET of each
+   * predecessors first */
+  int i, s;
+  for ( i = proc->num_topo - 1; i >= 0; i-- ) {
+    block* bb = proc->topo[i];
+    assert(bb);
+    /* If this is the first block of the procedure then
+     * set the start time of this block to be the same
+     * with the start time of the procedure itself */
+    ITERATE_ACTIVE_SCENARIOS( s,
+      if ( i == proc->num_topo - 1 )
+        bb->start_time[s] = start_times[s];
+      else
+        set_start_time( bb, proc, s );
+    );
+    computeET_block( bb, proc, NULL, 0 );
+  }
+
+  /* Now calculate the final BCET and WCET */
+  ITERATE_ACTIVE_SCENARIOS( s,
+    ull f_time = 0;
+    for ( i = 0; i < proc->num_topo; i++ ) {
+      assert(proc->topo[i]);
+      if ( proc->topo[i]->num_outgoing > 0 )
+        break;
+
+      const ull bb_f_time = proc->topo[i]->finish_time[s];
+      if ( i == 0 ||
+           ( s == ACCESS_SCENARIO_BCET && f_time > bb_f_time ) ||
+           ( s == ACCESS_SCENARIO_WCET && f_time < bb_f_time ) )
+        f_time = bb_f_time;
+    }
+
+    proc->running_finish_time[s] = f_time;
+    proc->running_cost[s] = f_time - start_times[s];
+    assert( f_time >= start_times[s] && "Computed negative procedure runtime!" );
+  );
+
+  DOUT( "Set best / worst case cost of the procedure %d = %Lu / %Lu\n",
+      proc->pid, proc->running_cost[ACCESS_SCENARIO_BCET],
+      proc->running_cost[ACCESS_SCENARIO_WCET] );
+  DEND();
+}
+
+/* Analyze best and worst case execution time of all the tasks inside
+ * a MSC. The MSC is given by the argument */
+void compute_bus_ET_MSC_unroll( MSC *msc, const char *tdma_bus_schedule_file )
+{
+  DSTART( "compute_bus_ET_MSC_unroll" );
+
+  /* Set the global TDMA bus schedule */
+  setSchedule( tdma_bus_schedule_file );
+
+  /* Reset the earliest/latest time of all cores */
+  memset( earliest_core_time, 0, num_core * sizeof(ull) );
+  memset( latest_core_time, 0, num_core * sizeof(ull) );
+  /* reset latest time of all tasks */
+  reset_all_task( msc );
+
+  int s;
+  for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+    activeScenarios[s] = 1;
+  }
+
+  int k;
+  for ( k = 0; k < msc->num_task; k++ ) {
+
+    DOUT( "Analyzing Task BCET/WCET %s......\n", msc->taskList[k].task_name );
+    const milliseconds analysis_start = getmsecs();
+
+    /* Get needed inputs. */
+    cur_task = &( msc->taskList[k] );
+    ncore = get_core( cur_task );
+    procedure * const task_main = cur_task->main_copy;
+
+    /* First get the earliest and latest start time of the current task. */
+    ull start_times[NUM_ACCESS_SCENARIOS];
+    start_times[ACCESS_SCENARIO_BCET] =
+      get_earliest_task_start_time( cur_task, ncore );
+    start_times[ACCESS_SCENARIO_WCET] =
+      get_latest_task_start_time( cur_task, ncore );
+
+    /* Then compute and set the best and worst case cost of this task */
+    computeET_proc( task_main, start_times );
+    cur_task->bcet = task_main->running_cost[ACCESS_SCENARIO_BCET];
+    cur_task->wcet = task_main->running_cost[ACCESS_SCENARIO_WCET];
+
+    /* Now update the earliest/latest starting time in this core */
+    earliest_core_time[ncore] = start_times[ACCESS_SCENARIO_BCET] +
+                                cur_task->bcet;
+    latest_core_time[ncore] = start_times[ACCESS_SCENARIO_WCET] +
+                              cur_task->wcet;
+
+    /* Since the interference file for a MSC was dumped in topological
+     * order and read back in the same order we are assured of the fact
+     * that we analyze the tasks inside a MSC only after all of its
+     * predecessors have been analyzed. Thus After analyzing one task
+     * update all its successor tasks' earliest and latest time */
+    update_succ_task_earliest_start_time( msc, cur_task );
+    update_succ_task_latest_start_time( msc, cur_task );
+
+    /* Measure time needed for single-task analysis. */
+    const milliseconds analysis_end = getmsecs();
+    cur_task->bcet_analysis_time = analysis_end - analysis_start;
+    cur_task->wcet_analysis_time = analysis_end - analysis_start;
+
+    DOUT( "**************************************************************\n" );
+    DOUT( "Earliest / Latest start time of the task = %Lu / %Lu cycles\n",
+        start_times[ACCESS_SCENARIO_BCET], start_times[ACCESS_SCENARIO_WCET] );
+    DOUT( "Earliest / Latest finish time of the task = %Lu / %Lu cycles\n",
+        task_main->running_finish_time[ACCESS_SCENARIO_BCET],
+        task_main->running_finish_time[ACCESS_SCENARIO_WCET] );
+    DOUT( "BCET / WCET of the task %s shared bus = %Lu / %Lu cycles\n",
+        g_shared_bus ? "with" : "without", cur_task->bcet, cur_task->wcet );
+    DOUT( "**************************************************************\n\n" );
+  }
+
+  DEND();
+}
@@ -0,0 +1,31 @@
+/*! This is a header file of the Chronos timing analyzer. */
+
+/*
+ * DAG-based BCET and WCET analysis functions.
+ *
+ * These functions fully unroll all loops during the analysis. The BCET and
+ * the WCET are computed together in a single traversal.
+ */
+
+#ifndef __CHRONOS_ANALYSIS_DAG_ET_UNROLL_H
+#define __CHRONOS_ANALYSIS_DAG_ET_UNROLL_H
+
+#include "header.h"
+
+// ######### Macros #########
+
+
+
+// ######### Datatype declarations  ###########
+
+
+
+// ######### Function declarations  ###########
+
+
+/* Analyze best and worst case execution time of all the tasks inside
+ * a MSC. The MSC is given by the argument */
+void compute_bus_ET_MSC_unroll(MSC *msc, const char *tdma_bus_schedule_file);
+
+
+#endif
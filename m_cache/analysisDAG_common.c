@@ -19,53 +19,7 @@
 #include "block.h"
 #include "busSchedule.h"
 #include "handler.h"
-
-
-static uint get_hex( const char * const hex_string )
-{
-  DSTART( "get_hex" );
-
-   int len,i;
-   char dig;
-   uint value = 0;
-
-   len = strlen(hex_string);
-
-   DOUT( "hex string = %s\n", hex_string);
-
-   for(i = 0; i < len; i++)
-   {
-      dig = hex_string[len-i-1];
-
-      switch(dig)
-      {
-        case 'a':
-          value += 10 * pow(16,i);
-          break;
-        case 'b':
-          value += 11 * pow(16,i);
-          break;
-        case 'c':
-          value += 12 * pow(16,i);
-          break;
-        case 'd':
-          value += 13 * pow(16,i);
-          break;
-        case 'e':
-          value += 14 * pow(16,i);
-          break;
-        case 'f':
-          value += 15 * pow(16,i);
-          break;
-        default:
-          value += (dig - 48) * pow(16,i);
-      };
-   }
-
-   DOUT( "hex value = %x\n", value);
-
-   DRETURN( value );
-}
+#include "resultMemo.h"
 
 
 /* This function returns a context id for the iterations an inner loop inside a
@@ -127,35 +81,12 @@ uint getMaximumLoopContext( const procedure * const proc )
 }
 
 
-/* The result type of 'isLoopExit'. */
-enum LoopExitBlockType {
-  LEBT_MAIN_EXIT,
-  LEBT_SECONDARY_EXIT,
-  LEBT_NO_EXIT
-};
-
-/* Determines whether 'bb' is the exit of any loop in 'proc'.
- * Only read stored data, does not perform computations. */
-static enum LoopExitBlockType getLoopExitType( block* bb, procedure* proc )
-{
-  uint i;
-  for ( i = 0; i < proc->num_loops; i++ ) {
-    const loop * const lp = proc->loops[i];
-    if ( lp->loopexit == bb ) {
-      return LEBT_MAIN_EXIT;
-    } else if ( getblock( bb->bbid, lp->exits, 0, lp->num_exits - 1 ) >= 0 ) {
-      return LEBT_SECONDARY_EXIT;
-    }
-  }
-  return LEBT_NO_EXIT;
-}
-
 /* Self-explanatory. */
 static _Bool allPredecessorsAreLoopExits( block* bb, procedure* proc )
 {
   uint i;
   for ( i = 0; i < bb->num_incoming; i++ ) {
-    if ( getLoopExitType( proc->bblist[bb->incoming[i]], proc ) == LEBT_NO_EXIT ) {
+    if ( proc->bblist[bb->incoming[i]]->loop_exit_type == LOOP_EXIT_NONE ) {
       return FALSE;
     }
   }
@@ -164,13 +95,13 @@ static _Bool allPredecessorsAreLoopExits( block* bb, procedure* proc )
 
 /* This sets the latest starting time of a block during WCET calculation.
  * (Not context-aware) */
-void set_start_time_WCET( block* bb, procedure* proc )
+static void set_start_time_WCET( block* bb, procedure* proc )
 {
   DSTART( "set_start_time_WCET" );
 
-  ull max_start = bb->start_time;
+  ull max_start = bb->start_time[ACCESS_SCENARIO_WCET];
   const _Bool allPredsAreLoopExits = allPredecessorsAreLoopExits( bb, proc );
-  const _Bool currentBBIsMainExit  = getLoopExitType( bb, proc ) == LEBT_MAIN_EXIT;
+  const _Bool currentBBIsMainExit  = bb->loop_exit_type == LOOP_EXIT_MAIN;
   assert(bb);
 
   int i;
@@ -183,23 +114,24 @@ void set_start_time_WCET( block* bb, procedure* proc )
      * as predecessors, because the finish time of side exits may not
      * have been updated in some cases. */
     if ( ( allPredsAreLoopExits &&
-           getLoopExitType( predecessor, proc ) != LEBT_MAIN_EXIT ) ||
+           predecessor->loop_exit_type != LOOP_EXIT_MAIN ) ||
          /* Also skip the predecessor if it is a secondary exit, and the
           * current bb is the main exit (chained exits, where the last is
           * the main exit). The finish time of side exits may not have
           * been updated in call cases then. */
          ( currentBBIsMainExit &&
-           getLoopExitType( predecessor, proc ) == LEBT_SECONDARY_EXIT ) ) {
+           predecessor->loop_exit_type == LOOP_EXIT_SECONDARY ) ) {
       continue;
     }
 
     /* Determine the predecessors' latest finish time */
-    max_start = MAX( max_start, predecessor->finish_time );
+    max_start = MAX( max_start,
+                     predecessor->finish_time[ACCESS_SCENARIO_WCET] );
   }
 
   /* Now set the starting time of this block to be the latest
    * finish time of predecessors block */
-  bb->start_time = max_start;
+  bb->start_time[ACCESS_SCENARIO_WCET] = max_start;
 
   DOUT( "Setting max start of bb %d = %Lu\n", bb->bbid, max_start );
   DEND();
@@ -207,13 +139,13 @@ void set_start_time_WCET( block* bb, procedure* proc )
 
 /* This sets the earliest starting time of a block during BCET calculation
  * (Not context-aware) */
-void set_start_time_BCET( block* bb, procedure* proc )
+static void set_start_time_BCET( block* bb, procedure* proc )
 {
   DSTART( "set_start_time_BCET" );
 
   ull min_start = 0;
   const _Bool allPredsAreLoopExits = allPredecessorsAreLoopExits( bb, proc );
-  const _Bool currentBBIsMainExit  = getLoopExitType( bb, proc ) == LEBT_MAIN_EXIT;
+  const _Bool currentBBIsMainExit  = bb->loop_exit_type == LOOP_EXIT_MAIN;
   assert(bb);
 
   int i;
@@ -226,33 +158,45 @@ void set_start_time_BCET( block* bb, procedure* proc )
      * as predecessors, because the finish time of side exits may not
      * have been updated in some cases. */
     if ( ( allPredsAreLoopExits &&
-           getLoopExitType( predecessor, proc ) != LEBT_MAIN_EXIT ) ||
+           predecessor->loop_exit_type != LOOP_EXIT_MAIN ) ||
          /* Also skip the predecessor if it is a secondary exit, and the
           * current bb is the main exit (chained exits, where the last is
           * the main exit). The finish time of side exits may not have
           * been updated in call cases then. */
          ( currentBBIsMainExit &&
-           getLoopExitType( predecessor, proc ) == LEBT_SECONDARY_EXIT ) ) {
+           predecessor->loop_exit_type == LOOP_EXIT_SECONDARY ) ) {
       continue;
     }
 
     /* Determine the predecessors' earliest finish time */
     if ( i == 0 ) {
-      min_start = predecessor->finish_time;
+      min_start = predecessor->finish_time[ACCESS_SCENARIO_BCET];
     } else {
-      min_start = MIN( min_start, predecessor->finish_time );
+      min_start = MIN( min_start,
+                       predecessor->finish_time[ACCESS_SCENARIO_BCET] );
     }
   }
 
   /* Now set the starting time of this block to be the earliest
    * finish time of predecessors block */
-  bb->start_time = min_start;
+  bb->start_time[ACCESS_SCENARIO_BCET] = min_start;
 
   DOUT( "Setting min start of bb %d = %Lu\n", bb->bbid, min_start);
   DEND();
 }
 
 
+void set_start_time( block* bb, procedure* proc,
+                     enum AccessScenario accessScenario )
+{
+  if ( accessScenario == ACCESS_SCENARIO_WCET ) {
+    set_start_time_WCET( bb, proc );
+  } else {
+    set_start_time_BCET( bb, proc );
+  }
+}
+
+
 /* Given a MSC and a task inside it, this function computes
  * the earliest start time of the argument task. Finding out
  * the earliest start time is important as the bus aware BCET
@@ -380,6 +324,15 @@ ull getInstructionWCET( const instr *instruction )
 }
 
 
+ull getInstructionTime( const instr *instruction,
+                        enum AccessScenario accessScenario )
+{
+  return ( accessScenario == ACCESS_SCENARIO_WCET
+           ? getInstructionWCET( instruction )
+           : getInstructionBCET( instruction ) );
+}
+
+
 /* Simply returns the time that is takes for the memory hierarchy to
  * perform an access with the given access classification. This does
  * not include bus delays, it only sums up the cache miss penalties
@@ -423,11 +376,13 @@ uint determine_latency( const block * const bb, const ull access_time,
   uint result = 0;
 
   /* Get schedule data */
-  const core_sched_p core_schedule = getCoreSchedule( ncore, access_time );
-  const uint slot_start = core_schedule->start_time;
+  const sched_p schedule = getSchedule();
+  uint segment = getScheduleSegmentIndex( access_time );
+  const core_sched_p core_schedule =
+    schedule->seg_list[segment]->per_core_sched[ncore];
   const uint slot_len = core_schedule->slot_len;
-  const ull interval = core_schedule->interval;
-  assert( num_core * slot_len == interval && "Inconsistent model!" );
+  assert( num_core * slot_len == core_schedule->interval &&
+          "Inconsistent model!" );
 
   /* Init output parameter. */
   if ( has_waited_for_next_tdma_slot != NULL ) {
@@ -442,10 +397,6 @@ uint determine_latency( const block * const bb, const ull access_time,
   // All other cases may suffer a variable delay
   } else {
 
-    // Determine the offset of the access in the TDMA schedule
-    const ull offset = access_time % interval;
-    assert( offset < interval && "Internal error: Invalid offset!" );
-
     /* Return maximum if no bus is modeled. The maximum occurs when a bus request
      * arrives at (slot_end_time - request_duration - 1) which thus cannot be
      * fulfilled in the core's remaining slot time and thus must be delayed. Total
@@ -465,31 +416,59 @@ uint determine_latency( const block * const bb, const ull access_time,
       /* Get the time needed to perform the access itself. */
       const ull simple_access_duration = getAccessLatency( type );
 
-      /* First compute the waiting time that is needed before the successful
-       * bus access can begin. */
-      ull waiting_time = 0;
-
-      /* If the access if before the core's slot begins, then wait until the
-       * slot begins and do the access then. */
-      if ( offset < slot_start ) {
-        waiting_time = slot_start - offset;
-      /* If the access fits into the current core's slot, then register this. */
-      } else if ( offset <= slot_start + slot_len - simple_access_duration ) {
-        waiting_time = 0;
-      /* Else compute the time until the beginning of the next slot of the core
-       * and add the access time itself to get the total delay. */
-      } else {
-        waiting_time = ( interval - offset + slot_start );
-        if ( has_waited_for_next_tdma_slot != NULL ) {
-          *has_waited_for_next_tdma_slot = 1;
+      /* The access must begin within the segment in which it is issued. If
+       * the segment ends before, the access is issued again when the next
+       * segment begins. */
+      ull issue_time = access_time;
+      while ( 1 ) {
+        const core_sched_p seg_schedule =
+          schedule->seg_list[segment]->per_core_sched[ncore];
+        const uint slot_start = seg_schedule->start_time;
+        const uint seg_slot_len = seg_schedule->slot_len;
+        const ull interval = seg_schedule->interval;
+
+        // Determine the offset of the access in the TDMA schedule
+        const ull offset = issue_time % interval;
+        assert( offset < interval && "Internal error: Invalid offset!" );
+
+        /* First compute the waiting time that is needed before the successful
+         * bus access can begin. */
+        ull waiting_time = 0;
+        _Bool waited_for_next_slot = 0;
+
+        /* If the access if before the core's slot begins, then wait until the
+         * slot begins and do the access then. */
+        if ( offset < slot_start ) {
+          waiting_time = slot_start - offset;
+        /* If the access fits into the current core's slot, then register this. */
+        } else if ( offset <= slot_start + seg_slot_len - simple_access_duration ) {
+          waiting_time = 0;
+        /* Else compute the time until the beginning of the next slot of the core
+         * and add the access time itself to get the total delay. */
+        } else {
+          waiting_time = ( interval - offset + slot_start );
+          waited_for_next_slot = 1;
         }
-      }
 
-      /* Then sum up the waiting and the access time to form the final delay. */
-      result = waiting_time + simple_access_duration;
+        const ull access_begin = issue_time + waiting_time;
+        if ( segment + 1 < schedule->n_segments &&
+             access_begin >= schedule->seg_list[segment + 1]->seg_start ) {
+          segment++;
+          issue_time = schedule->seg_list[segment]->seg_start;
+        } else {
+          /* Then sum up the waiting and the access time to form the final delay. */
+          result = access_begin + simple_access_duration - access_time;
+          if ( has_waited_for_next_tdma_slot != NULL ) {
+            *has_waited_for_next_tdma_slot = waited_for_next_slot ||
+                                             issue_time != access_time;
+          }
+          break;
+        }
+      }
 
       /* Assert that the delay does not exceed the maximum possible delay */
-      assert( result <= ( num_core - 1 ) * slot_len + 2 * getAccessLatency( L2_MISS ) &&
+      assert( ( schedule->n_segments > 1 ||
+                result <= ( num_core - 1 ) * slot_len + 2 * getAccessLatency( L2_MISS ) ) &&
           "Bus delay exceeded maximum limit" );
     }
   }
@@ -510,178 +489,587 @@ uint determine_latency( const block * const bb, const ull access_time,
 }
 
 
-/* Return the procedure pointer in the task data structure */
-static procedure* get_task_callee(uint startaddr)
+void initLatencyBound( latency_bound * const bound,
+    enum AccessScenario accessScenario )
 {
-  int i;
-  procedure* callee;
-  block* f_block;
-
-  assert(cur_task);   
-   
-  for( i = 0; i < cur_task->num_proc; i++ )
-  {  
-    callee = cur_task->proc_cg_ptr[i].proc[0]; 
-    assert(callee);
-    
-    /* get the first block */
-    f_block = callee->topo[callee->num_topo - 1];
-
-    /* If the start address is the same then return 
-     * the callee */
-    if(f_block->startaddr == startaddr)
-       return callee;
+  bound->latency = ( accessScenario == ACCESS_SCENARIO_BCET ? UINT_MAX : 0 );
+  bound->has_waited_for_next_tdma_slot = 0;
+  bound->waited_offset = 0;
+}
+
+
+/* Within the TDMA interval, the latency computed by determine_latency is
+ *
+ * A) 'slot_start - offset + duration' before the core's slot (decreasing)
+ * B) 'duration' while the access fits into the slot (constant)
+ * C) 'interval - offset + slot_start + duration' afterwards (decreasing),
+ *    these accesses wait for the next TDMA slot
+ *
+ * so the extremes over an offset range are found at the ends of these
+ * pieces. In segmented schedules, the slot of piece C is that of the segment
+ * which is active in the next TDMA interval. */
+static void boundLatencyInSlot( latency_bound * const bound,
+    const uint lower_offset, const uint upper_offset, const ull duration,
+    const core_slot_pair * const slot, const ull interval,
+    const _Bool bcet, const _Bool track_waits )
+{
+  const uint slot_start = slot->slot_start;
+  const uint slot_len = slot->slot_len;
+  const uint next_slot_start = slot->next_slot_start;
+  assert( upper_offset < interval && "Invalid offset!" );
+
+  /* The last offset of piece B. Like in determine_latency, this wraps around
+   * (and B extends to the end of the interval) if the slot is shorter than
+   * the access. */
+  const ull fit_end = slot_start + slot_len - duration;
+
+  /* The ranges of the pieces within [lower_offset, upper_offset] */
+  const _Bool have_a = lower_offset < slot_start;
+  const ull a_lower = lower_offset;
+  const ull a_upper = MIN( (ull)upper_offset, (ull)slot_start - 1 );
+
+  const ull b_lower = MAX( (ull)lower_offset, (ull)slot_start );
+  const ull b_upper = MIN( (ull)upper_offset, fit_end );
+  const _Bool have_b = b_lower <= b_upper;
+
+  const _Bool have_c = fit_end < upper_offset && slot_start <= upper_offset;
+  const ull c_lower = have_c ? MAX( (ull)lower_offset,
+                                    MAX( (ull)slot_start, fit_end + 1 ) ) : 0;
+  const ull c_upper = upper_offset;
+
+  #define LATENCY_A( offset ) ( (uint)( slot_start - ( offset ) + duration ) )
+  #define LATENCY_C( offset ) \
+    ( (uint)( interval - ( offset ) + next_slot_start + duration ) )
+
+  if ( bcet ) {
+    /* The minima of the decreasing pieces are at their ends. Within piece C
+     * every offset improves on its predecessors, so if it improves on the
+     * bound at all, its last offset is the last witness. */
+    if ( have_a ) {
+      bound->latency = MIN( bound->latency, LATENCY_A( a_upper ) );
+    }
+    if ( have_b ) {
+      bound->latency = MIN( bound->latency, (uint)duration );
+    }
+    if ( have_c && LATENCY_C( c_upper ) < bound->latency ) {
+      bound->latency = LATENCY_C( c_upper );
+      if ( track_waits ) {
+        bound->has_waited_for_next_tdma_slot = 1;
+        bound->waited_offset = c_upper;
+      }
+    }
+  } else {
+    /* The maxima of the decreasing pieces are at their beginnings. */
+    if ( have_a && LATENCY_A( a_lower ) > bound->latency ) {
+      bound->latency = LATENCY_A( a_lower );
+    }
+    if ( have_b && (uint)duration > bound->latency ) {
+      bound->latency = duration;
+    }
+    if ( have_c && LATENCY_C( c_lower ) > bound->latency ) {
+      bound->latency = LATENCY_C( c_lower );
+      if ( track_waits ) {
+        bound->has_waited_for_next_tdma_slot = 1;
+        bound->waited_offset = c_lower;
+      }
+    }
   }
-  
-  /* To make compiler happy */
-  return NULL;    
+
+  #undef LATENCY_A
+  #undef LATENCY_C
 }
 
 
-/* Returns the callee procedure for a procedure call instruction */
-procedure *getCallee( const instr * const inst, const procedure * const proc)
+/* The minimum (BCET) / maximum (WCET) latencies of the access types over all
+ * times for schedules without a period, see initScheduleLatencyBounds. */
+static uint time_latency_bounds[L2_HIT + 1][NUM_ACCESS_SCENARIOS];
+
+
+/* Updates 'bound' with the latencies of determine_latency at all times of
+ * the global TDMA schedule. Within a segment, they repeat with its TDMA
+ * interval, except in its last interval, from which accesses may be issued
+ * again in the next segment. */
+static void boundLatencyOverTimes( latency_bound * const bound,
+    const acc_type type, enum AccessScenario accessScenario )
 {
-  DSTART( "getCallee" );
+  const sched_p schedule = getSchedule();
+  const _Bool bcet = ( accessScenario == ACCESS_SCENARIO_BCET );
+  #define UPDATE_BOUND( time ) { \
+    const uint latency = determine_latency( NULL, time, type, NULL, \
+                                            accessScenario ); \
+    bound->latency = ( bcet ? MIN( bound->latency, latency ) \
+                            : MAX( bound->latency, latency ) ); \
+  }
 
-  int i;
-  procedure* callee;
-  block* f_block;
-  uint addr;
-
-  /* It cannot be an assert because some library calls
-   * are ignored. This if the procedure has no callee 
-   * list return then the callee must have been a library
-   * function and its cost is ignored */
-  /* assert(proc->calls); */
-  if(!proc->calls)
-     DRETURN( NULL );
-
-  addr = get_hex(GET_CALLEE(inst));
-
-  /* For MSC based analysis return the procedure pointer in the 
-   * task */
-  if(cur_task)
-    DRETURN( get_task_callee(addr) );
-  
-  for(i = 0; i < proc->num_calls; i++)
-  {  
-     callee =  procs[proc->calls[i]]; 
-     assert(callee);
-     /* Get the first block of the callee */
-     f_block = callee->topo[callee->num_topo - 1];
-     /* If the start address of the first block matches
-      * with the jump instruction of the callee procedure
-      * then this is the callee --- in that case return 
-      * the callee procedure */
-     DOUT( "jump address = %x, callee address = %x\n",
-        get_hex(GET_CALLEE(inst)), f_block->startaddr); 
-     
-     /* Check the starting address of the procedure */
-     if(f_block->startaddr == addr)
-     { 
-       /* FIXME: If no MSC-based calculation return callee 
-        * directly otherwise return the modified pointer in
-        * the task */
-          DRETURN( callee );
-     }   
-  }
-
-  /* Must not come here */
-  /* ERROR ::::: CALLED PROCEDURE NOT FOUND */
-  /* FIXME: Am I right doing here ? */    
-  /*  prerr("Error: Called procedure not found"); */
-
-  /* to make compiler happy */    
-  DRETURN( NULL );
+  uint i;
+  for ( i = 0; i < schedule->n_segments; i++ ) {
+    const ull seg_start = schedule->seg_list[i]->seg_start;
+    const ull interval = schedule->seg_list[i]->per_core_sched[ncore]->interval;
+    const ull seg_end = ( i + 1 < schedule->n_segments
+        ? schedule->seg_list[i + 1]->seg_start : seg_start + interval );
+
+    ull time;
+    for ( time = seg_start; time < MIN( seg_end, seg_start + interval ); time++ ) {
+      UPDATE_BOUND( time );
+    }
+    if ( i + 1 < schedule->n_segments ) {
+      for ( time = MAX( seg_start + interval, seg_end - MIN( seg_end, interval ) );
+            time < seg_end; time++ ) {
+        UPDATE_BOUND( time );
+      }
+    }
+  }
+
+  #undef UPDATE_BOUND
+}
+
+
+void initScheduleLatencyBounds( void )
+{
+  if ( getScheduleInterval() > 0 ) {
+    return;
+  }
+
+  acc_type type;
+  for ( type = L2_MISS; type <= L2_HIT; type++ ) {
+    int s;
+    for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+      latency_bound bound;
+      initLatencyBound( &bound, s );
+      boundLatencyOverTimes( &bound, type, s );
+      time_latency_bounds[type][s] = bound.latency;
+    }
+  }
+}
+
+
+void boundLatencyOverOffsets( latency_bound * const bound,
+    const uint lower_offset, const uint upper_offset, const acc_type type,
+    enum AccessScenario accessScenario )
+{
+  assert( lower_offset <= upper_offset && "Invalid arguments!" );
+  const _Bool bcet = ( accessScenario == ACCESS_SCENARIO_BCET );
+  uint num_slots;
+  const core_slot_pair * const slots = getCoreSlotPairs( ncore, &num_slots );
+  uint i;
+
+  // Accesses with constant latency (which may still differ between segments)
+  if ( type == L1_HIT || g_no_bus_modeling ) {
+    for ( i = 0; i < num_slots; i++ ) {
+      const uint latency = determine_latency( NULL, slots[i].time, type, NULL,
+                                              accessScenario );
+      bound->latency = ( bcet ? MIN( bound->latency, latency )
+                              : MAX( bound->latency, latency ) );
+    }
+    return;
+  }
+
+  // Without a period, the offsets do not tell anything about the latency
+  const uint period = getScheduleInterval();
+  if ( period == 0 ) {
+    const uint latency = time_latency_bounds[type][accessScenario];
+    bound->latency = ( bcet ? MIN( bound->latency, latency )
+                            : MAX( bound->latency, latency ) );
+    return;
+  }
+
+  /* If the slot pairs differ between the segments, the offset after waiting
+   * for the next TDMA slot depends on the segment, so it is not reported.
+   * Each segment repeats its TDMA interval within the period, so only the
+   * offsets modulo the interval matter. */
+  const ull duration = getAccessLatency( type );
+  const _Bool track_waits = ( num_slots == 1 );
+  assert( upper_offset < period && "Invalid offset!" );
+  for ( i = 0; i < num_slots; i++ ) {
+    const uint interval = slots[i].interval;
+    const uint lower = lower_offset % interval;
+    const uint upper = upper_offset % interval;
+    if ( upper_offset - lower_offset + 1 >= interval ) {
+      boundLatencyInSlot( bound, 0, interval - 1, duration, &slots[i],
+                          interval, bcet, track_waits );
+    } else if ( lower <= upper ) {
+      boundLatencyInSlot( bound, lower, upper, duration, &slots[i],
+                          interval, bcet, track_waits );
+    } else {
+      boundLatencyInSlot( bound, lower, interval - 1, duration, &slots[i],
+                          interval, bcet, track_waits );
+      boundLatencyInSlot( bound, 0, upper, duration, &slots[i],
+                          interval, bcet, track_waits );
+    }
+  }
+}
+
+
+uint determineOffsetLatency( const block * const bb, const ull time,
+    const acc_type type, enum AccessScenario accessScenario )
+{
+  /* With a single slot pair, all segments give the same latency at an
+   * offset, so the segment at 'time' may be used. */
+  const uint period = getScheduleInterval();
+  uint num_slots;
+  getCoreSlotPairs( ncore, &num_slots );
+  if ( getSchedule()->n_segments == 1 || ( num_slots == 1 && period > 0 ) ) {
+    return determine_latency( bb, time, type, NULL, accessScenario );
+  }
+
+  const uint offset = ( period > 0 ? time % period : 0 );
+  latency_bound bound;
+  initLatencyBound( &bound, accessScenario );
+  boundLatencyOverOffsets( &bound, offset, offset, type, accessScenario );
+  return bound.latency;
+}
+
+
+/* Moves the start offsets in [lower_offset, upper_offset] by the latency of
+ * the given piece and adds them to 'end_offsets'. */
+static void addMovedOffsets( offset_data * const end_offsets,
+    const uint lower_offset, const uint upper_offset, const uint move_by )
+{
+  const offset_data start = createOffsetDataFromOffsetBounds(
+      end_offsets->type, lower_offset, upper_offset );
+  updateOffsetData( end_offsets, &start, move_by, move_by, TRUE );
+}
+
+
+/* With the pieces of boundLatencyOverOffsets, the end offset of an access is
+ * 'slot_start + duration' for all start offsets in piece A, 'offset + duration'
+ * in piece B and 'next_slot_start + duration' in piece C. The offsets within
+ * the TDMA interval are relative to 'base', the start of the interval in the
+ * period. */
+static void addAccessEndOffsetsInSlot( offset_data * const end_offsets,
+    const uint lower_offset, const uint upper_offset, const ull duration,
+    const core_slot_pair * const slot, const uint base, const uint period )
+{
+  const uint slot_start = slot->slot_start;
+  const uint slot_len = slot->slot_len;
+  const ull fit_end = slot_start + slot_len - duration;
+
+  const _Bool have_a = lower_offset < slot_start;
+  const ull b_lower = MAX( (ull)lower_offset, (ull)slot_start );
+  const ull b_upper = MIN( (ull)upper_offset, fit_end );
+  const _Bool have_b = b_lower <= b_upper;
+  const _Bool have_c = fit_end < upper_offset && slot_start <= upper_offset;
+
+  const uint a_start = base + slot_start;
+  const uint c_start = ( (ull)base + slot->interval + slot->next_slot_start ) % period;
+  if ( have_a ) {
+    addMovedOffsets( end_offsets, a_start, a_start, duration );
+  }
+  if ( have_c && !( have_a && c_start == a_start ) ) {
+    addMovedOffsets( end_offsets, c_start, c_start, duration );
+  }
+  if ( have_b ) {
+    addMovedOffsets( end_offsets, base + b_lower, base + b_upper, duration );
+  }
+}
+
+
+void addAccessEndOffsets( offset_data * const end_offsets,
+    const uint lower_offset, const uint upper_offset, const acc_type type,
+    enum AccessScenario accessScenario )
+{
+  assert( lower_offset <= upper_offset && "Invalid arguments!" );
+  uint num_slots;
+  const core_slot_pair * const slots = getCoreSlotPairs( ncore, &num_slots );
+  uint i;
+
+  // Accesses with constant latency (which may still differ between segments)
+  if ( type == L1_HIT || g_no_bus_modeling ) {
+    for ( i = 0; i < num_slots; i++ ) {
+      addMovedOffsets( end_offsets, lower_offset, upper_offset,
+          determine_latency( NULL, slots[i].time, type, NULL,
+                             accessScenario ) );
+    }
+    return;
+  }
+
+  // Without a period, the offsets are not tracked
+  const uint period = getScheduleInterval();
+  if ( period == 0 ) {
+    addMovedOffsets( end_offsets, lower_offset, upper_offset, 0 );
+    return;
+  }
+
+  /* Split the offsets into the TDMA intervals of each segment. */
+  const ull duration = getAccessLatency( type );
+  assert( upper_offset < period && "Invalid offset!" );
+  for ( i = 0; i < num_slots; i++ ) {
+    const uint interval = slots[i].interval;
+    uint base;
+    for ( base = lower_offset - lower_offset % interval; base <= upper_offset;
+          base += interval ) {
+      addAccessEndOffsetsInSlot( end_offsets,
+          MAX( lower_offset, base ) - base,
+          MIN( upper_offset, base + interval - 1 ) - base,
+          duration, &slots[i], base, period );
+    }
+  }
 }
 
 
 /* Reset start and finish time of all basic blocks in this 
  * procedure */
-void reset_timestamps(procedure* proc, ull start_time)
+void reset_timestamps(procedure* proc, const ull *start_times)
 {
-  int i;
+  int i, s;
   block* bb;
   
   for(i = 0; i < proc->num_bb; i++)
   {
     bb = proc->bblist[i];
-    bb->start_time = bb->finish_time = start_time;
+    for(s = 0; s < NUM_ACCESS_SCENARIOS; s++)
+      bb->start_time[s] = bb->finish_time[s] = start_times[s];
   }   
 }
 
 
-/* Return the type of the instruction access L1_HIT/L2_HIT/L2_MISS
- * This is computed from the shared cache analysis. The context
- * is given as a context index, see header.h:num_chmc for further
- * details.
+/* The state of the loop in a scenario after an iteration is the offset of
+ * the finish time of the loop sink in the TDMA interval and the times of all
+ * blocks in the loop relative to that finish time. The blocks of nested loops
+ * are part of the state, because the start time of a nested loop's first
+ * iteration is derived from the times of its previous execution. Since the
+ * latencies only depend on the offsets of the accesses, an iteration which
+ * starts in a state seen before behaves like the one which followed that
+ * state, only shifted in time. The states are memoized, keyed by the scenario
+ * and their exact words.
  *
- * 'scenario' determines for which scenario (BCET/WCET) the access
- * type shall be determined. */
-acc_type check_hit_miss( const block *bb, const instr *inst, 
-                         uint context, enum AccessScenario scenario )
+ * The scenarios do not depend on each other, so each of them is stopped on
+ * its own once its remaining iterations are known: When the state after
+ * iteration 'i' was seen after iteration 'i - p' and the finish time has
+ * grown by 'd' since, then the state after the last iteration is the one
+ * after iteration 'i + r' shifted by 'm * d', where the 'R' remaining
+ * iterations are 'R = m * p + r'. */
+struct loop_period {
+  loop *lp;
+  block **blocks;     /* All blocks of the loop, including nested loops. */
+  int num_blocks;
+  ull interval;
+  ull *state;         /* 2 + 2 * num_blocks words */
+  result_memo *memo;  /* Maps states to the iterations that ended in them. */
+  _Bool periodic[NUM_ACCESS_SCENARIOS];  /* The repetition was found. */
+  _Bool stopped[NUM_ACCESS_SCENARIOS];   /* The scenario was stopped. */
+  int stop_iteration[NUM_ACCESS_SCENARIOS];
+  ull shift[NUM_ACCESS_SCENARIOS];       /* To apply after stopping. */
+};
+
+/* The value under which a state is memoized. */
+typedef struct {
+  ull finish_time;
+  int iteration;
+} loop_period_entry;
+
+/* Number of loop periods which currently exist in this thread. Nested
+ * loops and the loops of called procedures are analyzed while the
+ * surrounding loop is, so their periods exist at the same time. The memo of
+ * the n-th of them gets 1/2^n of the result memory, which keeps their total
+ * within 'g_result_memo_cap'. */
+static TASK_LOCAL uint num_loop_periods = 0;
+
+
+/* Adds the blocks of 'lp' to 'period', except for its head if 'skip_head'
+ * is set, and recurses into the nested loops. */
+static void collectLoopBlocks( loop_period *period, loop *lp,
+                               procedure *proc, _Bool skip_head )
 {
-  DSTART( "check_hit_miss" );
-  assert( bb && inst && 
-          context < bb->num_chmc &&
-          context < bb->num_chmc_L2 &&
-          "Invalid arguments!" );
+  int i;
+  for ( i = 0; i < lp->num_topo; i++ ) {
+    block * const bb = lp->topo[i];
+    loop * const inner = check_loop( bb, proc );
 
-  /* If the flow is under testing mode....dont
-   * bother about CHMC. Just return all miss */
-  acc_type result = -1;
-  if(g_testing_mode) {
-    result = L2_MISS;
-  } else {
+    if ( !skip_head || bb != lp->loophead ) {
+      period->blocks[period->num_blocks++] = bb;
+    }
+    if ( inner && inner != lp ) {
+      collectLoopBlocks( period, inner, proc, 1 );
+    }
+  }
+}
 
-    // Get the cache analysis results (CHMCs) from the block
-    CHMC ** const chmc_l1 = bb->chmc;
-    CHMC ** const chmc_l2 = bb->chmc_L2;
-    const char *l1_result = chmc_l1[context]->hitmiss_addr;
-    const char *l2_result = chmc_l2[context]->hitmiss_addr;
-    // Get the index of the instruction inside the block
-    const int instr_index = getinstruction( inst,
-        (const instr**)bb->instrlist, 0, bb->num_instr - 1 );
 
-    // Compute the result
-    switch( scenario ) {
+loop_period *createLoopPeriod( loop *lp, procedure *proc )
+{
+  /* The latencies of segmented schedules are not periodic. At least three
+   * iterations are needed to skip one. */
+  if ( getSchedule()->type != SCHED_TYPE_1 || lp->loopbound < 3 ) {
+    return NULL;
+  }
 
-      case ACCESS_SCENARIO_BCET:
+  loop_period *period;
+  CALLOC( period, loop_period*, 1, sizeof( loop_period ), "period" );
+  period->lp = lp;
+  period->interval = getCoreSchedule( ncore, 0 )->interval;
+  MALLOC( period->blocks, block**, ( proc->num_bb + proc->num_loops ) *
+      sizeof( block* ), "period->blocks" );
+  collectLoopBlocks( period, lp, proc, 0 );
+  assert( period->num_blocks <= proc->num_bb + proc->num_loops );
+
+  const size_t state_size = ( 2 + 2 * period->num_blocks ) * sizeof( ull );
+  MALLOC( period->state, ull*, state_size, "period->state" );
+  num_loop_periods++;
+  period->memo = createResultMemo( state_size, sizeof( loop_period_entry ),
+      num_loop_periods < 64 ? g_result_memo_cap >> num_loop_periods : 0 );
+
+  return period;
+}
 
-        // Check level 1 analysis result
-        if ( !l1_result || l1_result[instr_index] != ALWAYS_MISS ) {
-          result = L1_HIT;
-        } else
-        // Check level 2 analysis result
-        if ( !l2_result || l2_result[instr_index] != ALWAYS_MISS ) {
-          result = L2_HIT;
-        }
 
-        break;
+/* Looks for the state of scenario 's' after 'iteration' among the earlier
+ * ones, and plans when to stop the scenario if it was found. */
+static void detectLoopPeriod( loop_period *period, int iteration, int s )
+{
+  /* Unsigned arithmetic wraps around, so times before the finish time of
+   * the sink are represented exactly as well. */
+  const ull finish_time = period->lp->loopsink->finish_time[s];
+  ull *word = period->state;
+  int i;
+  *word++ = s;
+  *word++ = finish_time % period->interval;
+  for ( i = 0; i < period->num_blocks; i++ ) {
+    *word++ = period->blocks[i]->start_time[s] - finish_time;
+    *word++ = period->blocks[i]->finish_time[s] - finish_time;
+  }
 
-      case ACCESS_SCENARIO_WCET:
+  const loop_period_entry * const seen =
+    lookupResultMemo( period->memo, period->state );
+  if ( seen == NULL ) {
+    const loop_period_entry entry = { finish_time, iteration };
+    storeResultMemo( period->memo, period->state, &entry );
+    return;
+  }
+
+  const int length = iteration - seen->iteration;
+  const int remaining = period->lp->loopbound - 1 - iteration;
+  period->periodic[s] = 1;
+  period->stop_iteration[s] = iteration + remaining % length;
+  period->shift[s] = ( remaining / length ) *
+    ( finish_time - seen->finish_time );
+  DOUT( "Loop %u.%u repeats in scenario %d after iteration %d with period "
+      "%d, stopping after iteration %d\n", period->lp->pid, period->lp->lpid,
+      s, iteration, length, period->stop_iteration[s] );
+}
 
-        // Check level 1 analysis result
-        if ( !l1_result || l1_result[instr_index] == ALWAYS_HIT ) {
-          result = L1_HIT;
-        } else
-        // Check level 2 analysis result
-        if ( !l2_result || l2_result[instr_index] == ALWAYS_HIT ) {
-          result = L2_HIT;
-        }
 
-        break;
+int skipLoopPeriods( loop_period *period, int iteration, _Bool *active )
+{
+  DSTART( "skipLoopPeriods" );
 
-      default:
-        assert( 0 && "Unknown access scenario!" );
+  _Bool any_active = 0;
+  int s;
+  for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+    if ( !active[s] ) {
+      continue;
     }
+    if ( !period->periodic[s] ) {
+      detectLoopPeriod( period, iteration, s );
+    }
+    if ( period->periodic[s] && iteration == period->stop_iteration[s] ) {
+      period->stopped[s] = 1;
+      active[s] = 0;
+    }
+    any_active |= active[s];
+  }
 
-    // If no better assumption can be made, assume a L2 miss
-    if ( result == -1 ) {
-      result = L2_MISS;
+  /* Nothing is left to analyze if all scenarios were stopped. */
+  DRETURN( any_active ? 0 : period->lp->loopbound - 1 - iteration );
+}
+
+
+void finishLoopPeriod( loop_period *period, _Bool *active )
+{
+  if ( period == NULL ) {
+    return;
+  }
+
+  int i, s;
+  for ( s = 0; s < NUM_ACCESS_SCENARIOS; s++ ) {
+    if ( period->stopped[s] ) {
+      for ( i = 0; i < period->num_blocks; i++ ) {
+        period->blocks[i]->start_time[s] += period->shift[s];
+        period->blocks[i]->finish_time[s] += period->shift[s];
+      }
+      active[s] = 1;
     }
   }
 
+  num_loop_periods--;
+  freeResultMemo( period->memo );
+  free( period->blocks );
+  free( period->state );
+  free( period );
+}
+
+
+/* Returns the type of the access of the instruction with index 'instr_index'
+ * for the L1 and L2 classifications 'l1_result' and 'l2_result' of its block
+ * (either of them may be NULL). */
+static acc_type classifyAccess( const char *l1_result, const char *l2_result,
+                                int instr_index, enum AccessScenario scenario )
+{
+  /* If the flow is under testing mode....dont
+   * bother about CHMC. Just return all miss */
+  if ( g_testing_mode ) {
+    return L2_MISS;
+  }
+
+  switch( scenario ) {
+
+    case ACCESS_SCENARIO_BCET:
+
+      // Check level 1 analysis result
+      if ( !l1_result || l1_result[instr_index] != ALWAYS_MISS ) {
+        return L1_HIT;
+      } else
+      // Check level 2 analysis result
+      if ( !l2_result || l2_result[instr_index] != ALWAYS_MISS ) {
+        return L2_HIT;
+      }
+
+      break;
+
+    case ACCESS_SCENARIO_WCET:
+
+      // Check level 1 analysis result
+      if ( !l1_result || l1_result[instr_index] == ALWAYS_HIT ) {
+        return L1_HIT;
+      } else
+      // Check level 2 analysis result
+      if ( !l2_result || l2_result[instr_index] == ALWAYS_HIT ) {
+        return L2_HIT;
+      }
+
+      break;
+
+    default:
+      assert( 0 && "Unknown access scenario!" );
+  }
+
+  // If no better assumption can be made, assume a L2 miss
+  return L2_MISS;
+}
+
+
+/* Return the type of the instruction access L1_HIT/L2_HIT/L2_MISS
+ * This is computed from the shared cache analysis. The context
+ * is given as a context index, see header.h:num_chmc for further
+ * details.
+ *
+ * 'scenario' determines for which scenario (BCET/WCET) the access
+ * type shall be determined. */
+acc_type check_hit_miss( const block *bb, const instr *inst, 
+                         uint context, enum AccessScenario scenario )
+{
+  DSTART( "check_hit_miss" );
+  assert( bb && inst && 
+          context < bb->num_chmc &&
+          context < bb->num_chmc_L2 &&
+          "Invalid arguments!" );
+
+  // Get the index of the instruction inside the block
+  const int instr_index = getinstruction( inst,
+      (const instr**)bb->instrlist, 0, bb->num_instr - 1 );
+  const acc_type result = classifyAccess( bb->chmc[context]->hitmiss_addr,
+      bb->chmc_L2[context]->hitmiss_addr, instr_index, scenario );
+
   DACTION(
     char classification[10];
     switch( result ) {
@@ -696,28 +1084,90 @@ acc_type check_hit_miss( const block *bb, const instr *inst,
       case ACCESS_SCENARIO_WCET: sprintf( scenario_name, "WCET" );  break;
       default:                   assert( 0 && "Invalid result!" );
     }
-    DOUT( "Predicting %s for access to 0x%s (ctxt %u, %s scenario)\n",
+    DOUT( "Predicting %s for access to 0x%x (ctxt %u, %s scenario)\n",
         classification, inst->addr, context, scenario_name );
   );
   DRETURN( result );
 }
 
 
+/* Decodes the access types of the instructions of 'bb'. */
+static void decodeBlockAccessTypes( block *bb )
+{
+  const int num_contexts = MIN( bb->num_chmc, bb->num_chmc_L2 );
+  const size_t size = MAX( num_contexts * bb->num_instr, 1 );
+
+  int s;
+  for ( s = ACCESS_SCENARIO_BCET; s <= ACCESS_SCENARIO_WCET; s++ ) {
+    REALLOC( bb->acc_types[s], unsigned char*, size, "bb->acc_types[s]" );
+
+    int c;
+    for ( c = 0; c < num_contexts; c++ ) {
+      const char * const l1_result = bb->chmc[c]->hitmiss_addr;
+      const char * const l2_result = bb->chmc_L2[c]->hitmiss_addr;
+      unsigned char * const types = bb->acc_types[s] + c * bb->num_instr;
+
+      int i;
+      for ( i = 0; i < bb->num_instr; i++ ) {
+        types[i] = classifyAccess( l1_result, l2_result, i, s );
+      }
+    }
+  }
+  bb->num_acc_contexts = num_contexts;
+}
+
+
+/* Decodes the access types of all instructions in the blocks of the tasks
+ * of 'msc' from their CHMCs, for all loop contexts and both scenarios. This
+ * must be redone whenever the CHMCs change. */
+void decodeAccessTypes( MSC *msc )
+{
+  DSTART( "decodeAccessTypes" );
+
+  int t;
+  for ( t = 0; t < msc->num_task; t++ ) {
+    const task_t * const task = &msc->taskList[t];
+
+    // All procedure copies of the task, including 'main_copy'
+    int p;
+    for ( p = 0; p < task->num_proc; p++ ) {
+      const proc_copy * const copies = &task->proc_cg_ptr[p];
+
+      int c;
+      for ( c = 0; c < copies->num_proc; c++ ) {
+        const procedure * const proc = copies->proc[c];
+
+        int b;
+        for ( b = 0; b < proc->num_bb; b++ ) {
+          decodeBlockAccessTypes( proc->bblist[b] );
+        }
+      }
+    }
+  }
+
+  DEND();
+}
+
+
+const unsigned char *getAccessTypes( const block *bb, uint context,
+                                     enum AccessScenario scenario )
+{
+  assert( bb->acc_types[scenario] && context < bb->num_acc_contexts &&
+          "Access types were not decoded!" );
+  return bb->acc_types[scenario] + context * bb->num_instr;
+}
+
+
 /* Check whether the block specified in the header "bb"
  * is header of some loop in the procedure "proc" */
 loop* check_loop( const block * const bb, const procedure * const proc )
 {
-  int i;
+  if ( !bb->is_loophead )
+    return NULL;
 
-  for(i = 0; i < proc->num_loops; i++)
-  {
-     assert(proc->loops[i]); 
-     assert(proc->loops[i]->loophead); 
-     if(proc->loops[i]->loophead->bbid == bb->bbid)
-      return proc->loops[i];     
-  }
-
-  return NULL;
+  loop * const lp = proc->loops[bb->loopid];
+  assert( lp && lp->loophead->bbid == bb->bbid );
+  return lp;
 }
 
 
@@ -747,19 +1197,20 @@ uint get_core(task_t* cur_task)
 
 /* Computes the end alignment cost of a loop iteration which ends at 'fin_time'.
  * This is only needed for analyses which use the concept of aligning loops
- * to the TDMA slots to increase the analysis precision. */
+ * to the TDMA slots to increase the analysis precision. A loop is aligned if
+ * it starts at a multiple of the schedule period, which is also a start of
+ * the TDMA interval of every segment. Without a period, the offsets are not
+ * tracked and no alignment is needed. */
 ull endAlign( ull fin_time )
 {
   DSTART( "endAlign" );
 
-  const core_sched_p core_schedule = getCoreSchedule( ncore, fin_time );
-  const ull interval = core_schedule->interval;
-
+  const ull period = getScheduleInterval();
   ull align = 0;
-  if ( fin_time % interval == 0 ) {
+  if ( period == 0 || fin_time % period == 0 ) {
     align = 0;
   } else {
-    align = ( fin_time / interval + 1 ) * interval - fin_time;
+    align = ( fin_time / period + 1 ) * period - fin_time;
   }
   DOUT( "End align = %Lu\n", align );
   DRETURN( align );
@@ -768,14 +1219,12 @@ ull endAlign( ull fin_time )
 
 /* Computes the start alignment cost of a loop which starts at 'start_time'.
  * This is only needed for analyses which use the concept of aligning loops
- * to the TDMA slots to increase the analysis precision. */
+ * to the TDMA slots to increase the analysis precision, see endAlign. */
 ull startAlign( ull start_time )
 {
   DSTART( "startAlign" );
 
-  const core_sched_p core_schedule = getCoreSchedule( ncore, start_time );
-  const ull interval = core_schedule->interval;
-
-  DOUT( "Start align = %u\n", interval );
-  DRETURN( interval );
+  const ull period = getScheduleInterval();
+  DOUT( "Start align = %Lu\n", period );
+  DRETURN( period );
 }
@@ -8,9 +8,14 @@
 #define __CHRONOS_ANALYSIS_DAG_COMMON_H
 
 #include "header.h"
+#include "offsetData.h"
 
 // ######### Macros #########
 
+/* The number of access scenarios, by which the times of the DAG-based
+ * analyses are indexed. */
+#define NUM_ACCESS_SCENARIOS 2
+
 
 
 // ######### Datatype declarations  ###########
@@ -23,6 +28,20 @@ enum AccessScenario {
   ACCESS_SCENARIO_WCET
 };
 
+/* The minimum (BCET) or maximum (WCET) latency of an access over a set of
+ * TDMA offsets, see boundLatencyOverOffsets. */
+typedef struct {
+  uint latency;
+  /* Whether the extreme latency was found at an offset at which the access
+   * had to wait for the next TDMA slot, and the last such offset. */
+  _Bool has_waited_for_next_tdma_slot;
+  uint waited_offset;
+} latency_bound;
+
+/* Detects repeating iterations in an analysis which virtually unrolls a loop,
+ * see createLoopPeriod. */
+typedef struct loop_period loop_period;
+
 
 // ######### Function declarations  ###########
 
@@ -66,31 +85,62 @@ void preprocess_chmc_L2_WCET( procedure* proc );
 acc_type check_hit_miss(const block *bb, const instr *inst, 
                         uint context, enum AccessScenario scenario);
 
+/* Decodes the access types of all instructions in the blocks of the tasks
+ * of 'msc' from their CHMCs, for all loop contexts and both scenarios. This
+ * must be redone whenever the CHMCs change. */
+void decodeAccessTypes( MSC *msc );
+
+/* Returns the access types of the instructions of 'bb' in the given loop
+ * context and scenario, indexed like 'bb->instrlist'. */
+const unsigned char *getAccessTypes( const block *bb, uint context,
+                                     enum AccessScenario scenario );
+
 /* #### Structural analysis helper functions #### */
 
-/* Returns the callee procedure for a procedure call instruction */
-procedure *getCallee( const instr * const inst, const procedure * const proc);
 /* Check whether the block specified in the header "bb"
  * is header of some loop in the procedure "proc" */
 loop* check_loop( const block * const bb, const procedure * const proc);
 
 /* #### WCET/BCET analysis helper functions #### */
 
-/* This sets the earliest starting time of a block during BCET calculation
- * (Not context-aware) */
-void set_start_time_BCET( block* bb, procedure* proc );
-/* This sets the latest starting time of a block during WCET calculation.
- * (Not context-aware) */
-void set_start_time_WCET( block* bb, procedure* proc );
+/* This sets the earliest (BCET) or latest (WCET) starting time of a block
+ * in the given scenario. (Not context-aware) */
+void set_start_time( block* bb, procedure* proc,
+                     enum AccessScenario accessScenario );
 
 /* Returns the BCET of a single instruction. */
 ull getInstructionBCET( const instr *instruction );
 /* Returns the WCET of a single instruction. */
 ull getInstructionWCET( const instr *instruction );
+/* Returns the BCET or WCET of a single instruction, depending on the
+ * scenario. */
+ull getInstructionTime( const instr *instruction,
+                        enum AccessScenario accessScenario );
+
+/* Creates a detector for repeating iterations of the loop 'lp' of 'proc',
+ * whose iterations are analyzed one after the other by setting the start and
+ * finish times of its blocks in the scenarios. Returns NULL if no iterations
+ * could be skipped. This requires a periodic TDMA schedule. */
+loop_period *createLoopPeriod( loop *lp, procedure *proc );
+/* Must be called after iteration 'iteration' of the loop of 'period' was
+ * analyzed in the scenarios which are set in 'active'. If the times of all
+ * blocks in the loop (including nested loops) in a scenario, relative to the
+ * finish time of the loop sink and modulo the TDMA interval, are the same as
+ * after an earlier iteration, then the following iterations repeat the ones
+ * after that earlier iteration, shifted in time. The scenario is then removed
+ * from 'active' as soon as its times only need to be shifted over full
+ * periods to get the times after the last iteration. Returns the number of
+ * iterations to skip, which are all remaining ones if no scenario is active
+ * anymore. */
+int skipLoopPeriods( loop_period *period, int iteration, _Bool *active );
+/* Must be called after the last iteration. Shifts the times of the removed
+ * scenarios to the times after the last iteration, adds them to 'active'
+ * again and frees 'period', which may be NULL. */
+void finishLoopPeriod( loop_period *period, _Bool *active );
 
 /* Reset start and finish time of all basic blocks in this 
- * procedure */
-void reset_timestamps(procedure* proc, ull start_time);
+ * procedure to the start time of each scenario */
+void reset_timestamps(procedure* proc, const ull *start_times);
 /* Reset latest start time of all tasks in the MSC before 
  * the analysis of the MSC starts */
 void reset_all_task(MSC* msc);
@@ -110,14 +160,56 @@ uint determine_latency( const block * const bb, const ull access_time,
     const acc_type type, _Bool * const has_waited_for_next_tdma_slot,
     enum AccessScenario accessScenario );
 
+/* Computes the latency bounds which boundLatencyOverOffsets uses for TDMA
+ * schedules without a period (see getScheduleInterval). Must be called
+ * before analyzing a task on core 'ncore' with the current schedule. */
+void initScheduleLatencyBounds( void );
+
+/* Initializes 'bound' for use with boundLatencyOverOffsets. */
+void initLatencyBound( latency_bound * const bound,
+    enum AccessScenario accessScenario );
+
+/* Updates 'bound' with the latencies of an access of 'type' at all TDMA
+ * offsets in [lower_offset, upper_offset] in constant time. The result is
+ * the same as that of calling determine_latency for each offset in
+ * ascending order and keeping the minimum (BCET) / maximum (WCET) latency,
+ * where the has-waited flag and the offset are updated whenever a strictly
+ * better latency is found at an offset which waits for the next TDMA slot.
+ * Thus, the ranges of an offset set must be passed in ascending order.
+ * The offsets are those in the schedule period. For segmented schedules, the
+ * bound covers all segments, and the has-waited flag is only set if all of
+ * them have the same slot pair (see getCoreSlotPairs). Without a period, the
+ * bound covers all times. */
+void boundLatencyOverOffsets( latency_bound * const bound,
+    const uint lower_offset, const uint upper_offset, const acc_type type,
+    enum AccessScenario accessScenario );
+
+/* Like determine_latency, but for an access at a time 'time' of which only
+ * the offset in the schedule period is meaningful, e.g. because it is
+ * relative to an aligned loop start. For segmented schedules with more than
+ * one slot pair, this is the minimum (BCET) / maximum (WCET) latency over all
+ * segments. */
+uint determineOffsetLatency( const block * const bb, const ull time,
+    const acc_type type, enum AccessScenario accessScenario );
+
+/* Adds the TDMA offsets at which an access of 'type' ends, which starts at
+ * an offset in [lower_offset, upper_offset], to 'end_offsets'. The latencies
+ * are those of determine_latency, so the added offsets are exact. For
+ * segmented schedules, the end offsets of all segments are added. Without a
+ * schedule period, the start offsets are added unchanged. */
+void addAccessEndOffsets( offset_data * const end_offsets,
+    const uint lower_offset, const uint upper_offset, const acc_type type,
+    enum AccessScenario accessScenario );
+
 
 /* Computes the end alignment cost of a loop iteration which ends at 'fin_time'.
  * This is only needed for analyses which use the concept of aligning loops
- * to the TDMA slots to increase the analysis precision. */
+ * to the TDMA slots to increase the analysis precision. Loops are aligned to
+ * multiples of the schedule period, see getScheduleInterval. */
 ull endAlign( ull fin_time );
 /* Computes the start alignment cost of a loop which starts at 'start_time'.
  * This is only needed for analyses which use the concept of aligning loops
- * to the TDMA slots to increase the analysis precision. */
+ * to the TDMA slots to increase the analysis precision, see endAlign. */
 ull startAlign( ull start_time );
 
 
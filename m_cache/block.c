@@ -41,7 +41,7 @@ int getblock( int bbid, block **bblist, int start, int end )
 
   int i;
   for( i = end; i >= start; i-- ) {
-    DOUT( "Scanned block %u (0x%s)\n", bblist[i]->bbid,
+    DOUT( "Scanned block %u (0x%x)\n", bblist[i]->bbid,
         bblist[i]->instrlist[0]->addr );
 
     if( bblist[i]->bbid == bbid ) {
@@ -53,6 +53,25 @@ int getblock( int bbid, block **bblist, int start, int end )
 }
 
 
+/*
+ * Returns the index of block bbid of procedure p in the list 'topo' of p or
+ * one of its loops, -1 if not found. Only the positions recorded in the block
+ * are checked, see block:topo_index.
+ */
+int getTopoIndex( const procedure *p, int bbid, block **topo, int num_topo ) {
+
+  const block *bb = p->bblist[ bbid ];
+  int i;
+
+  for( i = 0; i < 2; i++ ) {
+    const int index = bb->topo_index[i];
+    if( index >= 0 && index < num_topo && topo[ index ]->bbid == bbid )
+      return index;
+  }
+  return -1;
+}
+
+
 /*
  * Returns:
  *  0 if addr is in the address range of bb;
@@ -175,47 +194,59 @@ block* findBlock( int addr ) {
  */
 char isBranchInstr( instr *insn ) {
 
-  return ( strcmp( insn->op, "bgez" ) == 0 || 
-	   strcmp( insn->op, "bgtz" ) == 0 ||
-	   strcmp( insn->op, "blez" ) == 0 ||
-	   strcmp( insn->op, "bne"  ) == 0 || 
-	   strcmp( insn->op, "beq"  ) == 0 ||
-	   strcmp( insn->op, "bc1f" ) == 0 || 
-	   strcmp( insn->op, "bc1t" ) == 0 );
+  switch( insn->opcode ) {
+    case OPCODE_BGEZ: case OPCODE_BGTZ: case OPCODE_BLEZ: case OPCODE_BNE:
+    case OPCODE_BEQ:  case OPCODE_BC1F: case OPCODE_BC1T:
+      return 1;
+    default:
+      return 0;
+  }
 }
 
 
 char isAssignInstr( instr *insn ) {
 
-  return ( strcmp( insn->op, "sw"  ) == 0 ||
-	   strcmp( insn->op, "sb"  ) == 0 ||
-	   strcmp( insn->op, "sbu" ) == 0 ||
-	   strcmp( insn->op, "sh"  ) == 0 );
+  switch( insn->opcode ) {
+    case OPCODE_SW: case OPCODE_SB: case OPCODE_SBU: case OPCODE_SH:
+      return 1;
+    default:
+      return 0;
+  }
 }
 
 
-char *getJumpDest( instr *insn ) {
+int getJumpDest( instr *insn ) {
 
-  // The jump destination is given in r2 ( bgez, bgtz, blez ) or r3 ( bne, beq ).
+  switch( insn->opcode ) {
+    case OPCODE_BGEZ: case OPCODE_BGTZ: case OPCODE_BLEZ:
+    case OPCODE_BNE:  case OPCODE_BEQ:
+      return insn->target;
+    default:
+      fprintf( stderr, "Unrecognized or not a jump instruction: %s\n", insn->op );
+      return -1;
+  }
+}
 
-  if( strcmp( insn->op, "bgez" ) == 0 || 
-      strcmp( insn->op, "bgtz" ) == 0 || 
-      strcmp( insn->op, "blez" ) == 0 )
-    return insn->r2;
 
-  if( strcmp( insn->op, "bne" ) == 0 || 
-      strcmp( insn->op, "beq" ) == 0 )
-    return insn->r3;
+ull getContextValue( const context_table_t *table, uint context ) {
 
-  fprintf( stderr, "Unrecognized or not a jump instruction: %s\n", insn->op );
-  return NULL;
+  if( context >= table->size )
+    return 0;
+  return table->value[context];
 }
 
 
-int hexValue( char *hexStr ) {
+void setContextValue( context_table_t *table, uint context, ull value ) {
 
-  int val;
+  if( context >= table->size ) {
+    uint size = table->size ? 2 * table->size : 1;
+    while( size <= context )
+      size *= 2;
 
-  sscanf( hexStr, "%x", &val );
-  return val;
+    REALLOC( table->value, ull*, size * sizeof( ull ), "context values" );
+    memset( table->value + table->size, 0,
+        ( size - table->size ) * sizeof( ull ) );
+    table->size = size;
+  }
+  table->value[context] = value;
 }
@@ -33,6 +33,13 @@ int getinstruction( const instr *i, const instr **ilist, int start, int end );
  */
 int getblock( int bbid, block **bblist, int start, int end );
 
+/*
+ * Returns the index of block bbid of procedure p in the list 'topo' of p or
+ * one of its loops, -1 if not found. Only the positions recorded in the block
+ * are checked, see block:topo_index.
+ */
+int getTopoIndex( const procedure *p, int bbid, block **topo, int num_topo );
+
 /*
  * Returns:
  *  0 if addr is in the address range of bb;
@@ -70,8 +77,19 @@ char isBranchInstr( instr *insn );
 
 char isAssignInstr( instr *insn );
 
-char *getJumpDest( instr *insn );
+/*
+ * Returns the target address of a conditional jump, -1 if insn is none.
+ */
+int getJumpDest( instr *insn );
+
+/*
+ * Returns the value stored for 'context' in 'table', 0 if there is none.
+ */
+ull getContextValue( const context_table_t *table, uint context );
 
-int hexValue( char *hexStr );
+/*
+ * Stores 'value' for 'context' in 'table', growing the table if needed.
+ */
+void setContextValue( context_table_t *table, uint context, ull value );
 
 #endif
@@ -61,11 +61,59 @@ static void print_TDMA_sched( FILE* fp )
 	fprintf(fp, "\n");
 }
 
-/* Find proper segment given a list of segments and a starting time */
-static segment_p find_segment(segment_p* head_seg, int nsegs, ull start_time)
+/* The index of the segment which was found last by find_segment. Successive
+ * lookups mostly ask for the same or the following segment, because the
+ * analyses walk through time in ascending order. Each thread keeps its own
+ * hint, it is only checked against the schedule before it is used. */
+static TASK_LOCAL uint last_segment = 0;
+
+/* The period of the schedule, see getScheduleInterval. Larger periods are
+ * not supported, because the offset-based analyses track sets of offsets
+ * within the period. */
+#define MAXIMUM_SCHEDULE_PERIOD ( 1U << 16 )
+static uint schedule_interval = 0;
+
+/* The slot pairs of each core, see getCoreSlotPairs. They are collected by
+ * setSchedule, so that reading them needs no synchronization. */
+static core_slot_pair **slot_pairs = NULL;
+static uint *num_slot_pairs = NULL;
+
+/* Find proper segment given a list of segments and a starting time. Segment
+ * 'i' is active from its start time until the start time of segment 'i + 1'.
+ * The first segment also covers all earlier times and the last segment stays
+ * active forever. */
+static uint find_segment( const sched_p schedule, ull start_time )
 {
-	/* FIXME*/	  
-	return NULL;	  
+  segment_p * const segs = schedule->seg_list;
+  const uint nsegs = schedule->n_segments;
+
+  /* Try the last result and its successor first. */
+  if ( last_segment < nsegs &&
+       ( last_segment == 0 || segs[last_segment]->seg_start <= start_time ) ) {
+    if ( last_segment + 1 == nsegs ||
+         start_time < segs[last_segment + 1]->seg_start ) {
+      return last_segment;
+    }
+    if ( last_segment + 2 == nsegs ||
+         start_time < segs[last_segment + 2]->seg_start ) {
+      return ++last_segment;
+    }
+  }
+
+  /* Binary search for the last segment which starts at or before the time. */
+  uint lower = 0;
+  uint upper = nsegs - 1;
+  while ( lower < upper ) {
+    const uint middle = lower + ( upper - lower + 1 ) / 2;
+    if ( segs[middle]->seg_start <= start_time ) {
+      lower = middle;
+    } else {
+      upper = middle - 1;
+    }
+  }
+
+  last_segment = lower;
+  return lower;
 }
 
 /* Return the global TDMA bus schedule set previously */
@@ -74,6 +122,18 @@ sched_p getSchedule()
 	return global_sched_data;	  
 }
 
+/* Gets the index of the segment of the current global TDMA schedule which
+ * is active at time 'time'. */
+uint getScheduleSegmentIndex( ull time )
+{
+  const sched_p glob_sched = getSchedule();
+  assert( glob_sched && "Internal error: Invalid data structures!" );
+
+  /* Find the proper segment for start time in case there are
+   * multiple segments present in the full bus schedule */
+  return ( glob_sched->n_segments > 1 ) ? find_segment( glob_sched, time ) : 0;
+}
+
 /* Gets the schedule for the core with index 'core_index' at time 'time'
  * in the current global TDMA schedule. */
 core_sched_p getCoreSchedule( uint core_index, ull time )
@@ -82,17 +142,115 @@ core_sched_p getCoreSchedule( uint core_index, ull time )
   assert(glob_sched && core_index < glob_sched->n_cores &&
       "Internal error: Invalid data structures!" );
 
-  /* Find the proper segment for start time in case there are
-   * multiple segments present in the full bus schedule */
-  segment_p cur_seg = ( glob_sched->type != SCHED_TYPE_1 )
-    ? find_segment( glob_sched->seg_list, glob_sched->n_segments, time )
-    : glob_sched->seg_list[0];
+  const segment_p cur_seg =
+    glob_sched->seg_list[getScheduleSegmentIndex( time )];
   /* Return the correct schedule entry. */
   const core_sched_p core_schedule = cur_seg->per_core_sched[core_index];
   assert(core_schedule && "Internal error: Invalid data structures!" );
   return core_schedule;
 }
 
+/* Returns the period of the schedule, see header file. */
+uint getScheduleInterval( void )
+{
+  return schedule_interval;
+}
+
+/* Returns the distinct slot pairs of a core, see header file. */
+const core_slot_pair *getCoreSlotPairs( uint core_index, uint *num_pairs )
+{
+  const sched_p glob_sched = getSchedule();
+  assert( glob_sched && core_index < glob_sched->n_cores &&
+      "Internal error: Invalid data structures!" );
+
+  *num_pairs = num_slot_pairs[core_index];
+  return slot_pairs[core_index];
+}
+
+/* Collects the distinct slot pairs of the core with index 'core_index' for
+ * getCoreSlotPairs. */
+static void collectCoreSlotPairs( const sched_p glob_sched, uint core_index )
+{
+  core_slot_pair *pairs;
+  MALLOC( pairs, core_slot_pair*, 2 * glob_sched->n_segments *
+          sizeof( core_slot_pair ), "pairs" );
+  uint n = 0;
+
+  uint i;
+  for ( i = 0; i < glob_sched->n_segments; i++ ) {
+    const core_sched_p core_schedule =
+      glob_sched->seg_list[i]->per_core_sched[core_index];
+
+    /* The next interval lies in the same or, at the end of a segment, in
+     * the following segment. */
+    uint next;
+    for ( next = i; next <= i + 1 && next < glob_sched->n_segments; next++ ) {
+      core_slot_pair pair;
+      pair.time = glob_sched->seg_list[i]->seg_start;
+      pair.interval = core_schedule->interval;
+      pair.slot_start = core_schedule->start_time;
+      pair.slot_len = core_schedule->slot_len;
+      pair.next_slot_start =
+        glob_sched->seg_list[next]->per_core_sched[core_index]->start_time;
+
+      uint j;
+      for ( j = 0; j < n; j++ ) {
+        if ( pairs[j].interval == pair.interval &&
+             pairs[j].slot_start == pair.slot_start &&
+             pairs[j].slot_len == pair.slot_len &&
+             pairs[j].next_slot_start == pair.next_slot_start ) {
+          break;
+        }
+      }
+      if ( j == n ) {
+        pairs[n++] = pair;
+      }
+    }
+  }
+
+  slot_pairs[core_index] = pairs;
+  num_slot_pairs[core_index] = n;
+}
+
+/* Returns the greatest common divisor of 'a' and 'b'. */
+static ull greatestCommonDivisor( ull a, ull b )
+{
+  while ( b != 0 ) {
+    const ull r = a % b;
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+/* Computes the value of getScheduleInterval for the current schedule. */
+static uint computeScheduleInterval( const sched_p schedule )
+{
+  if ( schedule->n_segments == 1 ) {
+    return schedule->seg_list[0]->per_core_sched[0]->interval;
+  }
+
+  ull period = 1;
+  uint i;
+  for ( i = 0; i < schedule->n_segments; i++ ) {
+    const segment_p seg = schedule->seg_list[i];
+    uint j;
+    for ( j = 0; j < schedule->n_cores; j++ ) {
+      const ull interval = seg->per_core_sched[j]->interval;
+      period = period / greatestCommonDivisor( period, interval ) * interval;
+      if ( period > MAXIMUM_SCHEDULE_PERIOD ) {
+        return 0;
+      }
+    }
+  }
+  for ( i = 1; i < schedule->n_segments; i++ ) {
+    if ( schedule->seg_list[i]->seg_start % period != 0 ) {
+      return 0;
+    }
+  }
+  return period;
+}
+
 /* Set core specific TDMA bus schedule data in a segment */
 static void set_core_specific_data(core_sched_p* head_core, int ncore, FILE* fp)
 {
@@ -117,6 +275,14 @@ static void set_core_specific_data(core_sched_p* head_core, int ncore, FILE* fp)
 static void freeScheduleData( sched_p schedule )
 {
   uint i;
+  for ( i = 0; i < schedule->n_cores; i++ ) {
+    free( slot_pairs[i] );
+  }
+  free( slot_pairs );
+  free( num_slot_pairs );
+  slot_pairs = NULL;
+  num_slot_pairs = NULL;
+
   for( i = 0; i < schedule->n_segments; i++ ) {
     segment_p const seg = schedule->seg_list[i];
 
@@ -209,6 +375,25 @@ void setSchedule(const char* sched_file)
 
 	fclose(fp);
 
+  /* The segments must be sorted and must not overlap. Their end times may
+   * be given inclusively or exclusively. */
+  for ( cur_seg = 1; cur_seg < n_segs; cur_seg++ ) {
+    const segment_p prev = global_sched_data->seg_list[cur_seg - 1];
+    const segment_p next = global_sched_data->seg_list[cur_seg];
+    if ( prev->seg_end < prev->seg_start || next->seg_start <= prev->seg_start ||
+         prev->seg_end > next->seg_start || next->seg_start - prev->seg_end > 1 )
+      prerr( "Error: TDMA bus schedule segments are not contiguous\n" );
+  }
+  last_segment = 0;
+  schedule_interval = computeScheduleInterval( global_sched_data );
+  CALLOC( slot_pairs, core_slot_pair**, ncore, sizeof( core_slot_pair* ),
+          "slot_pairs" );
+  CALLOC( num_slot_pairs, uint*, ncore, sizeof( uint ), "num_slot_pairs" );
+  uint core;
+  for ( core = 0; core < ncore; core++ ) {
+    collectCoreSlotPairs( global_sched_data, core );
+  }
+
   /* Assert that all cores have proper schedule data. */
   for ( cur_seg = 0; cur_seg < n_segs; cur_seg++ ) {
 		const segment_p cur_seg_p = global_sched_data->seg_list[cur_seg];
@@ -14,6 +14,17 @@
 // ######### Datatype declarations  ###########
 
 
+/* The slot of a core in a segment, together with the start of the core's
+ * slot in the following TDMA interval, which may belong to the next segment.
+ * The offset-based analyses bound latencies over all such pairs. */
+typedef struct {
+  ull time;             /* a time at which the segment is active */
+  uint interval;        /* the TDMA interval of the segment */
+  uint slot_start;
+  uint slot_len;
+  uint next_slot_start;
+} core_slot_pair;
+
 
 // ######### Function declarations  ###########
 
@@ -23,9 +34,28 @@ sched_p getSchedule();
 
 void setSchedule(const char* sched_file);
 
+/* Gets the index of the segment of the current global TDMA schedule which
+ * is active at time 'time'. Segment 'i' is active from its start time until
+ * the start time of segment 'i + 1', the last segment stays active. */
+uint getScheduleSegmentIndex( ull time );
+
 /* Gets the schedule for the core with index 'core_index' at time 'time'
  * in the current global TDMA schedule. */
 core_sched_p getCoreSchedule( uint core_index, ull time );
 
+/* Returns the period of the current global TDMA schedule, which is the least
+ * common multiple of the TDMA intervals of all segments, or 0 if there is
+ * none. For segmented schedules, this also requires that all segments start
+ * at multiples of the period. Then the latency of an access only depends on
+ * its offset in the period and on the segments, which the offset-based
+ * analyses bound over all segments. Without a period, they bound the
+ * latencies over all times instead. */
+uint getScheduleInterval( void );
+
+/* Returns the distinct slot pairs of the core with index 'core_index' over
+ * all segments of the current global TDMA schedule and writes their number
+ * to 'num_pairs'. */
+const core_slot_pair *getCoreSlotPairs( uint core_index, uint *num_pairs );
+
 
 #endif
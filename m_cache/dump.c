@@ -6,6 +6,7 @@
 
 #include "dump.h"
 #include "handler.h"
+#include "analysisCache_common.h"
 
 
 int printBlock( const block * const bb ) {
@@ -198,7 +199,7 @@ int printWCETProc( const procedure * const p ) {
 
 int printInstr( FILE *fptr, const instr * const insn ) {
 
-  fprintf( fptr, "%s %s %s %s %s\n", insn->addr, insn->op, insn->r1, insn->r2, insn->r3 );
+  fprintf( fptr, "%08x %s %s %s %s\n", insn->addr, insn->op, insn->r1, insn->r2, insn->r3 );
   return 0;
 }
 
@@ -388,6 +389,18 @@ int dump_callgraph()
   return 0;
 }
 
+/* Returns whether some tag of 'set' has age 'age' */
+static _Bool isAgeInCacheSet( const cache_set_t * const set, const int age )
+{
+  int i;
+  for ( i = 0; i < set->num_entry; i++ ) {
+    if ( set->age[i] == age ) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
 void dumpCacheState( const cache_state * const cs )
 {
 	int i, j, k, n;
@@ -421,14 +434,15 @@ void dumpCacheState( const cache_state * const cs )
 
 		for( k = 0; k < cache.na; k++)
 		{
-			if(cs->must[j][k]->num_entry!=0)
+			if(isAgeInCacheSet(getCacheSet(cs->must, j), k))
 			{
 				//printf("\nNO of way = %d \n", k);
 
 				//printf("\nMust \n");
 
-				for(n = 0; n < cs->must[j][k]->num_entry; n++)
-					printf(" %d ", cs->must[j][k]->entry[n]);
+				for(n = 0; n < getCacheSet(cs->must, j)->num_entry; n++)
+					if(getCacheSet(cs->must, j)->age[n] == k)
+						printf(" %d ", getCacheSet(cs->must, j)->entry[n]);
 				printf(";	");
 			}
 			else
@@ -450,14 +464,15 @@ void dumpCacheState( const cache_state * const cs )
 
 		for( k = 0; k < cache.na; k++)
 		{
-			if(cs->may[j][k]->num_entry!=0)
+			if(isAgeInCacheSet(getCacheSet(cs->may, j), k))
 			{
 				//printf("\nNO of way = %d \n", k);
 
 				//printf("\nMust \n");
 
-				for(n = 0; n < cs->may[j][k]->num_entry; n++)
-					printf(" %d ", cs->may[j][k]->entry[n]);
+				for(n = 0; n < getCacheSet(cs->may, j)->num_entry; n++)
+					if(getCacheSet(cs->may, j)->age[n] == k)
+						printf(" %d ", getCacheSet(cs->may, j)->entry[n]);
 				printf(";	");
 
 
@@ -506,14 +521,15 @@ void dumpCacheState_L2( const cache_state * const cs )
 
 		for( k = 0; k < cache_L2.na; k++)
 		{
-			if(cs->must[j][k]->num_entry!=0)
+			if(isAgeInCacheSet(getCacheSet(cs->must, j), k))
 			{
 				//printf("\nNO of way = %d \n", k);
 
 				//printf("\nMust \n");
 
-				for(n = 0; n < cs->must[j][k]->num_entry; n++)
-					printf(" %d ", cs->must[j][k]->entry[n]);
+				for(n = 0; n < getCacheSet(cs->must, j)->num_entry; n++)
+					if(getCacheSet(cs->must, j)->age[n] == k)
+						printf(" %d ", getCacheSet(cs->must, j)->entry[n]);
 				printf(";	");
 			}
 			else
@@ -535,14 +551,15 @@ void dumpCacheState_L2( const cache_state * const cs )
 
 		for( k = 0; k < cache_L2.na; k++)
 		{
-			if(cs->may[j][k]->num_entry!=0)
+			if(isAgeInCacheSet(getCacheSet(cs->may, j), k))
 			{
 				//printf("\nNO of way = %d \n", k);
 
 				//printf("\nMust \n");
 
-				for(n = 0; n < cs->may[j][k]->num_entry; n++)
-					printf(" %d ", cs->may[j][k]->entry[n]);
+				for(n = 0; n < getCacheSet(cs->may, j)->num_entry; n++)
+					if(getCacheSet(cs->may, j)->age[n] == k)
+						printf(" %d ", getCacheSet(cs->may, j)->entry[n]);
 				printf(";	");
 
 
@@ -567,8 +584,9 @@ void dump_prog_info( const procedure * const proc)
   for(i = 0; i < proc->num_bb; i++) {
     assert(proc->bblist[i]);
     const block * const bb = proc->bblist[i];
-    fprintf(fp, "Basic block id = (%d.%d.0x%x.start=%Lu.finish=%Lu)\n", proc->pid,
-        bb->bbid, (unsigned int)(uintptr_t)bb, bb->start_time, bb->finish_time);
+    fprintf(fp, "Basic block id = (%d.%d.0x%x.start=%Lu/%Lu.finish=%Lu/%Lu)\n",
+        proc->pid, bb->bbid, (unsigned int)(uintptr_t)bb, bb->start_time[0],
+        bb->start_time[1], bb->finish_time[0], bb->finish_time[1]);
     fprintf(fp, "Incoming blocks (Total = %d)======> \n", bb->num_incoming);
     for(j = 0; j < bb->num_incoming; j++) {
       fprintf(fp, "(bb=%d.%x)\n", bb->incoming[j],
@@ -601,8 +619,8 @@ void dump_prog_info( const procedure * const proc)
 
     for(j = 0; j < bb->num_instr; j++) {
       const instr * const inst = bb->instrlist[j];
-      if(IS_CALL(inst->op)) {
-        fprintf(fp, "PROCEDURE CALL ENCOUNTERED at %s\n", GET_CALLEE(inst));
+      if(IS_CALL(inst)) {
+        fprintf(fp, "PROCEDURE CALL ENCOUNTERED at %s\n", inst->r1);
         /* Ignore library calls */
         if(!proc->calls)
           continue;
@@ -631,7 +649,7 @@ void dump_pre_proc_chmc( const procedure * const proc, const enum AccessScenario
     int j;
     for(j = 0; j < bb->num_instr; j++) {
       const instr * const inst = bb->instrlist[j];
-      fprintf( stdout, "Instruction address = %s ==>\n", inst->addr );
+      fprintf( stdout, "Instruction address = %08x ==>\n", inst->addr );
 
       int k;
       for(k = 0; k < bb->num_chmc; k++) {
@@ -230,16 +230,15 @@ int execute() {
 	jal = 0;
 
 	tmp[0] = '\0';
-	if( strlen( insn->addr ) < 2 ) break;
 
 	// First we test the previous effects on the current instruction.
-	if( strcmp( insn->op, "beq" ) == 0 || strcmp( insn->op, "bne" ) == 0 ) {
+	if( insn->opcode == OPCODE_BEQ || insn->opcode == OPCODE_BNE ) {
 
 	  if( ignore )
 	    continue;
 
-	  regPos1 = findReg( insn->r1 );
-	  regPos2 = findReg( insn->r2 );
+	  regPos1 = insn->reg[0];
+	  regPos2 = insn->reg[1];
 	  // printf( "reg1(%d): %s; reg2(%d):%s\n", regPos1, reg2Mem[regPos1].mem_addr, 
 	  // regPos2, reg2Mem[regPos2].mem_addr );
 
@@ -249,7 +248,7 @@ int execute() {
 	    // r1's value is the result of slt/slti operation (0 or 1)
 	    // compared against zero (r2)
 	    
-	    if( strcmp( insn->op, "beq" ) == 0 )
+	    if( insn->opcode == OPCODE_BEQ )
 	      // jump if r1 == 0, i.e. slt is false
 	      addBranch( reg2Mem[regPos1].mem_addr, bb, reg2Mem[regPos1].value, 0, BE );
 	    else
@@ -277,27 +276,27 @@ int execute() {
 	      regval = reg2Mem[regPos1].value - reg2Mem[regPos2].value;
 	    }
 
-	    if( strcmp( insn->op, "bne" ) == 0 )
+	    if( insn->opcode == OPCODE_BNE )
 	      addBranch( reg2Mem[in_test].mem_addr, bb, regval, 0, NE );
 	    else
 	      addBranch( reg2Mem[in_test].mem_addr, bb, regval, 0, EQ );
 	  }			
 	}  		
-	else if( strcmp( insn->op, "bgez" ) == 0 || strcmp( insn->op, "blez" ) == 0 ||
-		 strcmp( insn->op, "bgtz" ) == 0 ) {
+	else if( insn->opcode == OPCODE_BGEZ || insn->opcode == OPCODE_BLEZ ||
+		 insn->opcode == OPCODE_BGTZ ) {
 
 	  if( ignore )
 	    continue;
 
 	  // only one register used, its value compared against zero
-	  regPos1 = findReg( insn->r1 );
+	  regPos1 = insn->reg[0];
 	  // printf( "reg1(%d): %s\n", regPos1, reg2Mem[regPos1].mem_addr );
 
 	  if( strlen( reg2Mem[regPos1].mem_addr ) > 0 ) {
 
-	    if( strcmp( insn->op, "bgez" ) == 0 )
+	    if( insn->opcode == OPCODE_BGEZ )
 	      addBranch( reg2Mem[regPos1].mem_addr, bb, 0 - reg2Mem[regPos1].value, 0, BE );
-	    else if( strcmp( insn->op, "bgtz" ) == 0 )
+	    else if( insn->opcode == OPCODE_BGTZ )
 	      addBranch( reg2Mem[regPos1].mem_addr, bb, 0 - reg2Mem[regPos1].value, 0, BT );
 	    else
 	      addBranch( reg2Mem[regPos1].mem_addr, bb, 0 - reg2Mem[regPos1].value, 0, SE );
@@ -306,28 +305,26 @@ int execute() {
 
 	// If the update occurs on ra[31], s8[30], sp[29], gp[28] skip the instruction 
 	// (those are system processing)
-	else if( strcmp( insn->r1, "$31" ) == 0 || strcmp( insn->r1, "$30" ) == 0 ||
-		 strcmp( insn->r1, "$29" ) == 0 || strcmp( insn->r1, "$28" ) == 0 ||
-		 strcmp( insn->r3, "$29" ) == 0 )
+	else if( ( insn->reg[0] >= 28 && insn->reg[0] <= 31 ) || insn->reg[2] == 29 )
 	  continue;
 
 	// If there is no problem with transition from current instruction to the next, 
 	// execute the current instruction.
 
-	else if( strcmp( insn->op, "lw"  ) == 0 || strcmp( insn->op, "lb"  ) == 0 ||
-		 strcmp( insn->op, "lbu" ) == 0 || strcmp( insn->op, "l.d" ) == 0 ||
-		 strcmp( insn->op, "lh"  ) == 0 ) {
+	else if( insn->opcode == OPCODE_LW || insn->opcode == OPCODE_LB ||
+		 insn->opcode == OPCODE_LBU || insn->opcode == OPCODE_LD ||
+		 insn->opcode == OPCODE_LH ) {
 
 	  // load operation
 	  // r1: destination register, r2: index from base, r3: base register
 
-	  regPos1 = findReg( insn->r1 );
-	  regPos3 = findReg( insn->r3 );
+	  regPos1 = insn->reg[0];
+	  regPos3 = insn->reg[2];
 	  // printf( "reg1(%d): %s; reg3(%d):%s\n", regPos1, reg2Mem[regPos1].mem_addr, 
 	  // regPos3, reg2Mem[regPos3].mem_addr );
 
 	  // 'calculate' mem. address that is being loaded
-	  sprintf( offset, "%d", reg2Mem[regPos3].value + atoi( insn->r2 ));
+	  sprintf( offset, "%d", reg2Mem[regPos3].value + insn->imm );
 	  strcat( tmp, offset );
 	  if( strlen( reg2Mem[regPos3].mem_addr ) > 0 ) {
 	    strcat( tmp, "pl" );
@@ -335,25 +332,25 @@ int execute() {
 	  }
 	  setReg2Mem( regPos1, tmp, 0, NIL );
 	}
-	else if( strcmp( insn->op, "sw" ) == 0 || strcmp( insn->op, "sb"  ) == 0 ||
-		 strcmp( insn->op, "sh" ) == 0 || strcmp( insn->op, "sbu" ) == 0 ) {
+	else if( insn->opcode == OPCODE_SW || insn->opcode == OPCODE_SB ||
+		 insn->opcode == OPCODE_SH || insn->opcode == OPCODE_SBU ) {
 
 	  // store operation ( assignment )
 	  // r1: source register, r2: index from base, r3: base register
 
-	  regPos1 = findReg( insn->r1 );
-	  regPos3 = findReg( insn->r3 );
+	  regPos1 = insn->reg[0];
+	  regPos3 = insn->reg[2];
 	  // printf( "reg1(%d): %s; reg3(%d):%s\n", regPos1, reg2Mem[regPos1].mem_addr, 
 	  // regPos3, reg2Mem[regPos3].mem_addr );
 
 	  // the target memory address is deri_tree[r2].mem_addr+'+'+offset
-	  sprintf( offset, "%d", reg2Mem[regPos3].value + atoi( insn->r2 ));
+	  sprintf( offset, "%d", reg2Mem[regPos3].value + insn->imm );
 	  strcat( tmp, offset ); 
 	  if( strlen( reg2Mem[regPos3].mem_addr ) > 0 ) {
 	    strcat( tmp, "pl" );
 	    strcat( tmp, reg2Mem[regPos3].mem_addr );
 	  }
-	  if( ignore && strcmp( insn->r1, REG_RETURN ) == 0 )
+	  if( ignore && insn->reg[0] == REG_RETURN )
 	    // is a return value from some function call
 	    addAssign( tmp, bb, k, 0, 1 );
 
@@ -364,106 +361,106 @@ int execute() {
 	  else
 	    addAssign( tmp, bb, k, 0, 1 );
 	}
-	else if( strcmp( insn->op, "lui" ) == 0 ) {
+	else if( insn->opcode == OPCODE_LUI ) {
 
-	  regPos1 = findReg( insn->r1 );
+	  regPos1 = insn->reg[0];
 	  // printf( "reg1(%d): %s\n", regPos1, reg2Mem[regPos1].mem_addr );
 
-	  setReg2Mem( regPos1, tmp, atoi( insn->r2 ) * 65536, NIL );
+	  setReg2Mem( regPos1, tmp, insn->imm * 65536, NIL );
 	}
-	else if( strcmp( insn->op, "addiu" ) == 0 || strcmp( insn->op, "addi" ) == 0 ) {
+	else if( insn->opcode == OPCODE_ADDIU || insn->opcode == OPCODE_ADDI ) {
 
 	  // When calling the instruction "addiu r1, r2, i" 
 
-	  regPos1 = findReg( insn->r1 );
-	  regPos2 = findReg( insn->r2 );
+	  regPos1 = insn->reg[0];
+	  regPos2 = insn->reg[1];
 	  // printf( "reg1(%d): %s; reg2(%d):%s\n", regPos1, reg2Mem[regPos1].mem_addr, 
 	  // regPos2, reg2Mem[regPos2].mem_addr );
 
 	  strcat( tmp, reg2Mem[regPos2].mem_addr );
-	  setReg2Mem( regPos1, tmp, reg2Mem[regPos2].value + atoi( insn->r3 ), NIL );
+	  setReg2Mem( regPos1, tmp, reg2Mem[regPos2].value + insn->imm, NIL );
 	}
-	else if( strcmp( insn->op, "ori" ) == 0 ) {
+	else if( insn->opcode == OPCODE_ORI ) {
 
-	  regPos1 = findReg( insn->r1 );
-	  regPos2 = findReg( insn->r2 );
+	  regPos1 = insn->reg[0];
+	  regPos2 = insn->reg[1];
 	  // printf( "reg1(%d): %s; reg2(%d):%s\n", regPos1, reg2Mem[regPos1].mem_addr, 
 	  // regPos2, reg2Mem[regPos2].mem_addr );
 
 	  strcat( tmp, reg2Mem[regPos2].mem_addr );				
-	  setReg2Mem( regPos1, tmp, reg2Mem[regPos2].value | atoi( insn->r3 ), NIL );
+	  setReg2Mem( regPos1, tmp, reg2Mem[regPos2].value | insn->imm, NIL );
 	}
-	else if( strcmp( insn->op, "andi" ) == 0 ) {
+	else if( insn->opcode == OPCODE_ANDI ) {
 
-	  regPos1 = findReg( insn->r1 );
-	  regPos2 = findReg( insn->r2 );
+	  regPos1 = insn->reg[0];
+	  regPos2 = insn->reg[1];
 	  // printf( "reg1(%d): %s; reg2(%d):%s\n", regPos1, reg2Mem[regPos1].mem_addr, 
 	  // regPos2, reg2Mem[regPos2].mem_addr );
 
 	  strcat( tmp, reg2Mem[regPos2].mem_addr );				
-	  setReg2Mem( regPos1, tmp, reg2Mem[regPos2].value & atoi( insn->r3 ), NIL );
+	  setReg2Mem( regPos1, tmp, reg2Mem[regPos2].value & insn->imm, NIL );
 	}
-	else if( strcmp( insn->op, "sll" ) == 0 ) {
+	else if( insn->opcode == OPCODE_SLL ) {
 	  // r1 = r2 * ( 2^r3 )
 
-	  regPos1 = findReg( insn->r1 );
-	  regPos2 = findReg( insn->r2 );	  
+	  regPos1 = insn->reg[0];
+	  regPos2 = insn->reg[1];	  
 	  // printf( "reg1(%d): %s; reg2(%d):%s\n", regPos1, reg2Mem[regPos1].mem_addr, 
 	  // regPos2, reg2Mem[regPos2].mem_addr );
 
 	  if( strlen( reg2Mem[regPos2].mem_addr ) > 0 ) {
 	    // r2 is a variable
 	    strcat( tmp, reg2Mem[regPos2].mem_addr );
-	    strcat( tmp, "sll" );
-	    strcat( tmp, insn->r3 );
+	    sprintf( offset, "sll%x", insn->imm );
+	    strcat( tmp, offset );
 	  }
 	  regval = reg2Mem[regPos2].value;
-	  power = hexValue( insn->r3 );
+	  power = insn->imm;
 	  for( m = 0; m < power ; m++ )
 	    regval *= 2;
 	  
 	  setReg2Mem( regPos1, tmp, regval, NIL );
 	}
-	else if( strcmp( insn->op, "srl" ) == 0 ) {
+	else if( insn->opcode == OPCODE_SRL ) {
 	  // r1 = r2 / ( 2^r3 )
 
-	  regPos1 = findReg( insn->r1 );
-	  regPos2 = findReg( insn->r2 );
+	  regPos1 = insn->reg[0];
+	  regPos2 = insn->reg[1];
 	  // printf( "reg1(%d): %s; reg2(%d):%s\n", regPos1, reg2Mem[regPos1].mem_addr, 
 	  // regPos2, reg2Mem[regPos2].mem_addr );
 
 	  if( strlen( reg2Mem[regPos2].mem_addr ) > 0 ) {
 	    // r2 is an variable
 	    strcat( tmp, reg2Mem[regPos2].mem_addr );
-	    strcat( tmp, "srl" );
-	    strcat( tmp, insn->r3 );	
+	    sprintf( offset, "srl%x", insn->imm );
+	    strcat( tmp, offset );
 	  }
 	  regval = reg2Mem[regPos2].value;
-	  power = hexValue( insn->r3 );
+	  power = insn->imm;
 	  for( m = 0; m < power ; m++ )
 	    regval /= 2;
 
 	  setReg2Mem( regPos1, tmp, regval, NIL );
 	}
-	else if( strcmp( insn->op, "slti" ) == 0 || strcmp( insn->op, "sltiu" ) == 0 ) {
+	else if( insn->opcode == OPCODE_SLTI || insn->opcode == OPCODE_SLTIU ) {
 
 	  // set r1 to 1 if r2 < r3 ( r3 constant )
 	  // r2 <  r3 -> r1 is 1 -> value >  0
 	  // r2 >= r3 -> r1 is 0 -> value <= 0
 
-	  regPos1 = findReg( insn->r1 );
-	  regPos2 = findReg( insn->r2 );
+	  regPos1 = insn->reg[0];
+	  regPos2 = insn->reg[1];
 	  // printf( "reg1(%d): %s; reg2(%d):%s\n", regPos1, reg2Mem[regPos1].mem_addr, 
 	  // regPos2, reg2Mem[regPos2].mem_addr );
 
 	  strcat( tmp, reg2Mem[regPos2].mem_addr );
-	  setReg2Mem( regPos1, tmp, atoi( insn->r3 ) - reg2Mem[regPos2].value, SLTI );
+	  setReg2Mem( regPos1, tmp, insn->imm - reg2Mem[regPos2].value, SLTI );
 	}
-	else if( strcmp( insn->op, "slt" ) == 0 || strcmp( insn->op, "sltu" ) == 0 ) {
+	else if( insn->opcode == OPCODE_SLT || insn->opcode == OPCODE_SLTU ) {
 
-	  regPos1 = findReg( insn->r1 );
-	  regPos2 = findReg( insn->r2 );
-	  regPos3 = findReg( insn->r3 );
+	  regPos1 = insn->reg[0];
+	  regPos2 = insn->reg[1];
+	  regPos3 = insn->reg[2];
 	  // printf( "reg1(%d): %s; reg2(%d):%s; reg3(%d):%s\n", regPos1, reg2Mem[regPos1].mem_addr, 
 	  // regPos2, reg2Mem[regPos2].mem_addr, regPos3, reg2Mem[regPos3].mem_addr );
 
@@ -479,11 +476,11 @@ int execute() {
 	    setReg2Mem( regPos1, tmp, reg2Mem[regPos3].value - reg2Mem[regPos2].value, KO );
 	  }
 	}
-	else if( strcmp( insn->op, "addu" ) == 0 ) {
+	else if( insn->opcode == OPCODE_ADDU ) {
 
-	  regPos1 = findReg( insn->r1 );
-	  regPos2 = findReg( insn->r2 );
-	  regPos3 = findReg( insn->r3 );
+	  regPos1 = insn->reg[0];
+	  regPos2 = insn->reg[1];
+	  regPos3 = insn->reg[2];
 	  // printf( "reg1(%d): %s; reg2(%d):%s; reg3(%d):%s\n", regPos1, reg2Mem[regPos1].mem_addr, 
 	  // regPos2, reg2Mem[regPos2].mem_addr, regPos3, reg2Mem[regPos3].mem_addr );
 
@@ -503,11 +500,11 @@ int execute() {
 	  }
 	  setReg2Mem( regPos1, tmp, reg2Mem[regPos2].value + reg2Mem[regPos3].value, NIL );
 	}
-	else if( strcmp( insn->op, "subu" ) == 0 ) {
+	else if( insn->opcode == OPCODE_SUBU ) {
 
-	  regPos1 = findReg( insn->r1 );
-	  regPos2 = findReg( insn->r2 );
-	  regPos3 = findReg( insn->r3 );
+	  regPos1 = insn->reg[0];
+	  regPos2 = insn->reg[1];
+	  regPos3 = insn->reg[2];
 	  // printf( "reg1(%d): %s; reg2(%d):%s; reg3(%d):%s\n", regPos1, reg2Mem[regPos1].mem_addr, 
 	  // regPos2, reg2Mem[regPos2].mem_addr, regPos3, reg2Mem[regPos3].mem_addr );
 
@@ -527,11 +524,11 @@ int execute() {
 	  }
 	  setReg2Mem( regPos1, tmp, reg2Mem[regPos2].value - reg2Mem[regPos3].value, NIL );
 	}
-	else if( strcmp( insn->op, "or" ) == 0 ) {
+	else if( insn->opcode == OPCODE_OR ) {
 
-	  regPos1 = findReg( insn->r1 );
-	  regPos2 = findReg( insn->r2 );
-	  regPos3 = findReg( insn->r3 );
+	  regPos1 = insn->reg[0];
+	  regPos2 = insn->reg[1];
+	  regPos3 = insn->reg[2];
 	  // printf( "reg1(%d): %s; reg2(%d):%s; reg3(%d):%s\n", regPos1, reg2Mem[regPos1].mem_addr, 
 	  // regPos2, reg2Mem[regPos2].mem_addr, regPos3, reg2Mem[regPos3].mem_addr );
 
@@ -551,10 +548,10 @@ int execute() {
 	  }
 	  setReg2Mem( regPos1, tmp, reg2Mem[regPos2].value | reg2Mem[regPos3].value, NIL );
 	}
-	else if( strcmp( insn->op, "jal" ) == 0 )
+	else if( insn->opcode == OPCODE_JAL )
 	  jal = 1;
 
-	else if( strcmp( insn->op, "j" ) == 0 );
+	else if( insn->opcode == OPCODE_J );
 
   printf( "Ignoring opcode: %s\n", insn->op );
 
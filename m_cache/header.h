@@ -79,8 +79,7 @@
 #define LOOP 2
 
 // Helper declarations
-#define IS_CALL(x) ((strcmp((x), "jal") == 0) ? 1 : 0)
-#define GET_CALLEE(x) (x->r1)
+#define IS_CALL(x) ((x)->opcode == OPCODE_JAL)
 
 
 // ######### Datatype declarations  ###########
@@ -90,6 +89,13 @@ typedef unsigned short ushort;
 typedef unsigned int uint;
 typedef unsigned long long ull;
 
+/* Whether a block is the exit of a loop. If it exits several loops, the
+ * first of them in the loop list of the procedure counts. */
+enum LoopExitType
+{
+  LOOP_EXIT_NONE = 0, LOOP_EXIT_MAIN, LOOP_EXIT_SECONDARY
+};
+
 /* Helper enum to form loop contexts with the 'loop_level_arr' */
 enum LoopLevelStates
 {
@@ -106,15 +112,52 @@ enum AnalysisType
 
 struct procs;
 
+/* The opcodes which are distinguished by the analyses. All other opcodes are
+ * decoded as OPCODE_OTHER. */
+enum InstrOpcode
+{
+  OPCODE_OTHER = 0,
+  OPCODE_ADDI, OPCODE_ADDIU, OPCODE_ADDU, OPCODE_ANDI, OPCODE_BC1F,
+  OPCODE_BC1T, OPCODE_BEQ, OPCODE_BGEZ, OPCODE_BGTZ, OPCODE_BLEZ, OPCODE_BNE,
+  OPCODE_J, OPCODE_JAL, OPCODE_LB, OPCODE_LBU, OPCODE_LD, OPCODE_LH,
+  OPCODE_LUI, OPCODE_LW, OPCODE_OR, OPCODE_ORI, OPCODE_SB, OPCODE_SBU,
+  OPCODE_SH, OPCODE_SLL, OPCODE_SLT, OPCODE_SLTI, OPCODE_SLTIU, OPCODE_SLTU,
+  OPCODE_SRL, OPCODE_SUBU, OPCODE_SW
+};
+
+/* Register number of an operand which is no register. The registers $0-$31
+ * are numbered 0-31, $f0-$f31 are numbered 34-65 and $fcc is 66. */
+#define NO_REGISTER -1
+
+/* An instruction. It is decoded once when it is read (see readInstr), the
+ * textual operands are only kept for dumps. */
 typedef struct
 {
-  char addr[OP_LEN];
+  uint addr;
+  enum InstrOpcode opcode;
+  /* The register numbers of the operands r1, r2 and r3. */
+  signed char reg[3];
+  /* The immediate operand (offset of loads and stores, constant operand,
+   * shift amount), 0 if there is none. */
+  int imm;
+  /* The target address of branches and jumps, 0 if there is none. */
+  uint target;
+  /* The procedure called by a 'jal' within the procedure copies of its
+   * task, NULL for library calls and all other instructions. It is resolved
+   * by constructAll. */
+  struct procs *callee;
+
   char op[OP_LEN];
   char r1[OP_LEN];
   char r2[OP_LEN];
   char r3[OP_LEN];
 } instr;
 
+/* Cache levels that the abstract cache analysis supports */
+#define CACHE_LEVEL_L1 0
+#define CACHE_LEVEL_L2 1
+#define MAX_CACHE_LEVELS 3
+
 /* Cache configuration for a specific cache level. */
 typedef struct
 {
@@ -161,6 +204,16 @@ typedef struct
   uint wcost_copy;
 } CHMC;
 
+//values of a block or loop per loop context (the CHMC index, see
+//block::chmc), for the contexts the analysis stores a value for. The table
+//is allocated when the first value is stored and grows with the contexts,
+//see block.h:setContextValue.
+typedef struct
+{
+  ull *value;
+  uint size; // number of contexts in 'value'
+} context_table_t;
+
 //one way of a cache line  data structure
 typedef struct
 {
@@ -168,12 +221,42 @@ typedef struct
   int *entry; // entry address
 } cache_line_way_t;
 
+//one set of an abstract cache state: the tags (tag + set number of a
+//memory block) it holds, each with its age (= the way it is in, 0 is
+//the youngest way)
+//A set is a single block holding this header and its tag slots. Sets are
+//shared between cache states and copied only before being modified, see
+//analysisCache_common.c.
+typedef struct
+{
+  unsigned int refcount; // number of pages using this set
+  unsigned short num_entry; // number of used tag slots
+  unsigned short capacity; // number of tag slots
+  int *entry; // tag slots
+  unsigned char *age; // age of each tag slot
+} cache_set_t;
+
+#define CACHE_PAGE_BITS 5
+#define CACHE_PAGE_SIZE ( 1 << CACHE_PAGE_BITS )
+
+//the sets of CACHE_PAGE_SIZE consecutive set numbers, shared between
+//cache states like the sets themselves
+typedef struct
+{
+  unsigned int refcount; // number of cache states using this page
+  cache_set_t *set[CACHE_PAGE_SIZE];
+} cache_page_t;
+
 //one of the cache states  for a bb
+//The state is a single block holding this header and the page pointers of
+//all three analyses.
 typedef struct
 {
-  cache_line_way_t *** must; //must cache state
-  cache_line_way_t *** may; //may cache state
-  cache_line_way_t *** persist; //persist cache state
+  cache_page_t ** must; //must cache state, 'num_pages' pages
+  cache_page_t ** may; //may cache state
+  cache_page_t ** persist; //persist cache state
+  int num_sets;
+  int num_pages;
 
 //block *source_bb;
 } cache_state;
@@ -198,7 +281,13 @@ typedef struct
   uint cost; // block execution time
 
   int loopid; // id of the (innermost) loop it participates in; -1 if not in loop
-  char is_loophead;
+  char is_loophead; // if set, the block heads the loop 'loopid'
+  /* The positions of the block in the 'topo' lists which contain it, -1 if
+   * unused. A block is contained in the list of its innermost loop (or of its
+   * procedure), a loop head also in the list which surrounds its loop. Set up
+   * by topo_sort, see getTopoIndex. */
+  int topo_index[2];
+  char loop_exit_type; // see enum LoopExitType, set up by topo_sort
   instr **instrlist; // list of assembly instructions in the block
   int num_instr;
 
@@ -222,8 +311,17 @@ typedef struct
   CHMC **chmc, **chmc_L2;
   int num_chmc, num_chmc_L2;
 
-  cache_state *bb_cache_state, *bb_cache_state_L2;
-  int num_cache_state, num_cache_state_L2;
+  /* The access types (acc_type) of the instructions, decoded from the CHMCs by
+   * decodeAccessTypes for both scenarios (ACCESS_SCENARIO_BCET/_WCET). The type
+   * of instruction 'i' in loop context 'c' is acc_types[scenario][c * num_instr + i].
+   * There are 'num_acc_contexts' contexts. */
+  unsigned char *acc_types[2];
+  int num_acc_contexts;
+
+  /* The abstract cache state of the block for each analysed cache level, indexed
+   * by CACHE_LEVEL_L1, CACHE_LEVEL_L2, ... (see analysisCache_level.h) */
+  cache_state *bb_cache_state[MAX_CACHE_LEVELS];
+  int num_cache_state[MAX_CACHE_LEVELS];
   struct procs* proc_ptr;
 
   int num_access;
@@ -232,11 +330,13 @@ typedef struct
   int num_cache_fetch_L2;
 
   /* sudiptac :: needed for WCET aanalysis with shared data bus */
-  /* The loop contexts in the following are the indexes into the 'chmc' field. */
-  ull start_time; // The latest starting time of the block (only valid, if it is in the function's body and not in a loop)
-  ull finish_time; // The latest finishing time of the block (only valid, if it is in the function's body and not in a loop)
-  ull start_opt[64]; // The latest starting time of the block depending on its loop context (only valid, if it is in a loop)
-  ull fin_opt[64]; // The latest finishing time of the block depending on its loop context (only valid, if it is in a loop)
+  /* The loop contexts in the following are the indexes into the 'chmc' field.
+   * The times are indexed by the scenario (ACCESS_SCENARIO_BCET/_WCET), giving
+   * the earliest and the latest times. */
+  ull start_time[2]; // The starting time of the block (only valid, if it is in the function's body and not in a loop)
+  ull finish_time[2]; // The finishing time of the block (only valid, if it is in the function's body and not in a loop)
+  context_table_t start_opt[2]; // The starting time of the block depending on its loop context (only valid, if it is in a loop)
+  context_table_t fin_opt[2]; // The finishing time of the block depending on its loop context (only valid, if it is in a loop)
 
   /* The total BCET that this block causes in the course of a full BCET analysis.
    * (Mainly used for statistical purposes.) */
@@ -304,10 +404,8 @@ typedef struct
   char num_fm_L2;
 
   char *wpath; // wcet path, a binary sequence (as string) reflecting branch choices
-  ull start_opt[64]; // The starting time of the loop depending on its loop context (see block:chmc above)
-  ull fin_opt[64]; // The finishing time of the loop depending on its loop context (see block:chmc above)
-  ull bcet_opt[64]; // The BCET of the loop depending on its loop context (see block:chmc above)
-  ull wcet_opt[64]; // The WCET of the loop depending on its loop context (see block:chmc above)
+  context_table_t bcet_opt; // The BCET of the loop depending on its loop context (see block:chmc above)
+  context_table_t wcet_opt; // The WCET of the loop depending on its loop context (see block:chmc above)
 
   /* The total BCET that this loop causes in the course of a full BCET analysis.
    * (Mainly used for statistical purposes.) */
@@ -340,9 +438,10 @@ typedef struct procs
   char *hit_cache_set_L2;
   cache_line_way_t *hit_addr;
 
-  /* Required for WCET calculation in presence of shared bus */
-  ull running_cost;
-  ull running_finish_time;
+  /* Required for WCET calculation in presence of shared bus, indexed by the
+   * scenario (ACCESS_SCENARIO_BCET/_WCET) like the times of the blocks */
+  ull running_cost[2];
+  ull running_finish_time[2];
 
   /* The total BCET that this procedure causes in the course of a full BCET analysis.
    * (Mainly used for statistical purposes.) */
@@ -410,6 +509,14 @@ typedef enum
   SCHED_TYPE_1 = 0, SCHED_TYPE_2, SCHED_TYPE_3
 } sched_type;
 
+/* Solvers for the flow problems of the graph-tracking loop analysis */
+enum ILPSolver
+{
+  ILP_BUILTIN = 0, /* The built-in solver, no external program needed */
+  ILP_CPLEX,       /* The CPLEX solver */
+  ILP_LPSOLVE      /* The lp_solve solver */
+};
+
 struct core_sched
 {
   ull start_time; /* starting time of the first slot for the core */
@@ -447,29 +554,35 @@ typedef struct schedule* sched_p;
 #define EXTERN extern
 #endif
 
+/* The context of the front end of a task (reading the CFG, loop detection,
+   private cache analysis) lives in the globals marked TASK_LOCAL. Each
+   thread has its own copy of them, so the front ends of the tasks of an MSC
+   can run concurrently (see analyseTaskFrontEnds in main.c). */
+#define TASK_LOCAL __thread
+
 EXTERN char *interferePathName;
-EXTERN char *filename;
+EXTERN TASK_LOCAL char *filename;
 
 EXTERN char *numConflictTask; //to sum up number of tasks that map to the same cache set
 EXTERN char *numConflictMSC; //to sum up number of tasks that map to the same cache set within one MSC
 
-EXTERN char infeas; // infeasibility checking on/off
+EXTERN TASK_LOCAL char infeas; // infeasibility checking on/off
 
-EXTERN procedure **procs; // list of procedures in the program
-EXTERN int num_procs;
-EXTERN int main_id; // id of main procedure
-EXTERN int *proc_cg; // reverse topological order of procedure call graph
+EXTERN TASK_LOCAL procedure **procs; // list of procedures in the program
+EXTERN TASK_LOCAL int num_procs;
+EXTERN TASK_LOCAL int main_id; // id of main procedure
+EXTERN TASK_LOCAL int *proc_cg; // reverse topological order of procedure call graph
 
 EXTERN MSC **msc;
 
-EXTERN int total_bb; // total number of basic blocks in the whole program
+EXTERN TASK_LOCAL int total_bb; // total number of basic blocks in the whole program
 
 EXTERN int times_iteration;
 EXTERN int num_core;
 EXTERN cache_t cache, cache_L2;
 
-EXTERN int *loop_level_arr;
-EXTERN procedure *main_copy;
+EXTERN TASK_LOCAL int *loop_level_arr;
+EXTERN TASK_LOCAL procedure *main_copy;
 /*
  * Declarations for WCET analysis.
  */
@@ -509,5 +622,23 @@ EXTERN uint g_independent_task;
 EXTERN uint g_private;
 /* Set if no bus modelling is turned on */
 EXTERN uint g_no_bus_modeling;
+/* Number of worker processes the cache analysis of a level is split over */
+EXTERN uint g_cache_analysis_workers;
+/* Number of threads running the front ends of the tasks of an MSC */
+EXTERN uint g_front_end_threads;
+/* Number of cache configurations of a sweep which are analysed at a time */
+EXTERN uint g_sweep_processes;
+/* Directory of the stored cache analysis results and flow problem
+ * solutions, NULL if results are neither looked up nor stored */
+EXTERN const char *g_cache_result_store;
+/* Bound on the memory used to buffer intermediate results, in bytes. The
+ * alignment-aware analysis of a task buffers its results in one half, the
+ * graph-tracking loop analysis its ET and offset flow problem solutions in
+ * a quarter each. The loop periods of the unrolling analysis, which
+ * runs on its own, use half of it for the outermost loop and half of the
+ * remaining memory for each nested one. */
+EXTERN ull g_result_memo_cap;
+/* Solver of the flow problems of the graph-tracking loop analysis */
+EXTERN enum ILPSolver g_ilp_solver;
 
 #endif
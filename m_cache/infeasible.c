@@ -18,42 +18,6 @@
 
 int initRegSet() {
 
-  strcpy( regName[0] , "$0"  ); strcpy( regName[1] , "$1"  ); 
-  strcpy( regName[2] , "$2"  ); strcpy( regName[3] , "$3"  );	
-  strcpy( regName[4] , "$4"  ); strcpy( regName[5] , "$5"  ); 
-  strcpy( regName[6] , "$6"  ); strcpy( regName[7] , "$7"  );	
-  strcpy( regName[8] , "$8"  ); strcpy( regName[9] , "$9"  ); 
-  strcpy( regName[10], "$10" ); strcpy( regName[11], "$11" );	
-  strcpy( regName[12], "$12" ); strcpy( regName[13], "$13" ); 
-  strcpy( regName[14], "$14" ); strcpy( regName[15], "$15" );	
-  strcpy( regName[16], "$16" ); strcpy( regName[17], "$17" ); 
-  strcpy( regName[18], "$18" ); strcpy( regName[19], "$19" );	
-  strcpy( regName[20], "$20" ); strcpy( regName[21], "$21" ); 
-  strcpy( regName[22], "$22" ); strcpy( regName[23], "$23" );	
-  strcpy( regName[24], "$24" ); strcpy( regName[25], "$25" ); 
-  strcpy( regName[26], "$26" ); strcpy( regName[27], "$27" );	
-  strcpy( regName[28], "$28" ); strcpy( regName[29], "$29" ); 
-  strcpy( regName[30], "$30" ); strcpy( regName[31], "$31" );
-  
-  strcpy( regName[34], "$f0"  ); strcpy( regName[35], "$f1"  ); 
-  strcpy( regName[36], "$f2"  ); strcpy( regName[37], "$f3"  );
-  strcpy( regName[38], "$f4"  ); strcpy( regName[39], "$f5"  ); 
-  strcpy( regName[40], "$f6"  ); strcpy( regName[41], "$f7"  );
-  strcpy( regName[42], "$f8"  ); strcpy( regName[43], "$f9"  ); 
-  strcpy( regName[44], "$f10" ); strcpy( regName[45], "$f11" );
-  strcpy( regName[46], "$f12" ); strcpy( regName[47], "$f13" ); 
-  strcpy( regName[48], "$f14" ); strcpy( regName[49], "$f15" );
-  strcpy( regName[50], "$f16" ); strcpy( regName[51], "$f17" ); 
-  strcpy( regName[52], "$f18" ); strcpy( regName[53], "$f19" );
-  strcpy( regName[54], "$f20" ); strcpy( regName[55], "$f21" ); 
-  strcpy( regName[56], "$f22" ); strcpy( regName[57], "$f23" );
-  strcpy( regName[58], "$f24" ); strcpy( regName[59], "$f25" ); 
-  strcpy( regName[60], "$f26" ); strcpy( regName[61], "$f27" );
-  strcpy( regName[62], "$f28" ); strcpy( regName[63], "$f29" ); 
-  strcpy( regName[64], "$f30" ); strcpy( regName[65], "$f31" );
-  
-  strcpy( regName[66], "$fcc" );	
-  
   reg2Mem[0].mem_addr[0] = '\0';
   reg2Mem[0].value = 0;
   reg2Mem[0].valid = 1;
@@ -90,18 +54,6 @@ int clearReg() {
 }
 
 
-int findReg( char key[] ) {
-
-  int i;
-  for( i = 0; i < NO_REG; i++ ) { 
-    if( strcmp( key, regName[i] ) == 0 )
-      return i; 
-  }
-
-  return -1;
-}
-
-
 int neg( int a ) {
 
   if( a == BT ) return SE;
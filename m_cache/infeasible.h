@@ -16,7 +16,7 @@
 // ######### Macros #########
 
 
-#define REG_RETURN regName[2]
+#define REG_RETURN 2
 // the register where return value of a function call is stored (by observation)
 
 #define DERI_LEN 800   // length of register derivation tree
@@ -96,8 +96,6 @@ int initRegSet();
 
 int clearReg();
 
-int findReg( char key[] );
-
 int neg( int a );
 
 /*
@@ -129,7 +127,6 @@ int initInfeas();
 #define EXTERN extern
 #endif
 
-EXTERN char regName[NO_REG][OP_LEN];
 EXTERN deri_tree reg2Mem[NO_REG];     // reg2Mem[i]: current memory address of register i
 
 EXTERN int    **num_assign;           // num_assign[i][j]: #assign effects in proc i block j
@@ -1,8 +1,16 @@
+// getopt, fork and strdup are not part of C99
+#define _DEFAULT_SOURCE
+
 // Include standard library headers
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 
 // Include local library headers
 #ifdef HAVE_CONFIG_H
@@ -30,11 +38,10 @@
 //#include "DAG_WCET.h"
 #include "topo.h"
 //#include "analysisILP.h"
-#include "analysisDAG_BCET_structural.h"
-#include "analysisDAG_BCET_unroll.h"
+#include "analysisDAG_common.h"
 #include "analysisDAG_ET_alignment.h"
-#include "analysisDAG_WCET_structural.h"
-#include "analysisDAG_WCET_unroll.h"
+#include "analysisDAG_ET_structural.h"
+#include "analysisDAG_ET_unroll.h"
 //#include "analysisEnum.h"
 #include "analysisCache_L1.h"
 #include "analysisCache_L2.h"
@@ -58,6 +65,25 @@ enum AnalysisMethod {
     ANALYSIS_ALIGNMENT
 };
 
+// An analysis method as given on the command line
+typedef struct {
+  const char *name; // the method as spelled on the command line, e.g. "acr+"
+  enum AnalysisMethod method;
+  // Options of the alignment analysis
+  enum LoopAnalysisType alignmentLAType;
+  _Bool alignmentTryStructural;
+  enum OffsetDataType offsetDataType;
+  // Statistics file to which the results of the method will be written
+  char statfileName[MAX_LEN];
+} analysis_method_t;
+
+// The tasks of an MSC which the front end threads take their next task from
+typedef struct {
+  MSC *msc;
+  int next_task;
+  void (*run)( task_t *task, int task_id ); // what to do for each task
+} front_end_queue_t;
+
 
 // #########################################
 // #### Declaration of static variables ####
@@ -67,8 +93,20 @@ enum AnalysisMethod {
 /* Stores whether the debugmacros have already been initialized for this file. */
 static _Bool firstDebugmacroInit = 1;
 
-/* Statistics file to which analysis results will be written. */
-char statfileName[MAX_LEN];
+/* The methods which 'all' stands for on the command line */
+static const char * const allAnalysisMethods[] = {
+  "n", "s", "u", "acr", "acr+", "acs", "acs+", "agr", "agr+", "ags", "ags+",
+  "agt"
+};
+
+/* The methods which 'all+' stands for on the command line: those of 'all'
+ * and the ones with the interval list offsets and the max-plus loop
+ * analysis */
+static const char * const extendedAnalysisMethods[] = {
+  "n", "s", "u", "acr", "acr+", "acs", "acs+", "aci", "aci+", "agr", "agr+",
+  "ags", "ags+", "agi", "agi+", "agt", "amr", "amr+", "ams", "ams+", "ami",
+  "ami+", "amt"
+};
 
 
 // #########################################
@@ -76,14 +114,28 @@ char statfileName[MAX_LEN];
 // #########################################
 
 
+static int parseAnalysisMethods( const char *list,
+                                 analysis_method_t **methods );
+static int parseAnalysisMethodNames( const char * const *names, int num,
+                                     analysis_method_t **methods );
 static void analysis( MSC *msc, const char *tdma_bus_schedule_file,
-                      enum AnalysisMethod method,
-                      enum LoopAnalysisType alignmentAnalysisLAType,
-                      _Bool alignmentAnalysisTryStructural,
-                      enum OffsetDataType offsetDataType );
+                      const analysis_method_t *method );
 static void readMSCfromFile( const char *interferFileName, int msc_index,
                              _Bool *interference_changed );
 static void writeWCETandCacheInfoFiles( int num_msc );
+static void analyseTaskFrontEnds( MSC *msc,
+                                  void (*run)( task_t *task, int task_id ) );
+static void analyseMSC( MSC *msc, const char *tdma_bus_schedule_file,
+                        const analysis_method_t *methods, int num_methods,
+                        FILE *table, const char *table_prefix );
+static void runOnTasks( MSC *msc, void (*run)( task_t *task, int task_id ) );
+static void parseTask( task_t *task, int task_id );
+static void analyseTaskFrontEnd( task_t *task, int task_id );
+static void sweepCacheConfigs( int num_msc, char **l1, int num_l1,
+                               char **l2, int num_l2,
+                               const char *tdma_bus_schedule_file,
+                               analysis_method_t *methods, int num_methods );
+static int splitList( const char *list, char ***items );
 
 #ifdef WITH_WEI_COMPARISON
 static void writeWeiComparison( int num_msc, const char *finalStatsBasename );
@@ -122,6 +174,69 @@ int main(int argc, char **argv )
   g_no_bus_modeling = 0;
   /* For private L2 cache analysis */
   g_private = 0;
+  /* Analyse all cache sets in this process */
+  g_cache_analysis_workers = 1;
+  /* Analyse one task after the other */
+  g_front_end_threads = 1;
+  /* Analyse one cache configuration after the other */
+  g_sweep_processes = 1;
+  /* Always run the cache analysis */
+  g_cache_result_store = NULL;
+  /* Buffer up to 1 GB of alignment analysis results */
+  g_result_memo_cap = 1024ULL << 20;
+  /* Solve the flow problems of the loop analysis without external tools */
+  g_ilp_solver = ILP_BUILTIN;
+
+  /* Options precede the positional arguments */
+  int opt;
+  while ( ( opt = getopt( argc, argv, "+c:j:m:p:s:t:" ) ) != -1 ) {
+    switch ( opt ) {
+      case 'c':
+        g_cache_result_store = optarg;
+        break;
+      case 'j':
+        g_cache_analysis_workers = atoi( optarg );
+        break;
+      case 'm':
+        g_result_memo_cap = strtoull( optarg, NULL, 10 ) << 20;
+        break;
+      case 'p':
+        g_sweep_processes = atoi( optarg );
+        break;
+      case 's':
+        if ( strcmp( optarg, "builtin" ) == 0 ) {
+          g_ilp_solver = ILP_BUILTIN;
+        } else if ( strcmp( optarg, "cplex" ) == 0 ) {
+          g_ilp_solver = ILP_CPLEX;
+        } else if ( strcmp( optarg, "lp_solve" ) == 0 ) {
+          g_ilp_solver = ILP_LPSOLVE;
+        } else {
+          argc = 0;
+        }
+        break;
+      case 't':
+        g_front_end_threads = atoi( optarg );
+        break;
+      default:
+        argc = 0;
+        break;
+    }
+  }
+  argv += optind - 1;
+  argc -= optind - 1;
+  if ( argc < 7 ) {
+    fprintf( stderr, "Usage: opt [-c <cache result store>] [-j <cache analysis workers>] "
+        "[-m <result buffer MB>] [-p <sweep processes>] "
+        "[-s builtin|cplex|lp_solve] [-t <task threads>] <interference path> <L1 configs> <L2 configs> <number of cores> "
+        "<TDMA schedule> <methods>\n" );
+    exit( 1 );
+  }
+
+  /* The cache analysis workers are forked, which other threads running at
+   * the same time could leave with locks nobody releases */
+  if ( g_cache_analysis_workers > 1 && g_front_end_threads > 1 ) {
+    prerr( "Error: -j and -t can not be combined\n" );
+  }
 
   /* also read conflict info and tasks info */
   interferePathName = argv[1];
@@ -129,38 +244,25 @@ int main(int argc, char **argv )
   const char * const tdma_bus_schedule_file = argv[5];
   infeas = 0;
 
-  /* Set the analysis method to use. */
-  enum AnalysisMethod current_analysis_method = ANALYSIS_ALIGNMENT;
-  enum LoopAnalysisType alignmentLAType = LOOP_ANALYSIS_GLOBAL_CONVERGENCE;
-  enum OffsetDataType offsetDataType = OFFSET_DATA_TYPE_RANGE;
-  _Bool alignmentTryStructural = 0;
-  switch( argv[6][0] ) {
-    case 'a':
-      current_analysis_method = ANALYSIS_ALIGNMENT;
-      for ( i = 1; argv[6][i] != '\0'; i++ ) {
-        char option_char = argv[6][i];
-        switch( option_char ) {
-          case 'c': alignmentLAType = LOOP_ANALYSIS_GLOBAL_CONVERGENCE; break;
-          case 'g': alignmentLAType = LOOP_ANALYSIS_GRAPH_TRACKING; break;
-          case 'r': offsetDataType = OFFSET_DATA_TYPE_RANGE; break;
-          case 's': offsetDataType = OFFSET_DATA_TYPE_SET; break;
-          case 't': offsetDataType = OFFSET_DATA_TYPE_TIME_RANGE; break;
-          case '+': alignmentTryStructural = 1; break;
-          default: assert( 0 && "Unknown option!" );
-        }
-      }
-      break;
-    case 'n':
-      current_analysis_method = ANALYSIS_NONE;
-      break;
-    case 's':
-      current_analysis_method = ANALYSIS_STRUCTURAL;
-      break;
-    case 'u':
-      current_analysis_method = ANALYSIS_UNROLL;
-      break;
-    default:
-      assert( 0 && "Unknown analysis method!" );
+  /* Set the analysis methods to use. All of them are run after the same
+   * front end and cache analysis. */
+  analysis_method_t *methods;
+  const int num_methods = parseAnalysisMethods( argv[6], &methods );
+  if ( num_methods > 1 && !g_independent_task ) {
+    prerr( "Error: The WCRT analysis needs a single analysis method\n" );
+  }
+
+  /* Several L1 and L2 configurations are analysed for all of their
+   * combinations, the tasks are only parsed once for all of them. */
+  char **l1_configs, **l2_configs;
+  const int num_l1_configs = splitList( argv[2], &l1_configs );
+  const int num_l2_configs = splitList( argv[3], &l2_configs );
+  if ( num_l1_configs == 0 || num_l2_configs == 0 ) {
+    prerr( "Error: No cache configuration given\n" );
+  }
+  const _Bool sweep = num_l1_configs * num_l2_configs > 1;
+  if ( sweep && !g_independent_task ) {
+    prerr( "Error: The WCRT analysis needs a single cache configuration\n" );
   }
 
   /* sudiptac :: Allocate the earliest/latest start time structure for
@@ -169,8 +271,8 @@ int main(int argc, char **argv )
   CALLOC( latest_core_time, ull *, num_core, sizeof(ull), "latest_core_time" );
 
   /* Set the basic parameters of L1 and L2 instruction caches */		  
-  set_cache_basic( argv[2] );
-  set_cache_basic_L2( argv[3] );
+  set_cache_basic( l1_configs[0] );
+  set_cache_basic_L2( l2_configs[0] );
 
   /* Allocate memory for capturing conflicting task information */		  
   CALLOC(numConflictTask, char *, cache_L2.ns, sizeof(char), "numConflictTask");
@@ -182,9 +284,16 @@ int main(int argc, char **argv )
     numConflictMSC[n] = 0;
   }
 
-  /* Generate statistics file name & remove  existing file, if any. */
-  sprintf( statfileName, "wcet-%s-%s.log", interferePathName, argv[6] );
-  remove( statfileName );
+  /* Loop contexts of the analyses run by this thread after the front ends
+   * of the tasks (updateCacheState, pathDAG) */
+  CALLOC(loop_level_arr, int *, MAX_NEST_LOOP, sizeof(int), "loop_level_arr");
+
+  /* Generate statistics file names & remove existing files, if any. */
+  for ( i = 0; i < num_methods; i++ ) {
+    sprintf( methods[i].statfileName, "wcet-%s-%s.log", interferePathName,
+        methods[i].name );
+    remove( methods[i].statfileName );
+  }
 
   /* Monitor time from this point */
   const milliseconds time_start = getmsecs();
@@ -222,87 +331,18 @@ int main(int argc, char **argv )
     /* Now go through all the tasks to read their CFG and build 
      * relevant data structures like loops, basic blocks and so 
      * on */	  
-    for(i = 0; i < currentMSC->num_task; i ++) {
-
-      task_t * const currentTask = &currentMSC->taskList[i];
-      currentTask->task_id = i;
-
-      DOUT( "Reading task %s\n", currentTask->task_name );
-
-      filename = currentTask->task_name;
-      procs     = NULL;
-      num_procs = 0;
-      proc_cg   = NULL;
-      infeas = 0;
-
-      /* Read the cfg of the task into the global array 'procs' */
-      read_cfg();
-
-      /* Allocate memory for the procedure copies. */
-      CALLOC(currentTask->proc_cg_ptr, proc_copy *, num_procs,
-          sizeof(proc_copy), "currentTask->proc_cg_ptr");
-
-      readInstr();
-
-      /* Detect loops in all procedures of the task */ 
-      detect_loops();
-
-      topo_sort();
-
-      /* compute incoming info for each basic block */
-      calculate_incoming();
-
-      /* This function allocates memory for all analysis and subsequent WCET
-       * computation of the task */
-      constructAll( currentTask );
-
-      /* Set the main procedure (entry procedure) in this task */
-      currentTask->main_copy = main_copy;
-      currentTask->procs = procs;
-      currentTask->num_proc= num_procs;
-
-      /* Now do L1 cache analysis of the current task and compute 
-       * hit-miss-unknown classification of every instruction....
-       * Data cache is assumed to be perfect in this case */
-      cacheAnalysis();
-      /* Free all L1 cache state memories of the task as they are 
-       * no longer needed */ 
-      freeAllCacheState();
-
-      printf("L1 cache analysis finished\n");
-
-      /* Now do private L2 cache analysis of this task */
-      cacheAnalysis_L2();
-      /* Free L2 cache states */
-      freeAll_L2();
-
-      printf("L2 cache analysis finished\n\n");
+    if ( sweep ) {
+      runOnTasks( currentMSC, parseTask );
+      continue;
     }
+    analyseTaskFrontEnds( currentMSC, analyseTaskFrontEnd );
 
-    /* Private cache analysis for all tasks are done here. But due 
-     * to the intereference some of the classification in L2 cache 
-     * need to be updated */
-    /* If private L2 cache analysis .... no update of interference */
-    if( !g_private ) {
-      printf("Update cache state in msc '%s'\n\n", currentMSC->msc_name);
-      updateCacheState(currentMSC);
-    }
-
-    /* This function allocates all memory required for computing and 
-     * storing hit-miss classification */
-    pathDAG(currentMSC);
-
-    /* Compute WCET and BCET of this MSC. remember MSC... not task
-     * so we need to compute WCET/BCET of each task in the MSC */
-    /* CAUTION: In presence of shared bus these two function changes
-     * to account for the bus delay */
-    analysis( currentMSC, tdma_bus_schedule_file, current_analysis_method,
-        alignmentLAType, alignmentTryStructural, offsetDataType );
-
-    /* Initializing conflicting information */
-    for(n = 0; n < cache_L2.ns; n++) {
-      numConflictMSC[n] = 0;
-    }
+    analyseMSC( currentMSC, tdma_bus_schedule_file, methods, num_methods,
+        NULL, NULL );
+  }
+  if ( sweep ) {
+    sweepCacheConfigs( num_msc, l1_configs, num_l1_configs, l2_configs,
+        num_l2_configs, tdma_bus_schedule_file, methods, num_methods );
   }
   /* Done with timing analysis of all the MSC-s */
   const milliseconds time_end = getmsecs();
@@ -377,10 +417,10 @@ int main(int argc, char **argv )
         updateCacheState(msc[i]);
 
         pathDAG(msc[i]);
+        decodeAccessTypes(msc[i]);
 
         /* Compute WCET and BCET of each task. */
-        analysis( msc[i], tdma_bus_schedule_file, current_analysis_method,
-            alignmentLAType, alignmentTryStructural, offsetDataType );
+        analysis( msc[i], tdma_bus_schedule_file, &methods[0] );
       }
 
       /* Iteration increased */
@@ -474,19 +514,483 @@ int main(int argc, char **argv )
 // #########################################
 
 
+/*
+ * Reads the CFG of the task and detects its loops. Only uses the TASK_LOCAL
+ * globals of the calling thread and the task itself.
+ */
+static void parseTask( task_t *task, int task_id )
+{
+  DSTART( "parseTask" );
+
+  task->task_id = task_id;
+
+  DOUT( "Reading task %s\n", task->task_name );
+
+  filename = task->task_name;
+  procs     = NULL;
+  num_procs = 0;
+  proc_cg   = NULL;
+  infeas = 0;
+
+  /* Read the cfg of the task into the global array 'procs' */
+  read_cfg();
+
+  /* Allocate memory for the procedure copies. */
+  CALLOC(task->proc_cg_ptr, proc_copy *, num_procs,
+      sizeof(proc_copy), "task->proc_cg_ptr");
+
+  readInstr();
+
+  /* Detect loops in all procedures of the task */
+  detect_loops();
+
+  topo_sort();
+
+  /* compute incoming info for each basic block */
+  calculate_incoming();
+
+  /* This function allocates memory for all analysis and subsequent WCET
+   * computation of the task */
+  constructAll( task );
+
+  /* Set the main procedure (entry procedure) in this task */
+  task->main_copy = main_copy;
+  task->procs = procs;
+  task->num_proc= num_procs;
+
+  DEND();
+}
+
+
+/*
+ * Runs the private L1 and L2 cache analysis of the parsed task for the
+ * current cache configuration.
+ */
+static void analyseTaskCaches( task_t *task, int task_id )
+{
+  DSTART( "analyseTaskCaches" );
+
+  filename = task->task_name;
+  procs = task->procs;
+  num_procs = task->num_proc;
+  main_copy = task->main_copy;
+
+  /* Now do L1 cache analysis of the current task and compute
+   * hit-miss-unknown classification of every instruction....
+   * Data cache is assumed to be perfect in this case */
+  cacheAnalysis();
+  /* Free all L1 cache state memories of the task as they are
+   * no longer needed */
+  freeAllCacheState();
+
+  printf("L1 cache analysis finished\n");
+
+  /* Now do private L2 cache analysis of this task */
+  cacheAnalysis_L2();
+  /* Free L2 cache states */
+  freeAll_L2();
+
+  printf("L2 cache analysis finished\n\n");
+
+  DEND();
+}
+
+
+/*
+ * Reads the CFG of the task, detects its loops and runs the private L1 and L2
+ * cache analysis of it.
+ */
+static void analyseTaskFrontEnd( task_t *task, int task_id )
+{
+  parseTask( task, task_id );
+  analyseTaskCaches( task, task_id );
+}
+
+
+static void *frontEndThread( void *arg )
+{
+  DSTART( "frontEndThread" );
+
+  front_end_queue_t * const queue = (front_end_queue_t *)arg;
+  int i;
+  while ( ( i = __atomic_fetch_add( &queue->next_task, 1, __ATOMIC_RELAXED ) ) <
+          queue->msc->num_task ) {
+    queue->run( &queue->msc->taskList[i], i );
+  }
+
+  DRETURN( NULL );
+}
+
+
+/*
+ * Runs 'run' for all tasks of 'msc', in up to 'g_front_end_threads'
+ * threads. 'run' may only use the TASK_LOCAL globals and its task.
+ */
+static void runOnTasks( MSC *msc, void (*run)( task_t *task, int task_id ) )
+{
+  DSTART( "runOnTasks" );
+
+  int num_threads = MIN( (int)g_front_end_threads, msc->num_task );
+  int i;
+
+  if ( num_threads <= 1 ) {
+    for ( i = 0; i < msc->num_task; i++ ) {
+      run( &msc->taskList[i], i );
+    }
+  } else {
+    front_end_queue_t queue = { msc, 0, run };
+    pthread_t *threads;
+    CALLOC( threads, pthread_t *, num_threads, sizeof( pthread_t ), "threads" );
+
+    for ( i = 0; i < num_threads; i++ ) {
+      if ( pthread_create( &threads[i], NULL, frontEndThread, &queue ) != 0 ) {
+        prerr( "Error: Could not start a front end thread\n" );
+      }
+    }
+    for ( i = 0; i < num_threads; i++ ) {
+      pthread_join( threads[i], NULL );
+    }
+    free( threads );
+  }
+
+  DEND();
+}
+
+
+/*
+ * Runs 'run' (the whole front end or only the cache analyses) for all tasks
+ * of 'msc'. The tasks are independent until their L2 set usage is combined
+ * here, before the interference among them is considered in
+ * updateCacheState.
+ */
+static void analyseTaskFrontEnds( MSC *msc,
+                                  void (*run)( task_t *task, int task_id ) )
+{
+  DSTART( "analyseTaskFrontEnds" );
+
+  int i;
+
+  runOnTasks( msc, run );
+
+  for ( i = 0; i < msc->num_task; i++ ) {
+    countSetUsage_L2( msc->taskList[i].main_copy );
+  }
+
+  DEND();
+}
+
+
+/*
+ * Runs the analyses which follow the private cache analyses of the tasks
+ * of 'msc': the update of the L2 classifications by the interference among
+ * the tasks and the analysis 'methods'. If 'table' is given, a line of the
+ * results of each task for each method, prefixed by 'table_prefix', is
+ * written to it.
+ */
+static void analyseMSC( MSC *msc, const char *tdma_bus_schedule_file,
+                        const analysis_method_t *methods, int num_methods,
+                        FILE *table, const char *table_prefix )
+{
+  DSTART( "analyseMSC" );
+
+  int i, j;
+
+  /* Private cache analysis for all tasks are done here. But due
+   * to the intereference some of the classification in L2 cache
+   * need to be updated */
+  /* If private L2 cache analysis .... no update of interference */
+  if( !g_private ) {
+    printf("Update cache state in msc '%s'\n\n", msc->msc_name);
+    updateCacheState(msc);
+  }
+
+  /* This function allocates all memory required for computing and
+   * storing hit-miss classification */
+  pathDAG(msc);
+
+  /* Decode the (updated) cache hit-miss classifications for the analyses */
+  decodeAccessTypes(msc);
+
+  /* Compute WCET and BCET of this MSC. remember MSC... not task
+   * so we need to compute WCET/BCET of each task in the MSC */
+  /* CAUTION: In presence of shared bus these two function changes
+   * to account for the bus delay */
+  for ( i = 0; i < num_methods; i++ ) {
+    analysis( msc, tdma_bus_schedule_file, &methods[i] );
+
+    for ( j = 0; table && j < msc->num_task; j++ ) {
+      const task_t * const t = &( msc->taskList[j] );
+      fprintf( table, "%s;%s;%s;%s;%llu;%llu\n", table_prefix,
+          methods[i].name, msc->msc_name, t->task_name, t->bcet, t->wcet );
+    }
+  }
+
+  /* Initializing conflicting information */
+  for(i = 0; i < cache_L2.ns; i++) {
+    numConflictMSC[i] = 0;
+  }
+
+  DEND();
+}
+
+
+/*
+ * Runs the cache analyses and the analysis 'methods' on the 'num_msc' parsed
+ * MSCs for every combination of the L1 configurations 'l1' and the L2
+ * configurations 'l2' and writes the results of all of them into one table.
+ *
+ * Each configuration is analysed in a forked process, up to
+ * 'g_sweep_processes' at a time, which starts from the parsed tasks without
+ * any cache analysis results and writes its lines of the table into a
+ * temporary file.
+ */
+static void sweepCacheConfigs( int num_msc, char **l1, int num_l1,
+                               char **l2, int num_l2,
+                               const char *tdma_bus_schedule_file,
+                               analysis_method_t *methods, int num_methods )
+{
+  DSTART( "sweepCacheConfigs" );
+
+  const int num_configs = num_l1 * num_l2;
+  int c, i, m, running = 0, next = 0;
+  FILE **results;
+  pid_t *pids;
+  CALLOC( results, FILE **, num_configs, sizeof( FILE * ), "results" );
+  CALLOC( pids, pid_t *, num_configs, sizeof( pid_t ), "pids" );
+
+  /* Do not let the children write out what is still buffered here */
+  fflush( NULL );
+
+  while ( next < num_configs || running > 0 ) {
+
+    if ( next < num_configs && running < MAX( (int)g_sweep_processes, 1 ) ) {
+      c = next++;
+      results[c] = tmpfile();
+      if ( !results[c] ) {
+        prerr( "Error: Could not create a file for the sweep results\n" );
+      }
+
+      pids[c] = fork();
+      if ( pids[c] == -1 ) {
+        prerr( "Error: Could not start the analysis of a cache configuration\n" );
+      }
+      if ( pids[c] == 0 ) {
+        char prefix[2 * MAX_LEN + 2];
+        if ( snprintf( prefix, sizeof( prefix ), "%s;%s", l1[c / num_l2],
+                       l2[c % num_l2] ) >= (int)sizeof( prefix ) ) {
+          prerr( "Error: Cache configuration names too long: %s;%s\n",
+              l1[c / num_l2], l2[c % num_l2] );
+        }
+        printf( "Analysing cache configuration %s\n", prefix );
+
+        set_cache_basic( l1[c / num_l2] );
+        set_cache_basic_L2( l2[c % num_l2] );
+        CALLOC( numConflictTask, char *, cache_L2.ns, sizeof( char ), "numConflictTask" );
+        CALLOC( numConflictMSC, char *, cache_L2.ns, sizeof( char ), "numConflictMSC" );
+
+        for ( m = 0; m < num_methods; m++ ) {
+          sprintf( methods[m].statfileName, "wcet-%s-%s-c%d.log",
+              interferePathName, methods[m].name, c );
+          remove( methods[m].statfileName );
+        }
+
+        for ( i = 0; i < num_msc; i++ ) {
+          analyseTaskFrontEnds( msc[i], analyseTaskCaches );
+          analyseMSC( msc[i], tdma_bus_schedule_file, methods, num_methods,
+              results[c], prefix );
+        }
+
+        const int failed = fflush( results[c] ) != 0 || ferror( results[c] );
+        fflush( NULL );
+        _exit( failed );
+      }
+      running++;
+      continue;
+    }
+
+    /* Wait for one of the configurations to finish */
+    int status;
+    const pid_t pid = wait( &status );
+    for ( c = 0; pid != -1 && c < next; c++ ) {
+      if ( pids[c] == pid ) {
+        pids[c] = 0;
+      }
+    }
+    if ( pid == -1 || !WIFEXITED( status ) || WEXITSTATUS( status ) != 0 ) {
+      /* Do not leave the other configurations running */
+      for ( c = 0; c < next; c++ ) {
+        if ( pids[c] != 0 ) {
+          kill( pids[c], SIGKILL );
+          waitpid( pids[c], NULL, 0 );
+          pids[c] = 0;
+        }
+      }
+      prerr( "Error: The analysis of a cache configuration failed\n" );
+    }
+    running--;
+  }
+
+  /* Combine the results in the order of the configurations */
+  char tableName[MAX_LEN + 16];
+  sprintf( tableName, "wcet-%s-sweep.log", interferePathName );
+  FILE * const table = fopen( tableName, "w" );
+  if ( !table ) {
+    prerr( "Error: Could not write the sweep results to %s\n", tableName );
+  }
+  fprintf( table, "L1;L2;method;MSC;task;BCET;WCET\n" );
+  for ( c = 0; c < num_configs; c++ ) {
+    char line[4 * MAX_LEN];
+    rewind( results[c] );
+    while ( fgets( line, sizeof( line ), results[c] ) ) {
+      fputs( line, table );
+    }
+    fclose( results[c] );
+  }
+  fclose( table );
+  printf( "Results of %d cache configurations written to %s\n", num_configs,
+      tableName );
+
+  free( results );
+  free( pids );
+
+  DEND();
+}
+
+
+/*
+ * Splits the comma-separated 'list' into a newly allocated array '*items'
+ * and returns its length. The items point into a copy of 'list'.
+ */
+static int splitList( const char *list, char ***items )
+{
+  int num_items = 0;
+
+  char *copy = strdup( list );
+  if ( !copy ) {
+    prerr( "Error: Out of memory\n" );
+  }
+  *items = NULL;
+  char *item;
+  for ( item = strtok( copy, "," ); item; item = strtok( NULL, "," ) ) {
+    num_items++;
+    REALLOC( *items, char **, num_items * sizeof( char * ), "items" );
+    ( *items )[num_items - 1] = item;
+  }
+
+  return num_items;
+}
+
+
+/*
+ * Parses the analysis method 'name' (e.g. "acr+") into 'method'.
+ */
+static void parseAnalysisMethod( const char *name, analysis_method_t *method )
+{
+  int i;
+
+  method->name = name;
+  method->method = ANALYSIS_ALIGNMENT;
+  method->alignmentLAType = LOOP_ANALYSIS_GLOBAL_CONVERGENCE;
+  method->alignmentTryStructural = 0;
+  method->offsetDataType = OFFSET_DATA_TYPE_RANGE;
+
+  switch( name[0] ) {
+    case 'a':
+      method->method = ANALYSIS_ALIGNMENT;
+      for ( i = 1; name[i] != '\0'; i++ ) {
+        char option_char = name[i];
+        switch( option_char ) {
+          case 'c': method->alignmentLAType = LOOP_ANALYSIS_GLOBAL_CONVERGENCE; break;
+          case 'g': method->alignmentLAType = LOOP_ANALYSIS_GRAPH_TRACKING; break;
+          case 'm': method->alignmentLAType = LOOP_ANALYSIS_MAX_PLUS; break;
+          case 'r': method->offsetDataType = OFFSET_DATA_TYPE_RANGE; break;
+          case 's': method->offsetDataType = OFFSET_DATA_TYPE_SET; break;
+          case 'i': method->offsetDataType = OFFSET_DATA_TYPE_INTERVALS; break;
+          case 't': method->offsetDataType = OFFSET_DATA_TYPE_TIME_RANGE; break;
+          case '+': method->alignmentTryStructural = 1; break;
+          default: assert( 0 && "Unknown option!" );
+        }
+      }
+      break;
+    case 'n':
+      method->method = ANALYSIS_NONE;
+      break;
+    case 's':
+      method->method = ANALYSIS_STRUCTURAL;
+      break;
+    case 'u':
+      method->method = ANALYSIS_UNROLL;
+      break;
+    default:
+      assert( 0 && "Unknown analysis method!" );
+  }
+}
+
+
+/*
+ * Parses the 'num' methods 'names' into a newly allocated array '*methods'.
+ */
+static int parseAnalysisMethodNames( const char * const *names, int num,
+                                     analysis_method_t **methods )
+{
+  int i;
+
+  CALLOC( *methods, analysis_method_t *, num, sizeof( analysis_method_t ),
+      "methods" );
+  for ( i = 0; i < num; i++ ) {
+    parseAnalysisMethod( names[i], &( *methods )[i] );
+  }
+  return num;
+}
+
+
+/*
+ * Parses the comma-separated list of analysis methods 'list' into a newly
+ * allocated array '*methods' and returns its length. "all" stands for the
+ * methods in 'allAnalysisMethods', "all+" for those in
+ * 'extendedAnalysisMethods'.
+ */
+static int parseAnalysisMethods( const char *list,
+                                 analysis_method_t **methods )
+{
+  int num_methods = 0;
+
+  if ( strcmp( list, "all" ) == 0 ) {
+    return parseAnalysisMethodNames( allAnalysisMethods,
+        sizeof( allAnalysisMethods ) / sizeof( allAnalysisMethods[0] ),
+        methods );
+  }
+  if ( strcmp( list, "all+" ) == 0 ) {
+    return parseAnalysisMethodNames( extendedAnalysisMethods,
+        sizeof( extendedAnalysisMethods ) / sizeof( extendedAnalysisMethods[0] ),
+        methods );
+  }
+
+  char **names;
+  num_methods = splitList( list, &names );
+  if ( num_methods == 0 ) {
+    prerr( "Error: No analysis method given\n" );
+  }
+  parseAnalysisMethodNames( (const char * const *)names, num_methods,
+      methods );
+  free( names );
+
+  return num_methods;
+}
+
+
 /*
  * Switches between the alternatives of analysis methods.
  */
 static void analysis( MSC *msc, const char *tdma_bus_schedule_file,
-                      enum AnalysisMethod method,
-                      enum LoopAnalysisType alignmentAnalysisLAType,
-                      _Bool alignmentAnalysisTryStructural,
-                      enum OffsetDataType offsetDataType )
+                      const analysis_method_t *method )
 {
   DSTART( "analysis" );
   const uint old_bus_modeling_value = g_no_bus_modeling;
 
-  switch ( method ) {
+  DOUT( "Running analysis method '%s'\n", method->name );
+
+  switch ( method->method ) {
 
     case ANALYSIS_NONE:
       g_no_bus_modeling = 1;
@@ -498,20 +1002,20 @@ static void analysis( MSC *msc, const char *tdma_bus_schedule_file,
       break;
 
     case ANALYSIS_UNROLL:
-      compute_bus_WCET_MSC_unroll(msc, tdma_bus_schedule_file);
-      compute_bus_BCET_MSC_unroll(msc, tdma_bus_schedule_file);
+      // Computes BCET and WCET together
+      compute_bus_ET_MSC_unroll(msc, tdma_bus_schedule_file);
       break;
 
     case ANALYSIS_STRUCTURAL:
-      compute_bus_WCET_MSC_structural(msc, tdma_bus_schedule_file);
-      compute_bus_BCET_MSC_structural(msc, tdma_bus_schedule_file);
+      // Computes BCET and WCET together
+      compute_bus_ET_MSC_structural(msc, tdma_bus_schedule_file);
       break;
 
     case ANALYSIS_ALIGNMENT:
       // Computes BCET and WCET together
       compute_bus_ET_MSC_alignment(msc, tdma_bus_schedule_file,
-          alignmentAnalysisLAType, alignmentAnalysisTryStructural,
-          offsetDataType );
+          method->alignmentLAType, method->alignmentTryStructural,
+          method->offsetDataType );
       break;
 
     default:
@@ -535,9 +1039,9 @@ static void analysis( MSC *msc, const char *tdma_bus_schedule_file,
 
   // Output the results if desired
   DACTION(
-      FILE * const wcet_log = fopen( statfileName, "a" );
+      FILE * const wcet_log = fopen( method->statfileName, "a" );
       if ( wcet_log == NULL ) {
-        DOUT( "Could not write output file %s!\n", statfileName );
+        DOUT( "Could not write output file %s!\n", method->statfileName );
       } else {
         fprintf( wcet_log, "##################################\n" );
         fprintf( wcet_log, "Results for MSC '%s'\n", msc->msc_name );
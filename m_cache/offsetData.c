@@ -14,6 +14,7 @@
 // Include local headers
 #include "offsetData.h"
 #include "handler.h"
+#include "resultMemo.h"
 
 
 // ############################################################
@@ -26,6 +27,19 @@
 /* Internal marker for maximum current offset. */
 #define MAXIMUM_OFFSET max_offset
 
+/* The handles of the sets which are interned whenever the store is reset. */
+#define EMPTY_SET_HANDLE 0
+#define MAXIMAL_SET_HANDLE 1
+
+/* Upper bound on the memory of each cache of set operation results. */
+#define SET_OPERATION_MEMO_CAP ( 4U << 20 )
+
+/* The key under which the result of an operation on two sets is cached. */
+typedef struct {
+  uint lhs;
+  uint rhs;
+} set_pair_key;
+
 
 // #########################################
 // #### Declaration of static variables ####
@@ -35,6 +49,32 @@
 /* The maximum possible offset that is used in the current setup. */
 static uint max_offset;
 
+/* The number of words of an offset set which are used in the current setup. */
+static uint num_words;
+
+/* The bits of the last used word of an offset set which represent offsets. */
+static ull last_word_mask;
+
+/* The store of the offset sets. The words of the set with handle h start at
+ * set_words + h * num_words. Each distinct set is stored only once, which
+ * 'set_table' ensures. It is an open addressing hash table of size
+ * 'set_table_size' (a power of two) which contains the handles plus one, so
+ * that 0 marks a free slot. */
+static ull *set_words;
+static uint num_sets;
+static uint set_capacity;
+static uint *set_table;
+static uint set_table_size;
+
+/* Caches of the results of mergeOffsetData and isOffsetDataSubsetOrEqual
+ * per pair of set handles. */
+static result_memo *merge_memo;
+static result_memo *subset_memo;
+
+/* Scratch areas of 'num_words' words to assemble new sets in. */
+static ull *work_words;
+static ull *spread_words;
+
 
 // ##################################################
 // #### Forward declarations of static functions ####
@@ -46,6 +86,329 @@ static uint max_offset;
 // #########################################
 
 
+/* Returns the words of the set with the given handle. They are only valid
+ * until the next set is interned. */
+static inline const ull *getSetWords( const uint handle )
+{
+  return set_words + (size_t)handle * num_words;
+}
+
+
+/* Returns the hash of the given set words. */
+static uint hashSetWords( const ull * const words )
+{
+  ull hash = 0xcbf29ce484222325ULL;
+  uint i;
+  for ( i = 0; i < num_words; i++ ) {
+    hash = ( hash ^ words[i] ) * 0x9e3779b97f4a7c15ULL;
+    hash ^= hash >> 29;
+  }
+  return (uint)( hash ^ ( hash >> 32 ) );
+}
+
+
+/* Puts the given handle into the hash table of the store. */
+static void insertSetHandle( const uint handle )
+{
+  uint slot = hashSetWords( getSetWords( handle ) ) & ( set_table_size - 1 );
+  while ( set_table[slot] != 0 ) {
+    slot = ( slot + 1 ) & ( set_table_size - 1 );
+  }
+  set_table[slot] = handle + 1;
+}
+
+
+/* Returns the handle of the set with the given words, which must not lie in
+ * the store itself. The set is added to the store if it is not yet in it. */
+static uint internSetWords( const ull * const words )
+{
+  uint slot = hashSetWords( words ) & ( set_table_size - 1 );
+  while ( set_table[slot] != 0 ) {
+    const uint handle = set_table[slot] - 1;
+    if ( memcmp( getSetWords( handle ), words,
+                 num_words * sizeof( ull ) ) == 0 ) {
+      return handle;
+    }
+    slot = ( slot + 1 ) & ( set_table_size - 1 );
+  }
+
+  // Add the new set
+  if ( num_sets == set_capacity ) {
+    set_capacity *= 2;
+    REALLOC( set_words, ull*, (size_t)set_capacity * num_words * sizeof( ull ),
+             "set_words" );
+  }
+  const uint handle = num_sets++;
+  memcpy( set_words + (size_t)handle * num_words, words,
+          num_words * sizeof( ull ) );
+
+  // Keep the load factor of the hash table below 1/2
+  if ( 2 * num_sets > set_table_size ) {
+    free( set_table );
+    set_table_size *= 2;
+    CALLOC( set_table, uint*, set_table_size, sizeof( uint ), "set_table" );
+    uint i;
+    for ( i = 0; i < num_sets; i++ ) {
+      insertSetHandle( i );
+    }
+  } else {
+    set_table[slot] = handle + 1;
+  }
+
+  return handle;
+}
+
+
+/* Empties the store and sizes it for the current maximum offset. */
+static void resetSetStore( void )
+{
+  free( set_words );
+  free( set_table );
+  free( work_words );
+  free( spread_words );
+  freeResultMemo( merge_memo );
+  freeResultMemo( subset_memo );
+
+  num_sets = 0;
+  set_capacity = 64;
+  MALLOC( set_words, ull*, (size_t)set_capacity * num_words * sizeof( ull ),
+          "set_words" );
+  set_table_size = 2 * set_capacity;
+  CALLOC( set_table, uint*, set_table_size, sizeof( uint ), "set_table" );
+  MALLOC( work_words, ull*, num_words * sizeof( ull ), "work_words" );
+  MALLOC( spread_words, ull*, num_words * sizeof( ull ), "spread_words" );
+  merge_memo = createResultMemo( sizeof( set_pair_key ), sizeof( uint ),
+                                 SET_OPERATION_MEMO_CAP );
+  subset_memo = createResultMemo( sizeof( set_pair_key ), sizeof( int ),
+                                  SET_OPERATION_MEMO_CAP );
+
+  // Intern the sets with fixed handles
+  memset( work_words, 0, num_words * sizeof( ull ) );
+  const uint empty_handle = internSetWords( work_words );
+  memset( work_words, 0xff, num_words * sizeof( ull ) );
+  work_words[num_words - 1] &= last_word_mask;
+  const uint maximal_handle = internSetWords( work_words );
+  assert( empty_handle == EMPTY_SET_HANDLE &&
+          maximal_handle == MAXIMAL_SET_HANDLE && "Invalid internal state!" );
+}
+
+
+/* Returns whether the given set words contain 'offset'. */
+static inline _Bool hasOffset( const ull * const words, const uint offset )
+{
+  return ( words[offset / OFFSET_SET_WORD_BITS] >>
+           ( offset % OFFSET_SET_WORD_BITS ) ) & 1;
+}
+
+
+/* Adds the offsets [lower_bound, upper_bound] to the given set words. */
+static void addOffsetRangeToWords( ull * const words,
+                                   const uint lower_bound, const uint upper_bound )
+{
+  const uint lower_word = lower_bound / OFFSET_SET_WORD_BITS;
+  const uint upper_word = upper_bound / OFFSET_SET_WORD_BITS;
+  const ull lower_mask = ~0ULL << ( lower_bound % OFFSET_SET_WORD_BITS );
+  const ull upper_mask = ~0ULL >> ( OFFSET_SET_WORD_BITS - 1 -
+                                    upper_bound % OFFSET_SET_WORD_BITS );
+
+  if ( lower_word == upper_word ) {
+    words[lower_word] |= lower_mask & upper_mask;
+  } else {
+    words[lower_word] |= lower_mask;
+    uint i;
+    for ( i = lower_word + 1; i < upper_word; i++ ) {
+      words[i] = ~0ULL;
+    }
+    words[upper_word] |= upper_mask;
+  }
+}
+
+
+/* Returns the number of offsets in the given set words. */
+static uint countOffsets( const ull * const words )
+{
+  uint result = 0;
+  uint i;
+  for ( i = 0; i < num_words; i++ ) {
+    result += __builtin_popcountll( words[i] );
+  }
+  return result;
+}
+
+
+/* Adds the offsets of 'source' moved by 'shift' to 'target'. Offsets which
+ * are moved beyond the maximum offset are dropped. 'source' and 'target' must
+ * not overlap. */
+static void shiftUpWords( ull * const target, const ull * const source,
+                          const uint shift )
+{
+  const uint word_shift = shift / OFFSET_SET_WORD_BITS;
+  const uint bit_shift  = shift % OFFSET_SET_WORD_BITS;
+
+  uint i;
+  for ( i = word_shift; i < num_words; i++ ) {
+    ull moved = source[i - word_shift] << bit_shift;
+    if ( bit_shift != 0 && i > word_shift ) {
+      moved |= source[i - word_shift - 1] >>
+               ( OFFSET_SET_WORD_BITS - bit_shift );
+    }
+    target[i] |= moved;
+  }
+  target[num_words - 1] &= last_word_mask;
+}
+
+
+/* Adds the offsets of 'source' moved down by 'shift' to 'target'. Offsets
+ * which are moved below the minimum offset are dropped. 'source' and 'target'
+ * must not overlap. */
+static void shiftDownWords( ull * const target, const ull * const source,
+                            const uint shift )
+{
+  const uint word_shift = shift / OFFSET_SET_WORD_BITS;
+  const uint bit_shift  = shift % OFFSET_SET_WORD_BITS;
+
+  uint i;
+  for ( i = 0; i + word_shift < num_words; i++ ) {
+    ull moved = source[i + word_shift] >> bit_shift;
+    if ( bit_shift != 0 && i + word_shift + 1 < num_words ) {
+      moved |= source[i + word_shift + 1] <<
+               ( OFFSET_SET_WORD_BITS - bit_shift );
+    }
+    target[i] |= moved;
+  }
+}
+
+
+/* Adds the offsets of 'source' moved by 'shift' modulo the TDMA interval
+ * to 'target'. 'shift' must be smaller than the TDMA interval and 'source'
+ * and 'target' must not overlap. */
+static void rotateWords( ull * const target, const ull * const source,
+                         const uint shift )
+{
+  if ( shift == 0 ) {
+    uint i;
+    for ( i = 0; i < num_words; i++ ) {
+      target[i] |= source[i];
+    }
+  } else {
+    shiftUpWords( target, source, shift );
+    shiftDownWords( target, source, MAXIMUM_OFFSET + 1 - shift );
+  }
+}
+
+
+/* Replaces each offset o of the given set words by the offsets
+ * o, o + 1, ..., o + width - 1 modulo the TDMA interval. */
+static void spreadWords( ull * const words, const uint width )
+{
+  if ( width > MAXIMUM_OFFSET ) {
+    if ( countOffsets( words ) != 0 ) {
+      memcpy( words, getSetWords( MAXIMAL_SET_HANDLE ),
+              num_words * sizeof( ull ) );
+    }
+    return;
+  }
+
+  /* The set covers the moves [0, covered - 1] of the original offsets.
+   * Adding a copy moved by 'step' <= 'covered' extends this to
+   * [0, covered + step - 1] without leaving gaps. */
+  uint covered = 1;
+  while ( covered < width ) {
+    const uint step = MIN( covered, width - covered );
+    memcpy( spread_words, words, num_words * sizeof( ull ) );
+    rotateWords( words, spread_words, step );
+    covered += step;
+  }
+}
+
+
+/* Returns the minimum offset of the given set words, which must not be
+ * empty. */
+static uint getWordsMinimum( const ull * const words )
+{
+  uint i;
+  for ( i = 0; i < num_words; i++ ) {
+    if ( words[i] != 0 ) {
+      return i * OFFSET_SET_WORD_BITS + __builtin_ctzll( words[i] );
+    }
+  }
+  assert( 0 && "Offset set was empty!" );
+  return 0; // To make compiler happy
+}
+
+
+/* Returns the maximum offset of the given set words, which must not be
+ * empty. */
+static uint getWordsMaximum( const ull * const words )
+{
+  uint i;
+  for ( i = num_words; i > 0; i-- ) {
+    if ( words[i - 1] != 0 ) {
+      return i * OFFSET_SET_WORD_BITS - 1 - __builtin_clzll( words[i - 1] );
+    }
+  }
+  assert( 0 && "Offset set was empty!" );
+  return 0; // To make compiler happy
+}
+
+
+/* Stores the 'num_ranges' offset ranges in 'ranges' as the interval list
+ * 'target'. The ranges may be unsorted and overlapping, they are sorted and
+ * joined here. If more than OFFSET_INTERVALS_MAXIMUM ranges remain, then the
+ * neighboring ranges with the smallest gap between them are joined until the
+ * limit is met. 'ranges' is modified in the process. */
+static void setIntervals( tdma_offset_intervals * const target,
+                          tdma_offset_bounds * const ranges,
+                          const uint num_ranges )
+{
+  if ( num_ranges == 0 ) {
+    target->num_intervals = 0;
+    return;
+  }
+
+  // Sort the ranges by their lower bounds (there are only a few)
+  uint i, j;
+  for ( i = 1; i < num_ranges; i++ ) {
+    const tdma_offset_bounds current = ranges[i];
+    for ( j = i; j > 0 && ranges[j - 1].lower_bound > current.lower_bound; j-- ) {
+      ranges[j] = ranges[j - 1];
+    }
+    ranges[j] = current;
+  }
+
+  // Join overlapping and adjacent ranges
+  uint num_joined = 1;
+  for ( i = 1; i < num_ranges; i++ ) {
+    tdma_offset_bounds * const last = &ranges[num_joined - 1];
+    if ( ranges[i].lower_bound <= last->upper_bound + 1 ) {
+      last->upper_bound = MAX( last->upper_bound, ranges[i].upper_bound );
+    } else {
+      ranges[num_joined++] = ranges[i];
+    }
+  }
+
+  // Widen the list to the maximum number of intervals
+  while ( num_joined > OFFSET_INTERVALS_MAXIMUM ) {
+    uint smallest_gap = 0;
+    for ( i = 1; i + 1 < num_joined; i++ ) {
+      if ( ranges[i + 1].lower_bound - ranges[i].upper_bound <
+           ranges[smallest_gap + 1].lower_bound -
+           ranges[smallest_gap].upper_bound ) {
+        smallest_gap = i;
+      }
+    }
+    ranges[smallest_gap].upper_bound = ranges[smallest_gap + 1].upper_bound;
+    for ( i = smallest_gap + 1; i + 1 < num_joined; i++ ) {
+      ranges[i] = ranges[i + 1];
+    }
+    num_joined--;
+  }
+
+  target->num_intervals = num_joined;
+  memcpy( target->intervals, ranges, num_joined * sizeof( tdma_offset_bounds ) );
+}
+
+
 // #########################################
 // #### Definitions of public functions ####
 // #########################################
@@ -56,8 +419,17 @@ offset_data createOffsetDataSet( void )
 {
   offset_data result;
   result.type = OFFSET_DATA_TYPE_SET;
-  memset( result.content.offset_set.offsets, 0,
-      TECHNICAL_OFFSET_MAXIMUM * sizeof( _Bool ) );
+  result.content.offset_set.handle = EMPTY_SET_HANDLE;
+  return result;
+}
+
+
+/* Creates an empty interval-list-type offset data object. */
+offset_data createOffsetDataIntervals( void )
+{
+  offset_data result;
+  result.type = OFFSET_DATA_TYPE_INTERVALS;
+  result.content.offset_intervals.num_intervals = 0;
   return result;
 }
 
@@ -82,13 +454,14 @@ offset_data createOffsetDataFromOffsetBounds( enum OffsetDataType type,
     result.content.time_range.bcet_time = lower_bound;
     result.content.time_range.wcet_time = upper_bound;
   } else if ( type == OFFSET_DATA_TYPE_SET ) {
-    memset( result.content.offset_set.offsets, 0,
-        TECHNICAL_OFFSET_MAXIMUM * sizeof( _Bool ) );
-
-    uint i;
-    for ( i = lower_bound; i <= upper_bound; i++ ) {
-      result.content.offset_set.offsets[i] = 1;
-    }
+    memset( work_words, 0, num_words * sizeof( ull ) );
+    addOffsetRangeToWords( work_words, lower_bound, upper_bound );
+    result.content.offset_set.handle = internSetWords( work_words );
+  } else if ( type == OFFSET_DATA_TYPE_INTERVALS ) {
+    tdma_offset_intervals * const l = &result.content.offset_intervals;
+    l->num_intervals = 1;
+    l->intervals[0].lower_bound = lower_bound;
+    l->intervals[0].upper_bound = upper_bound;
   } else {
     assert( 0 && "Unsupported offset data type!" );
   }
@@ -113,8 +486,6 @@ offset_data createOffsetDataFromTimeBounds( enum OffsetDataType type,
     return result;
   }
 
-  // TODO: This won't work for segmented schedules
-
   // Split up the time values into multiplier and remainder
   const uint minTime_factor    = minTime / ( MAXIMUM_OFFSET + 1 );
   const uint minTime_remainder = minTime % ( MAXIMUM_OFFSET + 1 );
@@ -135,16 +506,16 @@ offset_data createOffsetDataFromTimeBounds( enum OffsetDataType type,
    *    --> Not all offsets may be possible (depending on the remainders) but
    *        offset MINIMUM_OFFSET and MAXIMUM_OFFSET are definitely possible and
    *        thus our offset range representation does not allow a tighter bound
-   *        than [MINIMUM_OFFSET, MAXIMUM_OFFSET]. The set representation can be
-   *        more precise here. */
+   *        than [MINIMUM_OFFSET, MAXIMUM_OFFSET]. The set and interval list
+   *        representations can be more precise here. */
   } else if ( factorDifference == 1 ) {
 
     if ( type == OFFSET_DATA_TYPE_RANGE ) {
       return createOffsetDataFromOffsetBounds( type,
           MINIMUM_OFFSET, MAXIMUM_OFFSET );
     } else {
-      offset_data result = createOffsetDataSet();
-      addOffsetDataOffsetRange( &result, MINIMUM_OFFSET, maxTime_remainder );
+      offset_data result = createOffsetDataFromOffsetBounds( type,
+          MINIMUM_OFFSET, maxTime_remainder );
       addOffsetDataOffsetRange( &result, minTime_remainder, MAXIMUM_OFFSET );
       return result;
     }
@@ -170,14 +541,45 @@ uint getOffsetDataMaxOffset( void )
 }
 
 
+/* Returns the number of words of an offset set which are used for the
+ * currently used maximum offset. */
+uint getOffsetDataSetWordCount( void )
+{
+  return num_words;
+}
+
+
+/* Returns the words of the given offset set, see tdma_offset_set. They
+ * are only valid until the next offset set is modified or created. */
+const ull *getOffsetDataSetWords( const tdma_offset_set * const s )
+{
+  assert( s && s->handle < num_sets && "Invalid argument!" );
+  return getSetWords( s->handle );
+}
+
+
 /* Sets the currently used maximum offsets. All offset
  * data objects which are created after this function has
- * been called will use the new maximum offset. */
+ * been called will use the new maximum offset.
+ *
+ * This empties the store of the offset sets, so offset sets which
+ * were created before must not be used any more. */
 void setOffsetDataMaxOffset( uint new_max_offset )
 {
-  assert( new_max_offset <= TECHNICAL_OFFSET_MAXIMUM &&
-      "Maximum offset exceeeds technical maximum!" );
   MAXIMUM_OFFSET = new_max_offset;
+
+  const uint interval = new_max_offset + 1;
+  num_words = ( interval + OFFSET_SET_WORD_BITS - 1 ) / OFFSET_SET_WORD_BITS;
+  const uint last_word_bits = interval - ( num_words - 1 ) * OFFSET_SET_WORD_BITS;
+  last_word_mask = ~0ULL >> ( OFFSET_SET_WORD_BITS - last_word_bits );
+
+  resetSetStore();
+}
+
+
+void resetOffsetDataSets( void )
+{
+  resetSetStore();
 }
 
 
@@ -202,10 +604,16 @@ void addOffsetDataOffsetRange( offset_data * const d,
     }
   } else if ( d->type == OFFSET_DATA_TYPE_SET ) {
     tdma_offset_set * const s = &d->content.offset_set;
-    uint i;
-    for ( i = lower_bound; i <= upper_bound; i++ ) {
-      s->offsets[i] = 1;
-    }
+    memcpy( work_words, getSetWords( s->handle ), num_words * sizeof( ull ) );
+    addOffsetRangeToWords( work_words, lower_bound, upper_bound );
+    s->handle = internSetWords( work_words );
+  } else if ( d->type == OFFSET_DATA_TYPE_INTERVALS ) {
+    tdma_offset_intervals * const l = &d->content.offset_intervals;
+    tdma_offset_bounds ranges[OFFSET_INTERVALS_MAXIMUM + 1];
+    memcpy( ranges, l->intervals, l->num_intervals * sizeof( tdma_offset_bounds ) );
+    ranges[l->num_intervals].lower_bound = lower_bound;
+    ranges[l->num_intervals].upper_bound = upper_bound;
+    setIntervals( l, ranges, l->num_intervals + 1 );
   } else {
     assert( 0 && "Unsupported offset data type!" );
   }
@@ -224,12 +632,12 @@ void setOffsetDataMaximal( offset_data * const d )
     b->lower_bound = MINIMUM_OFFSET;
     b->upper_bound = MAXIMUM_OFFSET;
   } else if ( d->type == OFFSET_DATA_TYPE_SET ) {
-    tdma_offset_set * const s = &d->content.offset_set;
-
-    uint i;
-    for ( i = MINIMUM_OFFSET; i <= MAXIMUM_OFFSET; i++ ) {
-      s->offsets[i] = 1;
-    }
+    d->content.offset_set.handle = MAXIMAL_SET_HANDLE;
+  } else if ( d->type == OFFSET_DATA_TYPE_INTERVALS ) {
+    tdma_offset_intervals * const l = &d->content.offset_intervals;
+    l->num_intervals = 1;
+    l->intervals[0].lower_bound = MINIMUM_OFFSET;
+    l->intervals[0].upper_bound = MAXIMUM_OFFSET;
   } else {
     assert( 0 && "Unsupported offset data type!" );
   }
@@ -262,6 +670,68 @@ void updateOffsetData( offset_data * const targetOffsets,
     targetTime->bcet_time = sourceTime->bcet_time + bcTimeElasped;
     targetTime->wcet_time = sourceTime->wcet_time + wcTimeElapsed;
 
+  /* Interval lists move each interval separately and split those which
+   * wrap around the end of the TDMA interval. */
+  } else if ( sourceOffsets->type == OFFSET_DATA_TYPE_INTERVALS ) {
+
+    const tdma_offset_intervals * const source =
+      &sourceOffsets->content.offset_intervals;
+    tdma_offset_intervals * const target =
+      &targetOffsets->content.offset_intervals;
+    const ull interval = MAXIMUM_OFFSET + 1;
+
+    // Each moved interval may be split in two, plus the appended intervals
+    tdma_offset_bounds ranges[3 * OFFSET_INTERVALS_MAXIMUM];
+    uint num_ranges = 0;
+
+    if ( source->num_intervals == 0 ) {
+      // Nothing to move
+    } else if ( bcTimeElasped > wcTimeElapsed ) {
+      /* The intervals may shrink below their original size, which is only
+       * handled for their hull, as in the range representation. */
+      offset_data hull = createOffsetDataFromOffsetBounds(
+          OFFSET_DATA_TYPE_RANGE, getOffsetDataMinimumOffset( sourceOffsets ),
+          getOffsetDataMaximumOffset( sourceOffsets ) );
+      updateOffsetData( &hull, &hull, bcTimeElasped, wcTimeElapsed, FALSE );
+      ranges[num_ranges++] = hull.content.offset_range;
+    } else {
+      uint i;
+      for ( i = 0; i < source->num_intervals; i++ ) {
+        const ull lower = (ull)source->intervals[i].lower_bound + bcTimeElasped;
+        const ull upper = (ull)source->intervals[i].upper_bound + wcTimeElapsed;
+
+        // The interval covers all offsets
+        if ( upper - lower + 1 >= interval ) {
+          ranges[0].lower_bound = MINIMUM_OFFSET;
+          ranges[0].upper_bound = MAXIMUM_OFFSET;
+          num_ranges = 1;
+          break;
+        }
+
+        const uint lower_remainder = lower % interval;
+        const uint upper_remainder = upper % interval;
+        if ( lower_remainder <= upper_remainder ) {
+          ranges[num_ranges].lower_bound = lower_remainder;
+          ranges[num_ranges].upper_bound = upper_remainder;
+          num_ranges++;
+        } else {
+          ranges[num_ranges].lower_bound = lower_remainder;
+          ranges[num_ranges].upper_bound = MAXIMUM_OFFSET;
+          num_ranges++;
+          ranges[num_ranges].lower_bound = MINIMUM_OFFSET;
+          ranges[num_ranges].upper_bound = upper_remainder;
+          num_ranges++;
+        }
+      }
+    }
+
+    if ( append ) {
+      memcpy( ranges + num_ranges, target->intervals,
+              target->num_intervals * sizeof( tdma_offset_bounds ) );
+      num_ranges += target->num_intervals;
+    }
+    setIntervals( target, ranges, num_ranges );
+
   } else {
 
     const uint newLowerBound = getOffsetDataMinimumOffset( sourceOffsets ) + bcTimeElasped;
@@ -321,47 +791,28 @@ void updateOffsetData( offset_data * const targetOffsets,
          * precision which is the case here, when there are offsets which are
          * potentially NOT in the result set. */
 
-        /* Determines whether we must first buffer the results. */
-        _Bool bufferResultsFirst = ( sourceOffsets == targetOffsets );
-        const _Bool * const inputPointer = sourceOffsets->content.offset_set.offsets;
-              _Bool * const finalOutputPointer = targetOffsets->content.offset_set.offsets;
-        _Bool *preliminaryOutputPointer;
-
-        /* Determine and prepare the output area. */
-        const int output_area_size = ( MAXIMUM_OFFSET + 1 ) * sizeof( _Bool );
-        _Bool *offsetResultBuffer;
-        if ( bufferResultsFirst ) {
-          CALLOC( offsetResultBuffer, _Bool*, MAXIMUM_OFFSET + 1,
-                sizeof( _Bool ), "newOffsets" );
-          preliminaryOutputPointer = offsetResultBuffer;
-          if ( append ) {
-            memcpy( preliminaryOutputPointer, inputPointer,
-                output_area_size );
-          }
-        } else {
-          preliminaryOutputPointer = finalOutputPointer;
-          if ( !append ) {
-            memset( preliminaryOutputPointer, 0, output_area_size );
-          }
-        }
-
-        // Compute the new offsets
-        uint i, j;
-        for ( i = MINIMUM_OFFSET; i <= MAXIMUM_OFFSET; i++ ) {
-          if ( inputPointer[i] ) {
-            for ( j = bcTimeElasped; j <= wcTimeElapsed; j++ ) {
-              preliminaryOutputPointer[ (i + j) % (MAXIMUM_OFFSET + 1) ] = 1;
-            }
-          }
+        /* The new offsets are the source offsets moved by the best-case
+         * time and then spread over the following offsets up to the
+         * worst-case time. If the best case exceeds the worst case, then no
+         * offsets are reached. */
+        memset( work_words, 0, num_words * sizeof( ull ) );
+        if ( bcTimeElasped <= wcTimeElapsed ) {
+          rotateWords( work_words,
+                       getSetWords( sourceOffsets->content.offset_set.handle ),
+                       bcTimeElasped % ( MAXIMUM_OFFSET + 1 ) );
+          spreadWords( work_words, wcTimeElapsed - bcTimeElasped + 1 );
         }
 
-        // Copy from temporary array to the offset object if needed
-        if ( preliminaryOutputPointer != finalOutputPointer ) {
-          for ( i = MINIMUM_OFFSET; i <= MAXIMUM_OFFSET; i++ ) {
-            finalOutputPointer[i] = preliminaryOutputPointer[i];
+        // Write the new offsets to the offset object
+        tdma_offset_set * const target = &targetOffsets->content.offset_set;
+        if ( append ) {
+          const ull * const previous = getSetWords( target->handle );
+          uint i;
+          for ( i = 0; i < num_words; i++ ) {
+            work_words[i] |= previous[i];
           }
-          free( offsetResultBuffer );
         }
+        target->handle = internSetWords( work_words );
       } else {
         assert( 0 && "Unsupported offset data type!" );
       }
@@ -394,14 +845,40 @@ offset_data mergeOffsetData( const offset_data * const d1,
     result.content.time_range.bcet_time = MIN( b1->bcet_time, b2->bcet_time );
     result.content.time_range.wcet_time = MAX( b1->wcet_time, b2->wcet_time );
   } else if ( d1->type == OFFSET_DATA_TYPE_SET ) {
-    const tdma_offset_set * const s1 = &d1->content.offset_set;
-    const tdma_offset_set * const s2 = &d2->content.offset_set;
-
-    uint i;
-    for ( i = MINIMUM_OFFSET; i <= MAXIMUM_OFFSET; i++ ) {
-      const _Bool newValue = s1->offsets[i] | s2->offsets[i];
-      result.content.offset_set.offsets[i] = newValue;
+    // The union is symmetric, so cache it under the ordered pair of handles
+    const uint h1 = d1->content.offset_set.handle;
+    const uint h2 = d2->content.offset_set.handle;
+    const set_pair_key key = { MIN( h1, h2 ), MAX( h1, h2 ) };
+    uint * const merged = &result.content.offset_set.handle;
+
+    if ( h1 == h2 ) {
+      *merged = h1;
+    } else {
+      const uint * const cached = lookupResultMemo( merge_memo, &key );
+      if ( cached != NULL ) {
+        *merged = *cached;
+      } else {
+        const ull * const w1 = getSetWords( h1 );
+        const ull * const w2 = getSetWords( h2 );
+        uint i;
+        for ( i = 0; i < num_words; i++ ) {
+          work_words[i] = w1[i] | w2[i];
+        }
+        *merged = internSetWords( work_words );
+        storeResultMemo( merge_memo, &key, merged );
+      }
     }
+  } else if ( d1->type == OFFSET_DATA_TYPE_INTERVALS ) {
+    const tdma_offset_intervals * const l1 = &d1->content.offset_intervals;
+    const tdma_offset_intervals * const l2 = &d2->content.offset_intervals;
+
+    tdma_offset_bounds ranges[2 * OFFSET_INTERVALS_MAXIMUM];
+    memcpy( ranges, l1->intervals,
+            l1->num_intervals * sizeof( tdma_offset_bounds ) );
+    memcpy( ranges + l1->num_intervals, l2->intervals,
+            l2->num_intervals * sizeof( tdma_offset_bounds ) );
+    setIntervals( &result.content.offset_intervals, ranges,
+                  l1->num_intervals + l2->num_intervals );
   } else {
     assert( 0 && "Unsupported offset data type!" );
   }
@@ -456,21 +933,60 @@ int isOffsetDataSubsetOrEqual( const offset_data * const lhs,
         return -1;
       }
     }
+  } else if ( lhs->type == OFFSET_DATA_TYPE_INTERVALS ) {
+    const tdma_offset_intervals * const l1 = &lhs->content.offset_intervals;
+    const tdma_offset_intervals * const l2 = &rhs->content.offset_intervals;
+
+    // Check equality
+    if ( l1->num_intervals == l2->num_intervals &&
+         memcmp( l1->intervals, l2->intervals,
+                 l1->num_intervals * sizeof( tdma_offset_bounds ) ) == 0 ) {
+      return 0;
+    }
+
+    // Check for subset: The intervals of 'rhs' are disjoint and not adjacent,
+    // so each interval of 'lhs' must lie inside a single one of them.
+    uint i, j = 0;
+    for ( i = 0; i < l1->num_intervals; i++ ) {
+      while ( j < l2->num_intervals &&
+              l2->intervals[j].upper_bound < l1->intervals[i].lower_bound ) {
+        j++;
+      }
+      if ( j == l2->num_intervals ||
+           l2->intervals[j].lower_bound > l1->intervals[i].lower_bound ||
+           l2->intervals[j].upper_bound < l1->intervals[i].upper_bound ) {
+        return -1;
+      }
+    }
+    return 1;
   } else if ( lhs->type == OFFSET_DATA_TYPE_SET ) {
-    const tdma_offset_set * const s1 = &lhs->content.offset_set;
-    const tdma_offset_set * const s2 = &rhs->content.offset_set;
+    const set_pair_key key = { lhs->content.offset_set.handle,
+                               rhs->content.offset_set.handle };
+
+    /* Unlike the other representations, sets report equality as 1 and a
+     * strict subset as 0. The results of the graph tracking loop analysis
+     * depend on this, so it is kept. Equal sets have equal handles. */
+    if ( key.lhs == key.rhs ) {
+      return 1;
+    }
+
+    const int * const cached = lookupResultMemo( subset_memo, &key );
+    if ( cached != NULL ) {
+      return *cached;
+    }
 
-    _Bool allEqual = 1;
+    const ull * const w1 = getSetWords( key.lhs );
+    const ull * const w2 = getSetWords( key.rhs );
+    int result = 0;
     uint i;
-    for ( i = MINIMUM_OFFSET; i <= MAXIMUM_OFFSET; i++ ) {
-      if ( s1->offsets[i] > s2->offsets[i] ) {
-        return -1;
-      } else
-      if ( s1->offsets[i] < s2->offsets[i] ) {
-        allEqual = 0;
+    for ( i = 0; i < num_words; i++ ) {
+      if ( w1[i] & ~w2[i] ) {
+        result = -1;
+        break;
       }
     }
-    return allEqual;
+    storeResultMemo( subset_memo, &key, &result );
+    return result;
   } else {
     assert( 0 && "Unsupported offset data type!" );
   }
@@ -500,15 +1016,12 @@ _Bool isOffsetDataMaximal( const offset_data * const d )
   } else if ( d->type == OFFSET_DATA_TYPE_TIME_RANGE ) {
     return FALSE;
   } else if ( d->type == OFFSET_DATA_TYPE_SET ) {
-    const tdma_offset_set * const s = &d->content.offset_set;
-
-    uint i;
-    for ( i = MINIMUM_OFFSET; i <= MAXIMUM_OFFSET; i++ ) {
-      if ( !s->offsets[i] ) {
-        return FALSE;
-      }
-    }
-    return TRUE;
+    return d->content.offset_set.handle == MAXIMAL_SET_HANDLE;
+  } else if ( d->type == OFFSET_DATA_TYPE_INTERVALS ) {
+    const tdma_offset_intervals * const l = &d->content.offset_intervals;
+    return l->num_intervals == 1 &&
+           l->intervals[0].lower_bound == MINIMUM_OFFSET &&
+           l->intervals[0].upper_bound == MAXIMUM_OFFSET;
   } else {
     assert( 0 && "Unsupported offset data type!" );
   }
@@ -531,6 +1044,21 @@ _Bool isOffsetDataValid( const offset_data * const d )
     //      return b->bcet_time <= b->wcet_time;
     return TRUE;
   } else if ( d->type == OFFSET_DATA_TYPE_SET ) {
+    return d->content.offset_set.handle < num_sets;
+  } else if ( d->type == OFFSET_DATA_TYPE_INTERVALS ) {
+    const tdma_offset_intervals * const l = &d->content.offset_intervals;
+    if ( l->num_intervals > OFFSET_INTERVALS_MAXIMUM ) {
+      return FALSE;
+    }
+    uint i;
+    for ( i = 0; i < l->num_intervals; i++ ) {
+      const tdma_offset_bounds * const b = &l->intervals[i];
+      if ( b->lower_bound > b->upper_bound ||
+           b->upper_bound > MAXIMUM_OFFSET ||
+           ( i > 0 && b->lower_bound <= l->intervals[i - 1].upper_bound + 1 ) ) {
+        return FALSE;
+      }
+    }
     return TRUE;
   } else {
     assert( 0 && "Unsupported offset data type!" );
@@ -548,15 +1076,9 @@ _Bool isOffsetDataEmpty( const offset_data * const d )
   } else if ( d->type == OFFSET_DATA_TYPE_TIME_RANGE ) {
     return FALSE;
   } else if ( d->type == OFFSET_DATA_TYPE_SET ) {
-    const tdma_offset_set * const s = &d->content.offset_set;
-
-    uint i;
-    for ( i = MINIMUM_OFFSET; i <= MAXIMUM_OFFSET; i++ ) {
-      if ( s->offsets[i] ) {
-        return FALSE;
-      }
-    }
-    return TRUE;
+    return d->content.offset_set.handle == EMPTY_SET_HANDLE;
+  } else if ( d->type == OFFSET_DATA_TYPE_INTERVALS ) {
+    return d->content.offset_intervals.num_intervals == 0;
   } else {
     assert( 0 && "Unsupported offset data type!" );
     return FALSE;
@@ -616,50 +1138,36 @@ _Bool isOffsetDataRangeValue( const offset_data * const d,
           b->wcet_time ).content.offset_range;
     }
     return TRUE;
+  } else if ( d->type == OFFSET_DATA_TYPE_INTERVALS ) {
+    const tdma_offset_intervals * const l = &d->content.offset_intervals;
+    if ( l->num_intervals != 1 ) {
+      return FALSE;
+    }
+    if ( rangeValue != NULL ) {
+      *rangeValue = l->intervals[0];
+    }
+    return TRUE;
   } else if ( d->type == OFFSET_DATA_TYPE_SET ) {
-    const tdma_offset_set * const s = &d->content.offset_set;
-    tdma_offset_bounds result;
-    _Bool foundFirstOffset = FALSE;
-    _Bool foundLastOffset  = FALSE;
-
-    uint i;
-    for ( i = MINIMUM_OFFSET; i <= MAXIMUM_OFFSET; i++ ) {
-
-      // Current offset is in set
-      if ( s->offsets[i] ) {
-        if ( !foundFirstOffset ) {
-          result.lower_bound = i;
-          foundFirstOffset = TRUE;
-        }
-        if ( foundLastOffset ) {
-          return FALSE;
-        }
+    const ull * const words = getSetWords( d->content.offset_set.handle );
 
-      // Current offset is not in set
-      } else {
-        if ( foundFirstOffset && !foundLastOffset ) {
-          result.upper_bound = i - 1;
-          foundLastOffset = TRUE;
-        }
-      }
+    // Offset set may be empty
+    const uint size = countOffsets( words );
+    if ( size == 0 ) {
+      return FALSE;
     }
 
-    // Offset set may be empty
-    if ( !foundFirstOffset ) {
+    // The set is a range iff there are no gaps between its bounds
+    tdma_offset_bounds result;
+    result.lower_bound = getWordsMinimum( words );
+    result.upper_bound = getWordsMaximum( words );
+    if ( result.upper_bound - result.lower_bound + 1 != size ) {
       return FALSE;
-    } else {
-      // If the set represents a range [x, max_offset], then
-      // we must detect this here, because the loop will not
-      // do so.
-      if ( !foundLastOffset ) {
-        result.upper_bound = MAXIMUM_OFFSET;
-      }
+    }
 
-      if ( rangeValue ) {
-        *rangeValue = result;
-      }
-      return TRUE;
+    if ( rangeValue ) {
+      *rangeValue = result;
     }
+    return TRUE;
   } else {
     assert( 0 && "Unsupported offset data type!" );
     return FALSE;
@@ -683,8 +1191,18 @@ _Bool doesOffsetDataContainOffset( const offset_data * const d,
         OFFSET_DATA_TYPE_RANGE, b->bcet_time, b->wcet_time );
     return doesOffsetDataContainOffset( &rangedata, offset );
   } else if ( d->type == OFFSET_DATA_TYPE_SET ) {
-    const tdma_offset_set * const s = &d->content.offset_set;
-    return s->offsets[offset];
+    return offset <= MAXIMUM_OFFSET &&
+           hasOffset( getSetWords( d->content.offset_set.handle ), offset );
+  } else if ( d->type == OFFSET_DATA_TYPE_INTERVALS ) {
+    const tdma_offset_intervals * const l = &d->content.offset_intervals;
+    uint i;
+    for ( i = 0; i < l->num_intervals; i++ ) {
+      if ( offset >= l->intervals[i].lower_bound &&
+           offset <= l->intervals[i].upper_bound ) {
+        return TRUE;
+      }
+    }
+    return FALSE;
   } else {
     assert( 0 && "Unsupported offset data type!" );
     return 0; // To make compiler happy
@@ -708,16 +1226,11 @@ uint getOffsetDataMinimumOffset( const offset_data * const d )
         OFFSET_DATA_TYPE_RANGE, b->bcet_time, b->wcet_time );
     return getOffsetDataMinimumOffset( &rangedata );
   } else if ( d->type == OFFSET_DATA_TYPE_SET ) {
-    const tdma_offset_set * const s = &d->content.offset_set;
-
-    uint i;
-    for ( i = MINIMUM_OFFSET; i <= MAXIMUM_OFFSET; i++ ) {
-      if ( s->offsets[i] ) {
-        return i;
-      }
-    }
-    assert( 0 && "Offset set was empty!" );
-    return 0; // To make compiler happy
+    return getWordsMinimum( getSetWords( d->content.offset_set.handle ) );
+  } else if ( d->type == OFFSET_DATA_TYPE_INTERVALS ) {
+    const tdma_offset_intervals * const l = &d->content.offset_intervals;
+    assert( l->num_intervals > 0 && "Offset interval list was empty!" );
+    return l->intervals[0].lower_bound;
   } else {
     assert( 0 && "Unsupported offset data type!" );
     return 0; // To make compiler happy
@@ -741,16 +1254,11 @@ uint getOffsetDataMaximumOffset( const offset_data * const d )
         OFFSET_DATA_TYPE_RANGE, b->bcet_time, b->wcet_time );
     return getOffsetDataMaximumOffset( &rangedata );
   } else if ( d->type == OFFSET_DATA_TYPE_SET ) {
-    const tdma_offset_set * const s = &d->content.offset_set;
-
-    uint i;
-    for ( i = MAXIMUM_OFFSET; i >= MINIMUM_OFFSET; i-- ) {
-      if ( s->offsets[i] ) {
-        return i;
-      }
-    }
-    assert( 0 && "Offset set was empty!" );
-    return 0; // To make compiler happy
+    return getWordsMaximum( getSetWords( d->content.offset_set.handle ) );
+  } else if ( d->type == OFFSET_DATA_TYPE_INTERVALS ) {
+    const tdma_offset_intervals * const l = &d->content.offset_intervals;
+    assert( l->num_intervals > 0 && "Offset interval list was empty!" );
+    return l->intervals[l->num_intervals - 1].upper_bound;
   } else {
     assert( 0 && "Unsupported offset data type!" );
     return 0; // To make compiler happy
@@ -784,20 +1292,27 @@ char *getOffsetDataString( const offset_data * const d )
   } else if ( d->type == OFFSET_DATA_TYPE_TIME_RANGE ) {
     const time_bounds * const b = &d->content.time_range;
     PRINT_TO_STRING( "[%llu,%llu]", b->bcet_time, b->wcet_time );
+  } else if ( d->type == OFFSET_DATA_TYPE_INTERVALS ) {
+    const tdma_offset_intervals * const l = &d->content.offset_intervals;
+    uint i;
+    for ( i = 0; i < l->num_intervals; i++ ) {
+      PRINT_TO_STRING( "%s[%u,%u]", i == 0 ? "" : " ",
+                       l->intervals[i].lower_bound, l->intervals[i].upper_bound );
+    }
   } else if ( d->type == OFFSET_DATA_TYPE_SET ) {
-    const tdma_offset_set * const s = &d->content.offset_set;
+    const ull * const s = getSetWords( d->content.offset_set.handle );
     PRINT_TO_STRING( "{ " );
     uint i;
     _Bool firstEntry = 1;
     for ( i = MINIMUM_OFFSET; i <= MAXIMUM_OFFSET; i++ ) {
-      if ( s->offsets[i] ) {
+      if ( hasOffset( s, i ) ) {
 
         /* Slash mode. */
-        if ( i >= MINIMUM_OFFSET+1 && s->offsets[i-1] ) {
-          if ( i < MINIMUM_OFFSET+2 || !s->offsets[i-2] ) {
+        if ( i >= MINIMUM_OFFSET+1 && hasOffset( s, i-1 ) ) {
+          if ( i < MINIMUM_OFFSET+2 || !hasOffset( s, i-2 ) ) {
             PRINT_TO_STRING( "-" );
           }
-          if ( i+1 > MAXIMUM_OFFSET || !s->offsets[i+1] ) {
+          if ( i+1 > MAXIMUM_OFFSET || !hasOffset( s, i+1 ) ) {
             PRINT_TO_STRING( "%u", i );
           }
         /* Normal mode. */
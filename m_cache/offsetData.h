@@ -3,9 +3,11 @@
 /*
  * This compilation unit provides a modular representation for TDMA offsets.
  * The user of the header can switch between offset ranges, delimited by a lower
- * and an upper bound and offset sets, which explicitly list the offsets. The
+ * and an upper bound, offset interval lists, which hold a few disjoint offset
+ * ranges, and offset sets, which explicitly list the offsets. The
  * objects can be created via special createXY functions. There is no need to
- * free them, as they have no dynamic data structures.
+ * free them. Offset sets only refer to their offsets, which this unit keeps
+ * in a store that holds each distinct set once.
  *
  * ALWAYS call "setOffsetDataMaxOffset" before using this data type!
  */
@@ -18,8 +20,11 @@
 // ######### Macros #########
 
 
-/* Technical offset limit (storage limitation). */
-#define TECHNICAL_OFFSET_MAXIMUM 320
+/* Number of bits in a word of an offset set. */
+#define OFFSET_SET_WORD_BITS 64
+
+/* Maximum number of intervals in an offset interval list. */
+#define OFFSET_INTERVALS_MAXIMUM 4
 
 /* Don't use this directly, use ITERATE_OFFSETS. */
 #define ITERATE_OFFSET_RANGE( offset_range, iteration_variable, loop_body_stmts ) \
@@ -31,15 +36,23 @@
       } \
     }
 
-/* Don't use this directly, use ITERATE_OFFSETS. */
+/* Don't use this directly, use ITERATE_OFFSETS.
+ *
+ * Visits the offsets in ascending order by repeatedly taking the lowest
+ * remaining bit of each word. The words are fetched anew for each word,
+ * because the loop body may create offset sets, which can move them. */
 #define ITERATE_OFFSET_SET( offset_set, iteration_variable, loop_body_stmts ) \
     { \
-      const uint max_offset = getOffsetDataMaxOffset(); \
+      const uint num_words = getOffsetDataSetWordCount(); \
       _Bool hadHit = 0; \
-      for ( iteration_variable = 0; \
-            iteration_variable <= max_offset; \
-            iteration_variable++ ) { \
-        if ( offset_set.offsets[iteration_variable] ) { \
+      uint word_index; \
+      for ( word_index = 0; word_index < num_words; word_index++ ) { \
+        ull remaining_bits = \
+          getOffsetDataSetWords( &offset_set )[word_index]; \
+        while ( remaining_bits != 0 ) { \
+          iteration_variable = word_index * OFFSET_SET_WORD_BITS + \
+                               __builtin_ctzll( remaining_bits ); \
+          remaining_bits &= remaining_bits - 1; \
           hadHit = 1; \
           loop_body_stmts \
         } \
@@ -47,6 +60,20 @@
       assert( hadHit && "Offset set was empty!" ); \
     }
 
+/* Don't use this directly, use ITERATE_OFFSETS. */
+#define ITERATE_OFFSET_INTERVALS( offset_intervals, iteration_variable, loop_body_stmts ) \
+    { \
+      assert( offset_intervals.num_intervals > 0 && \
+              "Offset interval list was empty!" ); \
+      uint interval_index; \
+      for ( interval_index = 0; \
+            interval_index < offset_intervals.num_intervals; \
+            interval_index++ ) { \
+        ITERATE_OFFSET_RANGE( offset_intervals.intervals[interval_index], \
+            iteration_variable, loop_body_stmts ); \
+      } \
+    }
+
 /* A convenience macro to iterate over the offsets in an offset data object.
  * For absolute time representations, this macro only iterates over the
  * minimum and maximum time values. */
@@ -71,6 +98,10 @@
     if ( offset_object.type == OFFSET_DATA_TYPE_SET ) { \
       ITERATE_OFFSET_SET( offset_object.content.offset_set, \
           iteration_variable, loop_body_stmts ); \
+    } else \
+    if ( offset_object.type == OFFSET_DATA_TYPE_INTERVALS ) { \
+      ITERATE_OFFSET_INTERVALS( offset_object.content.offset_intervals, \
+          iteration_variable, loop_body_stmts ); \
     } else { \
       assert( 0 && "Unknown offset data object type!" ); \
     } \
@@ -83,8 +114,12 @@
 /* A data type to represent an offset set. The offsets are measured from the
  * beginning of the TDMA slot of the first core. */
 typedef struct {
-  /* If the set contains offset i, then offsets[i] is 1 else it is 0. */
-  _Bool offsets[TECHNICAL_OFFSET_MAXIMUM];
+  /* Identifies the offsets of the set in the store of offset sets. Equal
+   * sets have equal handles. The offsets are given by the words returned by
+   * getOffsetDataSetWords: If the set contains offset i, then bit
+   * i % OFFSET_SET_WORD_BITS of word i / OFFSET_SET_WORD_BITS is 1 else it
+   * is 0. */
+  uint handle;
 } tdma_offset_set;
 
 /* A data type to represent an offset range. The offsets are measured from the
@@ -94,6 +129,16 @@ typedef struct {
   uint upper_bound;
 } tdma_offset_bounds;
 
+/* A data type to represent a list of offset ranges. The ranges are sorted,
+ * disjoint and not adjacent. When an operation would produce more than
+ * OFFSET_INTERVALS_MAXIMUM ranges, then the ranges around the smallest gaps
+ * are joined. The offsets are measured from the beginning of the TDMA slot
+ * of the first core. */
+typedef struct {
+  uint num_intervals;
+  tdma_offset_bounds intervals[OFFSET_INTERVALS_MAXIMUM];
+} tdma_offset_intervals;
+
 /* A data type to represent an absolute time range. */
 typedef struct {
   ull bcet_time;
@@ -104,7 +149,8 @@ typedef struct {
 enum OffsetDataType {
   OFFSET_DATA_TYPE_SET,
   OFFSET_DATA_TYPE_RANGE,
-  OFFSET_DATA_TYPE_TIME_RANGE
+  OFFSET_DATA_TYPE_TIME_RANGE,
+  OFFSET_DATA_TYPE_INTERVALS
 };
 
 /* The datatype which represents an abstract amount of offsets. */
@@ -114,6 +160,7 @@ typedef struct {
   union {
     tdma_offset_set offset_set;
     tdma_offset_bounds offset_range;
+    tdma_offset_intervals offset_intervals;
     time_bounds time_range;
   } content;
   enum OffsetDataType type;
@@ -126,6 +173,9 @@ typedef struct {
 /* Creates an empty set-type offset data object. */
 offset_data createOffsetDataSet( void );
 
+/* Creates an empty interval-list-type offset data object. */
+offset_data createOffsetDataIntervals( void );
+
 /* Creates an offset data object of given type which
  * represents the given offset interval. */
 offset_data createOffsetDataFromOffsetBounds( enum OffsetDataType type,
@@ -140,11 +190,29 @@ offset_data createOffsetDataFromTimeBounds( enum OffsetDataType type,
  * representation will not be able to deal with offsets bigger
  * than this. */
 uint getOffsetDataMaxOffset( void );
+
+/* Returns the number of words of an offset set which are used for the
+ * currently used maximum offset. */
+uint getOffsetDataSetWordCount( void );
+
+/* Returns the words of the given offset set, see tdma_offset_set. They
+ * are only valid until the next offset set is modified or created. */
+const ull *getOffsetDataSetWords( const tdma_offset_set * const s );
+
 /* Sets the currently used maximum offsets. All offset
  * data objects which are created after this function has
- * been called will use the new maximum offset. */
+ * been called will use the new maximum offset.
+ *
+ * This empties the store of the offset sets, so offset sets which
+ * were created before must not be used any more. */
 void setOffsetDataMaxOffset( uint new_max_offset );
 
+/* Empties the store of the offset sets, keeping the maximum offset. Offset
+ * sets which were created before must not be used any more. The store only
+ * grows otherwise, so this should be called whenever the sets of a finished
+ * analysis are no longer needed. */
+void resetOffsetDataSets( void );
+
 /* Adds the given offset range to the given offset data object,
  * regardless of its type. */
 void addOffsetDataOffsetRange( offset_data * const d,
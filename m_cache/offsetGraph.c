@@ -7,6 +7,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
 
 
 // Include local library headers
@@ -19,6 +21,8 @@
 #include "offsetGraph.h"
 #include "header.h"
 #include "handler.h"
+#include "resultMemo.h"
+#include "sha256.h"
 
 
 // ############################################################
@@ -38,12 +42,47 @@ enum ILPComputationType {
   ILP_COMP_TYPE_OFFSETS  /* An ILP for determining the final offsets after the execution of the loop. */
 };
 
-/* Indicates which type of ILP solver is used. */
-enum ILPSolver {
-  ILP_CPLEX,   /* The CPLEX solver. */
-  ILP_LPSOLVE  /* The lp_solve solver. */
-};
-
+/* The solutions of the flow problems are memoized under a content address,
+ * the SHA-256 digest of the problem in a canonical form: The solver, the
+ * computation type, the loopbound, the number of offset nodes, the number of
+ * edges and the edges ordered by their start and end nodes, each as its
+ * start node, end node and the cost which the objective charges for it
+ * (including the cost of its start node, none for offset problems), all as
+ * words. So equal problems share a solution, even if they come from other
+ * loops or contexts, or from earlier analyses of this run. The solver is
+ * part of the key because the solvers may choose different optimal
+ * solutions of the offset problems.
+ *
+ * The solution of an ET problem is its optimum, that of an offset problem
+ * the bitset of the start nodes of the active exit edges (indexed as by
+ * 'getFlowNodeIndex'). If the directory 'g_cache_result_store' is given,
+ * the solutions are also stored there, one file per solution, so that later
+ * runs can reuse them. A file also holds the canonical form, which must be
+ * equal to that of the problem for the solution to be reused. */
+typedef struct {
+  unsigned char digest[SHA256_DIGEST_SIZE];
+} flow_problem_key;
+
+/* A flow problem in its canonical form and its content address. */
+typedef struct {
+  ull *words;
+  size_t num_words;
+  flow_problem_key key;
+} flow_problem;
+
+/* An edge of the canonical form of a flow problem. */
+typedef struct {
+  uint start;
+  uint end;
+  ull cost;
+} flow_problem_edge;
+
+#define FLOW_STORE_MAGIC "OGFLOW03"
+#define FLOW_STORE_MAGIC_LEN 8
+
+/* The ET and the offset solutions are each memoized in a quarter of the
+ * result memory, see 'g_result_memo_cap'. */
+#define FLOW_SOLUTION_MEMO_CAP ( g_result_memo_cap / 4 )
 
 // #########################################
 // #### Declaration of static variables ####
@@ -53,8 +92,11 @@ enum ILPSolver {
 // Whether to keep the temporary files generated during the analysis
 static _Bool keepTemporaryFiles = 0;
 
-/* The ILP solver to use. */
-static enum ILPSolver ilpSolver = ILP_CPLEX;
+/* The memoized solutions of the BCET/WCET and of the offset problems. */
+static result_memo *et_solution_memo = NULL;
+static result_memo *offset_solution_memo = NULL;
+/* The size of the solutions in 'offset_solution_memo'. */
+static size_t offset_solution_size = 0;
 
 
 // #########################################
@@ -696,7 +738,7 @@ static ull solveET_ILP( const offset_graph *og, const char *ilp_file,
 
   // Parse result file
   FILE *result_file = fopen( output_file, "r" );
-  ull result;
+  ull result = 0;
   const uint line_size = 500;
   char result_file_line[line_size];
   char result_string[50];
@@ -752,10 +794,81 @@ static ull solveET_ILP( const offset_graph *og, const char *ilp_file,
 }
 
 
-/* Solves a given ilp with lp_solve. The result is returned in the given
+/* Returns the index of 'node' in the per-node arrays of the built-in solver
+ * and in the offset solutions. The offset nodes come first, followed by the
+ * unknown offset node, the supersource and the supersink. */
+static inline uint getFlowNodeIndex( const offset_graph *og,
+    const offset_graph_node *node )
+{
+  switch ( node->offset ) {
+    case UNKOWN_OFFSET_NODE_ID: return og->num_nodes;
+    case SUPERSOURCE_ID:        return og->num_nodes + 1;
+    case SUPERSINK_ID:          return og->num_nodes + 2;
+    default:                    return node->offset;
+  }
+}
+
+
+/* Returns the number of words of the bitsets over the nodes of 'og' which
+ * hold the solutions of offset problems. */
+static inline uint getExitNodeWordCount( const offset_graph *og )
+{
+  return ( og->num_nodes + 3 + 63 ) / 64;
+}
+
+
+/* Marks node 'index' as the start of an active exit edge in the offset
+ * solution 'exit_nodes'. */
+static inline void markExitNode( ull * const exit_nodes, uint index )
+{
+  exit_nodes[index / 64] |= 1ULL << ( index % 64 );
+}
+
+
+/* Returns the final offsets of the offset solution 'exit_nodes' in the given
  * offset data representation. */
-static offset_data solveOffset_ILP( const offset_graph *og, const char *ilp_file,
-    enum ILPSolver solver, enum OffsetDataType offsetType )
+static offset_data getExitOffsets( const offset_graph *og,
+    const ull * const exit_nodes, enum OffsetDataType offsetType )
+{
+  const uint unknown = getFlowNodeIndex( og, &og->unknown_offset_node );
+  offset_data result = createOffsetDataFromOffsetBounds( offsetType, 0, 0 );
+
+  if ( ( exit_nodes[unknown / 64] >> ( unknown % 64 ) ) & 1 ) {
+    setOffsetDataMaximal( &result );
+    return result;
+  }
+
+  // Add the runs of consecutive exit offsets
+  _Bool foundAnyOffset = FALSE;
+  uint i = 0;
+  while ( i < og->num_nodes ) {
+    if ( !( ( exit_nodes[i / 64] >> ( i % 64 ) ) & 1 ) ) {
+      i++;
+      continue;
+    }
+    const uint run_start = i;
+    while ( i + 1 < og->num_nodes &&
+            ( ( exit_nodes[( i + 1 ) / 64] >> ( ( i + 1 ) % 64 ) ) & 1 ) ) {
+      i++;
+    }
+    if ( !foundAnyOffset ) {
+      result = createOffsetDataFromOffsetBounds( offsetType, run_start, i );
+      foundAnyOffset = TRUE;
+    } else {
+      addOffsetDataOffsetRange( &result, run_start, i );
+    }
+    i++;
+  }
+  assert( foundAnyOffset && "Invalid arguments!" );
+
+  return result;
+}
+
+
+/* Solves a given ilp with lp_solve. The start nodes of the active exit
+ * edges are marked in 'exit_nodes'. */
+static void solveOffset_ILP( const offset_graph *og, const char *ilp_file,
+    enum ILPSolver solver, ull * const exit_nodes )
 {
   DSTART( "solveOffset_ILP" );
 
@@ -794,7 +907,6 @@ static offset_data solveOffset_ILP( const offset_graph *og, const char *ilp_file
     assert( 0 && "Unknown ILP solver!" );
   }
 
-  offset_data result;
   _Bool foundAnyOffset = FALSE;
 
   if ( skipped ) {
@@ -803,22 +915,9 @@ static offset_data solveOffset_ILP( const offset_graph *og, const char *ilp_file
       sscanf( result_file_line, "%s %u", var_name, &var_value );
       if ( sscanf( var_name, X_ACTIVE_PREFIX "%u", &var_num ) == 1 ) {
         const uint edge_index = var_num - 1;
-        const uint active_offset = og->edges[edge_index].start->offset;
-
-        // Update the result object with the new offset
-        if ( !foundAnyOffset ) {
-          if ( active_offset != UNKOWN_OFFSET_NODE_ID ) {
-            result = createOffsetDataFromOffsetBounds( offsetType,
-                       active_offset, active_offset );
-          } else {
-            setOffsetDataMaximal( &result );
-          }
-          foundAnyOffset = TRUE;
-        } else {
-          assert( active_offset != UNKOWN_OFFSET_NODE_ID && "Invalid result!" );
-          updateOffsetData( &result, &result, active_offset,
-                              active_offset, TRUE );
-        }
+        markExitNode( exit_nodes,
+                      getFlowNodeIndex( og, og->edges[edge_index].start ) );
+        foundAnyOffset = TRUE;
       }
     }
   }
@@ -831,13 +930,447 @@ static offset_data solveOffset_ILP( const offset_graph *og, const char *ilp_file
   }
   free( (void*)output_file );
 
-  if ( foundAnyOffset ) {
-    DOUT( "Result was: %s\n", getOffsetDataString( &result ) );
-    DRETURN( result );
-  } else {
+  if ( !foundAnyOffset ) {
     prerr( "Could not read offset ILP output file!" );
-    DRETURN( result );
   }
+  DEND();
+}
+
+
+/* Solves the BCET/WCET flow problem of 'writeCPLEXILP' without an external
+ * solver.
+ *
+ * The single flow unit of that problem leaves the supersource at time 0 and
+ * must arrive at the supersink at time 'loopbound + 2' without being
+ * buffered, so every solution is a walk of exactly that many edges. The
+ * cheapest (most expensive) such walk is determined time step by time step,
+ * which takes O(loopbound * number of edges). */
+static ull solveET_Flow( const offset_graph *og, uint loopbound,
+    enum ILPComputationType computation_type )
+{
+  DSTART( "solveET_Flow" );
+  assert( computation_type != ILP_COMP_TYPE_OFFSETS && "Invalid arguments!" );
+
+  const _Bool maximize = computation_type == ILP_COMP_TYPE_WCET;
+  const uint num_time_steps = loopbound + 2;
+  const uint num_flow_nodes = og->num_nodes + 3;
+  const uint suso = getFlowNodeIndex( og, &og->supersource );
+  const uint susi = getFlowNodeIndex( og, &og->supersink );
+
+  /* 'cost[n]' is the best cost of the walks which arrive at node 'n' at the
+   * current time step, 'reached[n]' tells whether there are any. */
+  ull *cost, *next_cost;
+  _Bool *reached, *next_reached;
+  CALLOC( cost, ull*, num_flow_nodes, sizeof( ull ), "cost" );
+  CALLOC( next_cost, ull*, num_flow_nodes, sizeof( ull ), "next_cost" );
+  CALLOC( reached, _Bool*, num_flow_nodes, sizeof( _Bool ), "reached" );
+  CALLOC( next_reached, _Bool*, num_flow_nodes, sizeof( _Bool ),
+      "next_reached" );
+  reached[suso] = TRUE;
+
+  uint i, j;
+  for ( j = 0; j < num_time_steps; j++ ) {
+    memset( next_reached, 0, num_flow_nodes * sizeof( _Bool ) );
+
+    for ( i = 0; i < og->num_edges; i++ ) {
+      const offset_graph_edge * const edge = &og->edges[i];
+      const uint start = getFlowNodeIndex( og, edge->start );
+      if ( !reached[start] ) {
+        continue;
+      }
+
+      // Same edge cost as in the objective of the ILP
+      const uint end = getFlowNodeIndex( og, edge->end );
+      const ull walk_cost = cost[start] + ( maximize
+        ? edge->wcet + edge->start->wcet
+        : edge->bcet + edge->start->bcet );
+      if ( !next_reached[end] ||
+           ( maximize ? walk_cost > next_cost[end]
+                      : walk_cost < next_cost[end] ) ) {
+        next_cost[end] = walk_cost;
+        next_reached[end] = TRUE;
+      }
+    }
+
+    ull * const tmp_cost = cost;
+    cost = next_cost;
+    next_cost = tmp_cost;
+    _Bool * const tmp_reached = reached;
+    reached = next_reached;
+    next_reached = tmp_reached;
+  }
+
+  if ( !reached[susi] ) {
+    prerr( "Offset graph flow problem is infeasible!\n" );
+  }
+  const ull result = cost[susi];
+
+  free( cost );
+  free( next_cost );
+  free( reached );
+  free( next_reached );
+
+  DOUT( "Result was: %llu\n", result );
+  DRETURN( result );
+}
+
+
+/* Solves the offset flow problem of 'writeCPLEXILP' without an external
+ * solver. The start nodes of the active exit edges are marked in
+ * 'exit_nodes'.
+ *
+ * The flow units suffice to send one of them along each walk which reaches
+ * an exit edge at the last time step, so the active exit edges are exactly
+ * those whose start node is reachable by a walk of 'loopbound + 1' edges. */
+static void solveOffset_Flow( const offset_graph *og, uint loopbound,
+    ull * const exit_nodes )
+{
+  DSTART( "solveOffset_Flow" );
+
+  const uint num_time_steps = loopbound + 2;
+  const uint num_flow_nodes = og->num_nodes + 3;
+
+  _Bool *reached, *next_reached;
+  CALLOC( reached, _Bool*, num_flow_nodes, sizeof( _Bool ), "reached" );
+  CALLOC( next_reached, _Bool*, num_flow_nodes, sizeof( _Bool ),
+      "next_reached" );
+  reached[getFlowNodeIndex( og, &og->supersource )] = TRUE;
+
+  uint i, j;
+  for ( j = 0; j + 1 < num_time_steps; j++ ) {
+    memset( next_reached, 0, num_flow_nodes * sizeof( _Bool ) );
+
+    for ( i = 0; i < og->num_edges; i++ ) {
+      const offset_graph_edge * const edge = &og->edges[i];
+      if ( reached[getFlowNodeIndex( og, edge->start )] ) {
+        next_reached[getFlowNodeIndex( og, edge->end )] = TRUE;
+      }
+    }
+
+    _Bool * const tmp_reached = reached;
+    reached = next_reached;
+    next_reached = tmp_reached;
+  }
+
+  // Collect the active exit edges
+  const offset_graph_node * const susi = &og->supersink;
+  _Bool foundAnyOffset = FALSE;
+  for ( i = 0; i < susi->num_incoming_edges; i++ ) {
+    const offset_graph_edge * const edge = &og->edges[susi->incoming_edges[i]];
+    const uint start = getFlowNodeIndex( og, edge->start );
+    if ( reached[start] ) {
+      markExitNode( exit_nodes, start );
+      foundAnyOffset = TRUE;
+    }
+  }
+
+  free( reached );
+  free( next_reached );
+
+  if ( !foundAnyOffset ) {
+    prerr( "Offset graph flow problem is infeasible!\n" );
+  }
+  DEND();
+}
+
+
+/* Orders edges of the canonical form of a flow problem by their start and
+ * end nodes. */
+static int compareFlowProblemEdges( const void *a, const void *b )
+{
+  const flow_problem_edge * const e1 = (const flow_problem_edge *)a;
+  const flow_problem_edge * const e2 = (const flow_problem_edge *)b;
+  if ( e1->start != e2->start ) {
+    return e1->start < e2->start ? -1 : 1;
+  }
+  if ( e1->end != e2->end ) {
+    return e1->end < e2->end ? -1 : 1;
+  }
+  return 0;
+}
+
+
+/* Computes the canonical form and the content address of the flow problem
+ * of the given type on 'og' (see 'flow_problem_key'). The words must be freed
+ * by the caller. */
+static flow_problem computeFlowProblem( const offset_graph *og,
+    uint loopbound, enum ILPComputationType computation_type )
+{
+  // Bring the edges into a canonical order
+  flow_problem_edge *edges;
+  MALLOC( edges, flow_problem_edge*,
+      ( og->num_edges + 1 ) * sizeof( flow_problem_edge ), "edges" );
+  uint i;
+  for ( i = 0; i < og->num_edges; i++ ) {
+    const offset_graph_edge * const edge = &og->edges[i];
+    edges[i].start = getFlowNodeIndex( og, edge->start );
+    edges[i].end = getFlowNodeIndex( og, edge->end );
+    switch ( computation_type ) {
+      case ILP_COMP_TYPE_BCET:
+        edges[i].cost = edge->bcet + edge->start->bcet;
+        break;
+      case ILP_COMP_TYPE_WCET:
+        edges[i].cost = edge->wcet + edge->start->wcet;
+        break;
+      default:
+        edges[i].cost = 0;
+        break;
+    }
+  }
+  qsort( edges, og->num_edges, sizeof( flow_problem_edge ),
+         compareFlowProblemEdges );
+
+  flow_problem problem;
+  problem.num_words = 5 + 3 * (size_t)og->num_edges;
+  MALLOC( problem.words, ull*, problem.num_words * sizeof( ull ),
+      "problem.words" );
+  ull *word = problem.words;
+  *word++ = g_ilp_solver;
+  *word++ = computation_type;
+  *word++ = loopbound;
+  *word++ = og->num_nodes;
+  *word++ = og->num_edges;
+  for ( i = 0; i < og->num_edges; i++ ) {
+    *word++ = edges[i].start;
+    *word++ = edges[i].end;
+    *word++ = edges[i].cost;
+  }
+  free( edges );
+
+  computeSHA256( problem.words, problem.num_words * sizeof( ull ),
+                 problem.key.digest );
+  return problem;
+}
+
+
+/* Returns the memo for the solutions of 'solution_size' bytes of the flow
+ * problems of the given type, creating it if needed. */
+static result_memo *getFlowSolutionMemo(
+    enum ILPComputationType computation_type, size_t solution_size )
+{
+  if ( computation_type != ILP_COMP_TYPE_OFFSETS ) {
+    if ( et_solution_memo == NULL ) {
+      et_solution_memo = createResultMemo( sizeof( flow_problem_key ),
+          solution_size, FLOW_SOLUTION_MEMO_CAP );
+    }
+    return et_solution_memo;
+  }
+
+  /* The size of the offset solutions only changes with the TDMA interval,
+   * so the solutions for the previous interval are dropped then. */
+  if ( offset_solution_memo == NULL ||
+       offset_solution_size != solution_size ) {
+    freeResultMemo( offset_solution_memo );
+    offset_solution_memo = createResultMemo( sizeof( flow_problem_key ),
+        solution_size, FLOW_SOLUTION_MEMO_CAP );
+    offset_solution_size = solution_size;
+  }
+  return offset_solution_memo;
+}
+
+
+static void getFlowSolutionPath( char *path, size_t path_size,
+    const flow_problem_key *key )
+{
+  char name[2 * SHA256_DIGEST_SIZE + 1];
+  uint i;
+  for ( i = 0; i < SHA256_DIGEST_SIZE; i++ ) {
+    sprintf( name + 2 * i, "%02x", key->digest[i] );
+  }
+  snprintf( path, path_size, "%s/%s.flow", g_cache_result_store, name );
+}
+
+
+/* Reads the solution of 'solution_size' bytes for 'problem' from the memo or
+ * from the store directory into 'solution'. Returns whether there was one. */
+static _Bool lookupFlowSolution( const flow_problem *problem,
+    enum ILPComputationType computation_type, void *solution,
+    size_t solution_size )
+{
+  DSTART( "lookupFlowSolution" );
+
+  result_memo * const memo = getFlowSolutionMemo( computation_type,
+                                                   solution_size );
+  const void * const memoized = lookupResultMemo( memo, &problem->key );
+  if ( memoized != NULL ) {
+    memcpy( solution, memoized, solution_size );
+    DOUT( "Found solution in memo\n" );
+    DRETURN( TRUE );
+  }
+
+  if ( g_cache_result_store == NULL ) {
+    DRETURN( FALSE );
+  }
+
+  char path[MAX_LEN];
+  getFlowSolutionPath( path, MAX_LEN, &problem->key );
+  FILE * const f = fopen( path, "rb" );
+  if ( f == NULL ) {
+    DRETURN( FALSE );
+  }
+
+  /* The entry holds the magic, the number of words of the canonical form,
+   * the words and the solution, nothing else. */
+  char magic[FLOW_STORE_MAGIC_LEN];
+  ull num_words;
+  _Bool ok =
+    fread( magic, 1, FLOW_STORE_MAGIC_LEN, f ) == FLOW_STORE_MAGIC_LEN &&
+    memcmp( magic, FLOW_STORE_MAGIC, FLOW_STORE_MAGIC_LEN ) == 0 &&
+    fread( &num_words, sizeof( ull ), 1, f ) == 1;
+  _Bool equal = ok && num_words == problem->num_words;
+  if ( equal ) {
+    ull *words;
+    MALLOC( words, ull*, problem->num_words * sizeof( ull ), "words" );
+    ok = fread( words, sizeof( ull ), problem->num_words, f ) ==
+           problem->num_words &&
+         fread( solution, solution_size, 1, f ) == 1 &&
+         fgetc( f ) == EOF;
+    equal = ok && memcmp( words, problem->words,
+                          problem->num_words * sizeof( ull ) ) == 0;
+    free( words );
+  }
+  fclose( f );
+
+  /* Another problem with the same digest is just a miss. */
+  if ( ok && !equal ) {
+    DOUT( "Found the solution of another problem in %s\n", path );
+    DRETURN( FALSE );
+  }
+  if ( !ok ) {
+    fprintf( stderr, "Warning: Ignoring invalid flow problem solution in %s\n",
+        path );
+    DRETURN( FALSE );
+  }
+
+  storeResultMemo( memo, &problem->key, solution );
+  DOUT( "Found solution in %s\n", path );
+  DRETURN( TRUE );
+}
+
+
+/* Puts the solution of 'solution_size' bytes for 'problem' into the memo
+ * and, if there is one, into the store directory. Failing to write the
+ * latter is not an error, the solution is just not stored then. */
+static void storeFlowSolution( const flow_problem *problem,
+    enum ILPComputationType computation_type, const void *solution,
+    size_t solution_size )
+{
+  DSTART( "storeFlowSolution" );
+
+  storeResultMemo( getFlowSolutionMemo( computation_type, solution_size ),
+                   &problem->key, solution );
+
+  if ( g_cache_result_store == NULL ) {
+    DEND();
+    return;
+  }
+
+  char path[MAX_LEN];
+  char temp_path[MAX_LEN + 8];
+  getFlowSolutionPath( path, MAX_LEN, &problem->key );
+  snprintf( temp_path, sizeof( temp_path ), "%s.XXXXXX", path );
+
+  // Write to a temporary file first, so concurrent runs see no partial entry
+  mkdir( g_cache_result_store, 0777 );
+  const int fd = mkstemp( temp_path );
+  FILE * const f = fd == -1 ? NULL : fdopen( fd, "wb" );
+  if ( f == NULL ) {
+    if ( fd != -1 ) {
+      close( fd );
+      unlink( temp_path );
+    }
+    fprintf( stderr, "Warning: Could not store flow problem solution in %s\n",
+        g_cache_result_store );
+    DEND();
+    return;
+  }
+
+  const ull num_words = problem->num_words;
+  _Bool ok =
+    fwrite( FLOW_STORE_MAGIC, 1, FLOW_STORE_MAGIC_LEN, f ) ==
+      FLOW_STORE_MAGIC_LEN &&
+    fwrite( &num_words, sizeof( ull ), 1, f ) == 1 &&
+    fwrite( problem->words, sizeof( ull ), problem->num_words, f ) ==
+      problem->num_words &&
+    fwrite( solution, solution_size, 1, f ) == 1;
+  ok = fclose( f ) == 0 && ok;
+  if ( ok && rename( temp_path, path ) == 0 ) {
+    DOUT( "Stored the solution in %s\n", path );
+  } else {
+    unlink( temp_path );
+    fprintf( stderr, "Warning: Could not store flow problem solution in %s\n",
+        path );
+  }
+
+  DEND();
+}
+
+
+/* Returns the optimum of the BCET/WCET flow problem on 'og', reusing the
+ * solution of an equal problem if there was one. */
+static ull solveETProblem( const offset_graph *og, uint loopbound,
+    enum ILPComputationType computation_type )
+{
+  flow_problem problem = computeFlowProblem( og, loopbound,
+                                             computation_type );
+  ull result;
+  if ( lookupFlowSolution( &problem, computation_type, &result,
+                          sizeof( ull ) ) ) {
+    free( problem.words );
+    return result;
+  }
+
+  if ( g_ilp_solver == ILP_BUILTIN ) {
+    result = solveET_Flow( og, loopbound, computation_type );
+  } else {
+    char * const tmpfile = generateOffsetGraphILP( og, loopbound,
+        computation_type, g_ilp_solver );
+    result = solveET_ILP( og, tmpfile, g_ilp_solver );
+
+    if ( !keepTemporaryFiles ) {
+      remove( tmpfile );
+    }
+    free( tmpfile );
+  }
+
+  storeFlowSolution( &problem, computation_type, &result, sizeof( ull ) );
+  free( problem.words );
+  return result;
+}
+
+
+/* Marks the start nodes of the active exit edges of the offset flow problem
+ * on 'og' in 'exit_nodes', reusing the solution of an equal problem if there
+ * was one. */
+static void solveOffsetProblem( const offset_graph *og, uint loopbound,
+    ull * const exit_nodes )
+{
+  const size_t solution_size = getExitNodeWordCount( og ) * sizeof( ull );
+  flow_problem problem = computeFlowProblem( og, loopbound,
+                                             ILP_COMP_TYPE_OFFSETS );
+  if ( lookupFlowSolution( &problem, ILP_COMP_TYPE_OFFSETS, exit_nodes,
+                           solution_size ) ) {
+    free( problem.words );
+    return;
+  }
+
+  memset( exit_nodes, 0, solution_size );
+  if ( g_ilp_solver == ILP_BUILTIN ) {
+    solveOffset_Flow( og, loopbound, exit_nodes );
+  } else {
+    char * const tmpfile = generateOffsetGraphILP( og, loopbound,
+        ILP_COMP_TYPE_OFFSETS, g_ilp_solver );
+    solveOffset_ILP( og, tmpfile, g_ilp_solver, exit_nodes );
+
+    if ( !keepTemporaryFiles ) {
+      remove( tmpfile );
+    }
+    free( tmpfile );
+  }
+
+  storeFlowSolution( &problem, ILP_COMP_TYPE_OFFSETS, exit_nodes,
+                     solution_size );
+  free( problem.words );
 }
 
 
@@ -996,16 +1529,7 @@ ull computeOffsetGraphLoopBCET( const offset_graph *og, uint loopbound_min )
 {
   assert( og && "Invalid arguments!" );
 
-  char * const tmpfile = generateOffsetGraphILP( og,
-      loopbound_min, ILP_COMP_TYPE_BCET, ilpSolver );
-  const ull result = solveET_ILP( og, tmpfile, ilpSolver );
-
-  if ( !keepTemporaryFiles ) {
-    remove( tmpfile );
-  }
-  free( tmpfile );
-
-  return result;
+  return solveETProblem( og, loopbound_min, ILP_COMP_TYPE_BCET );
 }
 
 
@@ -1017,16 +1541,7 @@ ull computeOffsetGraphLoopWCET( const offset_graph *og, uint loopbound_max )
 {
   assert( og && "Invalid arguments!" );
 
-  char * const tmpfile = generateOffsetGraphILP( og,
-      loopbound_max, ILP_COMP_TYPE_WCET, ilpSolver );
-  const ull result = solveET_ILP( og, tmpfile, ilpSolver );
-
-  if ( !keepTemporaryFiles ) {
-    remove( tmpfile );
-  }
-  free( tmpfile );
-
-  return result;
+  return solveETProblem( og, loopbound_max, ILP_COMP_TYPE_WCET );
 }
 
 
@@ -1040,15 +1555,12 @@ offset_data computeOffsetGraphLoopOffsets( const offset_graph *og,
 {
   assert( og && "Invalid arguments!" );
 
-  char * const tmpfile = generateOffsetGraphILP( og, loopbound_max,
-      ILP_COMP_TYPE_OFFSETS, ilpSolver );
-  const offset_data result = solveOffset_ILP( og, tmpfile, ilpSolver,
-                                              offsetType );
-
-  if ( !keepTemporaryFiles ) {
-    remove( tmpfile );
-  }
-  free( tmpfile );
+  ull *exit_nodes;
+  MALLOC( exit_nodes, ull*, getExitNodeWordCount( og ) * sizeof( ull ),
+      "exit_nodes" );
+  solveOffsetProblem( og, loopbound_max, exit_nodes );
+  const offset_data result = getExitOffsets( og, exit_nodes, offsetType );
+  free( exit_nodes );
 
   return result;
 }
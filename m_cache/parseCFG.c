@@ -30,12 +30,10 @@ int createBlock( block *bb, int pid, int bbid, int startaddr, int tb, int nb, in
   bb->is_loophead  = 0;
   bb->instrlist    = NULL;
   bb->num_instr    = 0;
-  bb->num_cache_state = 0;
-  bb->num_cache_state_L2 = 0;
+  memset( bb->num_cache_state, 0, sizeof( bb->num_cache_state ) );
   bb->num_chmc = 0;
   bb->num_chmc_L2 = 0;  
-  bb->bb_cache_state = NULL;
-  bb->bb_cache_state_L2= NULL;
+  memset( bb->bb_cache_state, 0, sizeof( bb->bb_cache_state ) );
 
   //  bb->hit = 0;
 //  bb->miss = 0;
@@ -112,12 +110,109 @@ int createProc( procedure *p, int pid ) {
 }
 
 
+/*
+ * Returns the opcode with the given mnemonic, OPCODE_OTHER if it is not one
+ * which is distinguished by the analyses.
+ */
+static enum InstrOpcode decodeOpcode( const char *op ) {
+
+  static const struct {
+    const char *name;
+    enum InstrOpcode opcode;
+  } opcodes[] = {
+    { "addi",  OPCODE_ADDI  }, { "addiu", OPCODE_ADDIU }, { "addu", OPCODE_ADDU },
+    { "andi",  OPCODE_ANDI  }, { "bc1f",  OPCODE_BC1F  }, { "bc1t", OPCODE_BC1T },
+    { "beq",   OPCODE_BEQ   }, { "bgez",  OPCODE_BGEZ  }, { "bgtz", OPCODE_BGTZ },
+    { "blez",  OPCODE_BLEZ  }, { "bne",   OPCODE_BNE   }, { "j",    OPCODE_J    },
+    { "jal",   OPCODE_JAL   }, { "lb",    OPCODE_LB    }, { "lbu",  OPCODE_LBU  },
+    { "l.d",   OPCODE_LD    }, { "lh",    OPCODE_LH    }, { "lui",  OPCODE_LUI  },
+    { "lw",    OPCODE_LW    }, { "or",    OPCODE_OR    }, { "ori",  OPCODE_ORI  },
+    { "sb",    OPCODE_SB    }, { "sbu",   OPCODE_SBU   }, { "sh",   OPCODE_SH   },
+    { "sll",   OPCODE_SLL   }, { "slt",   OPCODE_SLT   }, { "slti", OPCODE_SLTI },
+    { "sltiu", OPCODE_SLTIU }, { "sltu",  OPCODE_SLTU  }, { "srl",  OPCODE_SRL  },
+    { "subu",  OPCODE_SUBU  }, { "sw",    OPCODE_SW    }
+  };
+
+  int i;
+  for( i = 0; i < sizeof( opcodes ) / sizeof( opcodes[0] ); i++ )
+    if( strcmp( op, opcodes[i].name ) == 0 )
+      return opcodes[i].opcode;
+  return OPCODE_OTHER;
+}
+
+
+/*
+ * Returns the number of the register with the given name (see header.h),
+ * NO_REGISTER if the operand is not a register.
+ */
+static signed char decodeRegister( const char *operand ) {
+
+  int num;
+  char rest;
+
+  if( strcmp( operand, "$fcc" ) == 0 )
+    return 66;
+  if( sscanf( operand, "$f%d%c", &num, &rest ) == 1 && num >= 0 && num < 32 )
+    return 34 + num;
+  if( sscanf( operand, "$%d%c", &num, &rest ) == 1 && num >= 0 && num < 32 )
+    return num;
+  return NO_REGISTER;
+}
+
+
+/*
+ * Returns the value of a hexadecimal operand, 0 if it is none.
+ */
+static uint decodeHex( const char *operand ) {
+
+  uint value = 0;
+  sscanf( operand, "%x", &value );
+  return value;
+}
+
+
 /*
  * Initializes an instruction. Memory allocation is done in caller.
  */
 int createInstr( instr *i, int addr, char *op, char *r1, char *r2, char *r3 ) {
 
-  sprintf( i->addr, "%08x", addr );
+  i->addr   = addr;
+  i->opcode = decodeOpcode( op );
+  i->reg[0] = decodeRegister( r1 );
+  i->reg[1] = decodeRegister( r2 );
+  i->reg[2] = decodeRegister( r3 );
+  i->imm    = 0;
+  i->target = 0;
+  i->callee = NULL;
+
+  switch( i->opcode ) {
+    // loads and stores give the offset from the base register r3 in r2
+    case OPCODE_LW: case OPCODE_LB: case OPCODE_LBU: case OPCODE_LD: case OPCODE_LH:
+    case OPCODE_SW: case OPCODE_SB: case OPCODE_SH: case OPCODE_SBU:
+    case OPCODE_LUI:
+      i->imm = atoi( r2 );
+      break;
+    case OPCODE_ADDI: case OPCODE_ADDIU: case OPCODE_ORI: case OPCODE_ANDI:
+    case OPCODE_SLTI: case OPCODE_SLTIU:
+      i->imm = atoi( r3 );
+      break;
+    // the shift amount is given in hex
+    case OPCODE_SLL: case OPCODE_SRL:
+      i->imm = decodeHex( r3 );
+      break;
+    case OPCODE_BEQ: case OPCODE_BNE:
+      i->target = decodeHex( r3 );
+      break;
+    case OPCODE_BGEZ: case OPCODE_BGTZ: case OPCODE_BLEZ:
+      i->target = decodeHex( r2 );
+      break;
+    case OPCODE_J: case OPCODE_JAL:
+      i->target = decodeHex( r1 );
+      break;
+    default:
+      break;
+  }
+
   strcpy( i->op, op );
   strcpy( i->r1, r1 );
   strcpy( i->r2, r2 );
@@ -410,6 +505,7 @@ int readInstr() {
 
   fptr = openfile( "md", "r" );
 
+  bb = NULL;
   while( fgets( line, INSN_LEN, fptr )) {
 
     op[0] = '\0';
@@ -419,7 +515,9 @@ int readInstr() {
 
     sscanf( line, "%x %s %s %s %s\n", &addr, op, r1, r2, r3 );
 
-    bb = findBlock( addr );
+    // consecutive instructions mostly belong to the same block
+    if( !bb || testBlockRange( addr, bb ) != 0 )
+      bb = findBlock( addr );
     if( !bb ) {
       // could be that addr is from a procedure that is never called (thus not in CFG)
       fprintf( stderr, "Warning: Ignored out-of-range address [%x] %s %s %s %s\n", addr, op, r1, r2, r3 );
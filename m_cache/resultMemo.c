@@ -0,0 +1,243 @@
+// Include standard library headers
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// Include local library headers
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <debugmacros/debugmacros.h>
+
+// Include local headers
+#include "resultMemo.h"
+#include "header.h"
+
+
+// ############################################################
+// #### Local data type definitions (will not be exported) ####
+// ############################################################
+
+
+/* The memo is an open addressing hash table with linear probing. A key is
+ * only searched in the 'MEMO_PROBE_LENGTH' slots following its home slot.
+ * If none of them is free when a new result is stored, the table is doubled
+ * as long as it stays below the memory cap. Beyond that, the oldest result
+ * in the probed slots is replaced. Results are never removed otherwise, so
+ * a lookup can stop at the first free slot. */
+
+/* Number of slots which are searched for a key. */
+#define MEMO_PROBE_LENGTH 8U
+/* Initial and minimal number of slots. Must be a power of two. */
+#define MEMO_MIN_SLOTS 64U
+
+/* Header of each slot, followed by the key and the value. */
+typedef struct {
+  ull stamp; /* When the result was stored, 0 for a free slot. */
+} memo_slot;
+
+struct result_memo {
+  size_t key_size;
+  size_t value_size;
+  size_t slot_size;   /* Size of a slot including its header. */
+  size_t memory_cap;
+  size_t num_slots;   /* Always a power of two. */
+  size_t num_used;
+  char *slots;
+  memo_slot *entry;   /* A slot outside of the table to assemble new results. */
+  ull next_stamp;
+  result_memo_stats stats;
+};
+
+
+// #########################################
+// #### Definitions of static functions ####
+// #########################################
+
+
+/* FNV-1a hash of the key. */
+static size_t hashKey( const result_memo *memo, const void *key )
+{
+  const unsigned char *bytes = (const unsigned char *)key;
+  ull hash = 0xcbf29ce484222325ULL;
+  size_t i;
+  for ( i = 0; i < memo->key_size; i++ ) {
+    hash = ( hash ^ bytes[i] ) * 0x00000100000001b3ULL;
+  }
+  return (size_t)( hash ^ ( hash >> 32 ) );
+}
+
+
+static memo_slot *getSlot( const result_memo *memo, size_t index )
+{
+  return (memo_slot *)( memo->slots +
+      ( index & ( memo->num_slots - 1 ) ) * memo->slot_size );
+}
+
+
+static void *getSlotKey( memo_slot *slot )
+{
+  return (char *)slot + sizeof( memo_slot );
+}
+
+
+static void *getSlotValue( const result_memo *memo, memo_slot *slot )
+{
+  return (char *)slot + sizeof( memo_slot ) + memo->key_size;
+}
+
+
+static void allocSlots( result_memo *memo, size_t num_slots )
+{
+  memo->num_slots = num_slots;
+  memo->num_used = 0;
+  CALLOC( memo->slots, char*, num_slots, memo->slot_size, "memo->slots" );
+}
+
+
+/* Returns whether the table may be doubled without exceeding the cap. */
+static _Bool mayGrow( const result_memo *memo )
+{
+  return memo->num_slots * 2 * memo->slot_size <= memo->memory_cap;
+}
+
+
+/* Puts the slot 'entry' (header, key and value) into the table, replacing
+ * the slot of the same key or, if all probed slots hold other keys, the
+ * oldest of them. In the latter case, nothing is changed and 0 is returned
+ * instead if 'may_fail' is set. */
+static _Bool insertSlot( result_memo *memo, const memo_slot *entry,
+                         _Bool may_fail )
+{
+  const size_t home = hashKey( memo, getSlotKey( (memo_slot *)entry ) );
+  memo_slot *oldest = NULL;
+  uint i;
+
+  for ( i = 0; i < MEMO_PROBE_LENGTH; i++ ) {
+    memo_slot * const slot = getSlot( memo, home + i );
+    if ( slot->stamp == 0 ) {
+      memcpy( slot, entry, memo->slot_size );
+      memo->num_used++;
+      return 1;
+    }
+    if ( memcmp( getSlotKey( slot ), getSlotKey( (memo_slot *)entry ),
+                 memo->key_size ) == 0 ) {
+      memcpy( slot, entry, memo->slot_size );
+      return 1;
+    }
+    if ( oldest == NULL || slot->stamp < oldest->stamp ) {
+      oldest = slot;
+    }
+  }
+
+  if ( may_fail ) {
+    return 0;
+  }
+  memcpy( oldest, entry, memo->slot_size );
+  memo->stats.evictions++;
+  return 1;
+}
+
+
+/* Doubles the number of slots and reinserts all results. */
+static void growMemo( result_memo *memo )
+{
+  char * const old_slots = memo->slots;
+  const size_t old_num_slots = memo->num_slots;
+  size_t i;
+
+  allocSlots( memo, old_num_slots * 2 );
+  for ( i = 0; i < old_num_slots; i++ ) {
+    const memo_slot * const slot =
+      (const memo_slot *)( old_slots + i * memo->slot_size );
+    if ( slot->stamp != 0 ) {
+      insertSlot( memo, slot, 0 );
+    }
+  }
+  free( old_slots );
+}
+
+
+// #########################################
+// #### Definitions of public functions ####
+// #########################################
+
+
+result_memo *createResultMemo( size_t key_size, size_t value_size,
+                               size_t memory_cap )
+{
+  result_memo *memo;
+  CALLOC( memo, result_memo*, 1, sizeof( result_memo ), "memo" );
+
+  memo->key_size = key_size;
+  memo->value_size = value_size;
+  // Keep the headers of all slots aligned
+  const size_t align = sizeof( ull );
+  memo->slot_size = ( sizeof( memo_slot ) + key_size + value_size + align - 1 )
+                    / align * align;
+  memo->memory_cap = memory_cap;
+  memo->next_stamp = 1;
+  allocSlots( memo, MEMO_MIN_SLOTS );
+  MALLOC( memo->entry, memo_slot*, memo->slot_size, "memo->entry" );
+
+  return memo;
+}
+
+
+void freeResultMemo( result_memo *memo )
+{
+  if ( memo != NULL ) {
+    free( memo->slots );
+    free( memo->entry );
+    free( memo );
+  }
+}
+
+
+const void *lookupResultMemo( result_memo *memo, const void *key )
+{
+  const size_t home = hashKey( memo, key );
+  uint i;
+
+  for ( i = 0; i < MEMO_PROBE_LENGTH; i++ ) {
+    memo_slot * const slot = getSlot( memo, home + i );
+    if ( slot->stamp == 0 ) {
+      break;
+    }
+    if ( memcmp( getSlotKey( slot ), key, memo->key_size ) == 0 ) {
+      memo->stats.hits++;
+      return getSlotValue( memo, slot );
+    }
+  }
+
+  memo->stats.misses++;
+  return NULL;
+}
+
+
+void storeResultMemo( result_memo *memo, const void *key, const void *value )
+{
+  memo_slot * const entry = memo->entry;
+  memset( entry, 0, memo->slot_size );
+  entry->stamp = memo->next_stamp++;
+  memcpy( getSlotKey( entry ), key, memo->key_size );
+  memcpy( getSlotValue( memo, entry ), value, memo->value_size );
+
+  /* Keep the table at most half full while it may grow. */
+  if ( memo->num_used * 2 >= memo->num_slots && mayGrow( memo ) ) {
+    growMemo( memo );
+  }
+  while ( !insertSlot( memo, entry, mayGrow( memo ) ) ) {
+    growMemo( memo );
+  }
+  memo->stats.stores++;
+}
+
+
+result_memo_stats getResultMemoStats( const result_memo *memo )
+{
+  return memo->stats;
+}
@@ -0,0 +1,56 @@
+/*! This is a header file of the Chronos timing analyzer. */
+
+/*
+ * A hash table which memoizes analysis results of a fixed size under keys
+ * of a fixed size, with a bound on its memory usage. When the bound is
+ * reached, old results are evicted to make room for new ones, so a lookup
+ * may miss a result which was stored before.
+ */
+
+#ifndef __CHRONOS_RESULT_MEMO_H
+#define __CHRONOS_RESULT_MEMO_H
+
+#include <stddef.h>
+
+#include "header.h"
+
+// ######### Datatype declarations  ###########
+
+
+typedef struct result_memo result_memo;
+
+/* Counters of the memo operations. */
+typedef struct {
+  ull hits;      /* Lookups which found a result. */
+  ull misses;    /* Lookups which found no result. */
+  ull stores;    /* Results which were stored. */
+  ull evictions; /* Results which were dropped to make room for others. */
+} result_memo_stats;
+
+
+// ######### Function declarations  ###########
+
+
+/* Creates an empty memo for results of 'value_size' bytes under keys of
+ * 'key_size' bytes, which uses at most about 'memory_cap' bytes for its
+ * entries. Keys are compared bytewise, so they must not contain
+ * uninitialized padding. */
+result_memo *createResultMemo( size_t key_size, size_t value_size,
+                               size_t memory_cap );
+
+/* Frees the memo and all results in it. */
+void freeResultMemo( result_memo *memo );
+
+/* Returns the result stored under 'key' or NULL if there is none. The
+ * result is only valid until the next call to storeResultMemo. */
+const void *lookupResultMemo( result_memo *memo, const void *key );
+
+/* Stores 'value' under 'key', replacing a result which may already be
+ * stored under 'key'. */
+void storeResultMemo( result_memo *memo, const void *key, const void *value );
+
+/* Returns the counters of the memo operations since its creation. */
+result_memo_stats getResultMemoStats( const result_memo *memo );
+
+
+#endif
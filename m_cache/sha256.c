@@ -0,0 +1,139 @@
+// Include standard library headers
+#include <stdint.h>
+#include <string.h>
+
+
+// Include local library headers
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+// Include local headers
+#include "sha256.h"
+
+
+// ############################################################
+// #### Local data type definitions (will not be exported) ####
+// ############################################################
+
+
+#define SHA256_BLOCK_SIZE 64
+
+#define ROTR( x, n ) ( ( ( x ) >> ( n ) ) | ( ( x ) << ( 32 - ( n ) ) ) )
+
+/* The first 32 bits of the fractional parts of the cube roots of the first
+ * 64 primes. */
+static const uint32_t round_constants[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+  0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+  0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+  0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+  0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+  0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+
+// #########################################
+// #### Definitions of static functions ####
+// #########################################
+
+
+/* Applies the compression function to 'state' for the 64 bytes at 'block'. */
+static void compressBlock( uint32_t state[8], const unsigned char *block )
+{
+  uint32_t w[64];
+  unsigned int i;
+  for ( i = 0; i < 16; i++ ) {
+    w[i] = ( (uint32_t)block[4 * i] << 24 ) |
+           ( (uint32_t)block[4 * i + 1] << 16 ) |
+           ( (uint32_t)block[4 * i + 2] << 8 ) |
+           (uint32_t)block[4 * i + 3];
+  }
+  for ( i = 16; i < 64; i++ ) {
+    const uint32_t s0 = ROTR( w[i - 15], 7 ) ^ ROTR( w[i - 15], 18 ) ^
+                        ( w[i - 15] >> 3 );
+    const uint32_t s1 = ROTR( w[i - 2], 17 ) ^ ROTR( w[i - 2], 19 ) ^
+                        ( w[i - 2] >> 10 );
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+  uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+  for ( i = 0; i < 64; i++ ) {
+    const uint32_t s1 = ROTR( e, 6 ) ^ ROTR( e, 11 ) ^ ROTR( e, 25 );
+    const uint32_t ch = ( e & f ) ^ ( ~e & g );
+    const uint32_t t1 = h + s1 + ch + round_constants[i] + w[i];
+    const uint32_t s0 = ROTR( a, 2 ) ^ ROTR( a, 13 ) ^ ROTR( a, 22 );
+    const uint32_t maj = ( a & b ) ^ ( a & c ) ^ ( b & c );
+    const uint32_t t2 = s0 + maj;
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+
+// #########################################
+// #### Definitions of public functions ####
+// #########################################
+
+
+void computeSHA256( const void *data, size_t size,
+                    unsigned char digest[SHA256_DIGEST_SIZE] )
+{
+  uint32_t state[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+  };
+  const unsigned char *bytes = (const unsigned char *)data;
+  size_t remaining = size;
+
+  for ( ; remaining >= SHA256_BLOCK_SIZE; remaining -= SHA256_BLOCK_SIZE ) {
+    compressBlock( state, bytes );
+    bytes += SHA256_BLOCK_SIZE;
+  }
+
+  /* Pad the rest with a one bit, zeros and the length in bits, which may
+   * take one or two blocks. */
+  unsigned char last[2 * SHA256_BLOCK_SIZE];
+  memset( last, 0, sizeof( last ) );
+  memcpy( last, bytes, remaining );
+  last[remaining] = 0x80;
+  const size_t last_size = ( remaining + 9 <= SHA256_BLOCK_SIZE
+                             ? SHA256_BLOCK_SIZE : 2 * SHA256_BLOCK_SIZE );
+  const unsigned long long bits = (unsigned long long)size * 8;
+  unsigned int i;
+  for ( i = 0; i < 8; i++ ) {
+    last[last_size - 1 - i] = ( bits >> ( 8 * i ) ) & 0xFF;
+  }
+  compressBlock( state, last );
+  if ( last_size > SHA256_BLOCK_SIZE ) {
+    compressBlock( state, last + SHA256_BLOCK_SIZE );
+  }
+
+  for ( i = 0; i < 8; i++ ) {
+    digest[4 * i] = state[i] >> 24;
+    digest[4 * i + 1] = ( state[i] >> 16 ) & 0xFF;
+    digest[4 * i + 2] = ( state[i] >> 8 ) & 0xFF;
+    digest[4 * i + 3] = state[i] & 0xFF;
+  }
+}
@@ -0,0 +1,29 @@
+/*! This is a header file of the Chronos timing analyzer. */
+
+/*
+ * The SHA-256 hash function (FIPS 180-4), used to address results by their
+ * contents where a collision of a non-cryptographic hash could make a
+ * result be reused for different inputs.
+ */
+
+#ifndef __CHRONOS_SHA256_H
+#define __CHRONOS_SHA256_H
+
+#include <stddef.h>
+
+// ######### Macros #########
+
+
+/* Number of bytes of a digest. */
+#define SHA256_DIGEST_SIZE 32
+
+
+// ######### Function declarations  ###########
+
+
+/* Writes the SHA-256 digest of the 'size' bytes at 'data' to 'digest'. */
+void computeSHA256( const void *data, size_t size,
+                    unsigned char digest[SHA256_DIGEST_SIZE] );
+
+
+#endif
@@ -315,6 +315,47 @@ int topo_sort_proc( procedure *p ) {
 }
 
 
+/*
+ * Records the position of each block in the 'topo' lists (see
+ * block:topo_index) and whether it is a loop exit, so that the analyses need
+ * not search for them.
+ */
+static void index_blocks( procedure *p ) {
+
+  int i, j;
+  block *bb;
+  loop  *lp;
+
+  for( i = 0; i < p->num_bb; i++ ) {
+    bb = p->bblist[i];
+    bb->topo_index[0] = bb->topo_index[1] = -1;
+    bb->loop_exit_type = LOOP_EXIT_NONE;
+  }
+
+  // the list of a loop contains the heads of its nested loops
+  for( i = 0; i < p->num_topo; i++ ) {
+    bb = p->bblist[ p->topo[i]->bbid ];
+    bb->topo_index[ bb->topo_index[0] != -1 ] = i;
+  }
+  for( j = 0; j < p->num_loops; j++ ) {
+    lp = p->loops[j];
+    for( i = 0; i < lp->num_topo; i++ ) {
+      bb = p->bblist[ lp->topo[i]->bbid ];
+      bb->topo_index[ bb->topo_index[0] != -1 ] = i;
+    }
+  }
+
+  // the first loop which a block exits determines its type
+  for( j = p->num_loops - 1; j >= 0; j-- ) {
+    lp = p->loops[j];
+    for( i = 0; i < lp->num_exits; i++ )
+      p->bblist[ lp->exits[i]->bbid ]->loop_exit_type = LOOP_EXIT_SECONDARY;
+    if( lp->loopexit )
+      p->bblist[ lp->loopexit->bbid ]->loop_exit_type = LOOP_EXIT_MAIN;
+  }
+}
+
+
 /*
  * Determines topological ordering for procedures and loops.
  */
@@ -332,6 +373,8 @@ int topo_sort() {
 
     // procedure
     topo_sort_proc( p );
+
+    index_blocks( p );
   }
 
   return 0;
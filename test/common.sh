@@ -0,0 +1,52 @@
+#!/bin/bash
+
+# Common setup of the regression tests, which is sourced by each of them.
+#
+# "make check" passes the analyzer in OPT and the directory of the test tasks
+# in TEST_INPUTS. The tests run in a temporary directory, which contains the
+# MSC of the test tasks ("ip"), their cache configurations ("l1", "l2") and
+# TDMA schedules ("tdma*"). A test exits with 0 on success, 1 on failure and
+# 77 if it had to be skipped.
+
+declare -r TEST_DIR=$(cd "$(dirname "$0")" && pwd)
+declare -r OPT=${OPT:-$TEST_DIR/../m_cache/opt}
+declare -r TEST_INPUTS=${TEST_INPUTS:-$TEST_DIR/inputs}
+
+if [ ! -x "$OPT" ]; then
+  echo "The analyzer $OPT was not built" >&2
+  exit 1
+fi
+
+declare -r WORK_DIR=$(mktemp -d)
+trap "rm -rf $WORK_DIR" EXIT
+cp "$TEST_INPUTS"/l1 "$TEST_INPUTS"/l2 "$TEST_INPUTS"/tdma* "$WORK_DIR"
+sed "s|@TEST_INPUTS@|$TEST_INPUTS|" "$TEST_INPUTS"/msc1.in > "$WORK_DIR"/msc1
+echo "$WORK_DIR/msc1" > "$WORK_DIR"/ip
+cd "$WORK_DIR"
+
+
+# Runs the analyzer with the given arguments and prints the BCET and WCET
+# of all tasks for each of its methods, without the analysis times. Fails
+# the test if the analyzer fails, so it must be called as
+# "RESULTS=$(analyze ...) || exit 1".
+analyze() {
+  local output
+  output=$("$OPT" "$@" 2>&1)
+  if (( $? != 0 )) || ! grep -aq "Results for task" <<< "$output"; then
+    echo "$output" | tail -20 >&2
+    echo "FAIL: $OPT $*" >&2
+    exit 1
+  fi
+  grep -a "Results for task" <<< "$output" | \
+    sed "s/(time [0-9.]*s)//g; s/^ *//"
+}
+
+# Fails the test with the message $1 if the results $2 and $3 differ.
+expect_same() {
+  if [ "$2" != "$3" ]; then
+    diff <(echo "$2") <(echo "$3") >&2
+    echo "FAIL: $1" >&2
+    exit 1
+  fi
+  echo "PASS: $1"
+}
@@ -0,0 +1,38 @@
+#!/bin/bash
+
+# The offset sets and the interval lists must give the same results when
+# the loops are analyzed with the offsets at their heads or with max-plus
+# matrices, which both bound the latencies over all offsets of a domain
+# exactly. The graph-tracking analysis merges the intervals of a list
+# beyond its maximum length, so there the sets must only be at least as
+# precise.
+
+. "$(dirname "$0")/common.sh"
+
+for method in ac am; do
+  for suffix in "" "+"; do
+    SETS=$(analyze ip l1 l2 2 tdma ${method}s$suffix) || exit 1
+    INTERVALS=$(analyze ip l1 l2 2 tdma ${method}i$suffix) || exit 1
+    expect_same "${method}s$suffix gives the results of ${method}i$suffix" \
+      "$SETS" "$INTERVALS"
+  done
+done
+
+for suffix in "" "+"; do
+  SETS=$(analyze ip l1 l2 2 tdma ags$suffix) || exit 1
+  INTERVALS=$(analyze ip l1 l2 2 tdma agi$suffix) || exit 1
+  # Compare the BCET and WCET of each task
+  if ! paste <(echo "$SETS") <(echo "$INTERVALS") | awk '
+      { n = split( $0, w, /[ \t]+/ )
+        for ( i = 1; i <= n; i++ ) {
+          if ( w[i] == "BCET" ) { b[++nb] = w[i + 1] }
+          if ( w[i] == "WCET" ) { c[++nc] = w[i + 1] }
+        }
+        if ( nb != 2 || nc != 2 || b[1] < b[2] || c[1] > c[2] ) { exit 1 }
+        nb = 0; nc = 0 }'; then
+    diff <(echo "$SETS") <(echo "$INTERVALS") >&2
+    echo "FAIL: ags$suffix is less precise than agi$suffix" >&2
+    exit 1
+  fi
+  echo "PASS: ags$suffix is at least as precise as agi$suffix"
+done
@@ -0,0 +1,21 @@
+#!/bin/bash
+
+# The memoized results must not change the results of the analyses: With no
+# result memory ("-m 0"), the memos keep evicting results, and a second run
+# with a result store ("-c") reuses the stored cache analysis results and
+# flow problem solutions of the first one. The max-plus methods with the set
+# and interval offsets are left out, they take too long without memos.
+
+. "$(dirname "$0")/common.sh"
+
+declare -r METHODS=u,acr,acr+,acs,acs+,aci,aci+,agr,agr+,ags,ags+,agi,agi+,agt,amr,amr+,amt
+
+DEFAULT=$(analyze ip l1 l2 2 tdma $METHODS) || exit 1
+EVICTING=$(analyze -m 0 ip l1 l2 2 tdma $METHODS) || exit 1
+expect_same "evicting memos give the same results" "$DEFAULT" "$EVICTING"
+
+for run in first second; do
+  STORED=$(analyze -c store ip l1 l2 2 tdma $METHODS) || exit 1
+  expect_same "the $run run with a result store gives the same results" \
+    "$DEFAULT" "$STORED"
+done
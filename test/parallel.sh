@@ -0,0 +1,24 @@
+#!/bin/bash
+
+# Running several methods in one process, splitting the cache analysis over
+# worker processes ("-j") and running the front ends of the tasks in threads
+# ("-t"), which can not be combined, must each give the results of running
+# each method on its own.
+
+. "$(dirname "$0")/common.sh"
+
+declare -r METHODS="n s u acr acr+ acs acs+ aci aci+ agr agr+ ags ags+ agi agi+
+                    agt amr amr+ ams ams+ ami ami+ amt"
+
+SERIAL=""
+for method in $METHODS; do
+  RESULTS=$(analyze ip l1 l2 2 tdma $method) || exit 1
+  SERIAL="$SERIAL$RESULTS"$'\n'
+done
+SERIAL=${SERIAL%$'\n'}
+
+for options in "" "-j 3" "-t 3"; do
+  RESULTS=$(analyze $options ip l1 l2 2 tdma all+) || exit 1
+  expect_same "all+ ${options:+with $options }gives the results of single methods" \
+    "$SERIAL" "$RESULTS"
+done
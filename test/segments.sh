@@ -0,0 +1,11 @@
+#!/bin/bash
+
+# A segmented TDMA schedule whose segments are all the same as the plain
+# schedule must give the same results with every method.
+
+. "$(dirname "$0")/common.sh"
+
+PLAIN=$(analyze ip l1 l2 2 tdma all+) || exit 1
+SAME=$(analyze ip l1 l2 2 tdma_same all+) || exit 1
+expect_same "identical segments give the results of the plain schedule" \
+  "$PLAIN" "$SAME"
@@ -0,0 +1,31 @@
+#!/bin/bash
+
+# The graph-tracking analyses must give the same results with the built-in
+# flow solver as with the external ILP solvers. Solvers which are not
+# installed are skipped: CPLEX is looked up in the PATH, lp_solve in the
+# directory which the analyzer was configured with.
+
+. "$(dirname "$0")/common.sh"
+
+declare -r METHODS=agr,agr+,ags,ags+,agi,agi+,agt
+declare -r LP_SOLVE_DIR=$(sed -n 's/^#define LP_SOLVE_PATH "\(.*\)"$/\1/p' \
+  "$(dirname "$OPT")/../config.h" 2> /dev/null)
+
+SOLVERS=""
+if command -v cplex > /dev/null; then
+  SOLVERS="$SOLVERS cplex"
+fi
+if [ -x "$LP_SOLVE_DIR/lp_solve" ]; then
+  SOLVERS="$SOLVERS lp_solve"
+fi
+if [ -z "$SOLVERS" ]; then
+  echo "SKIP: Neither cplex nor lp_solve is installed"
+  exit 77
+fi
+
+BUILTIN=$(analyze -s builtin ip l1 l2 2 tdma $METHODS) || exit 1
+for solver in $SOLVERS; do
+  RESULTS=$(analyze -s $solver ip l1 l2 2 tdma $METHODS) || exit 1
+  expect_same "$solver gives the results of the built-in solver" \
+    "$BUILTIN" "$RESULTS"
+done